@@ -21,13 +21,37 @@
 ;-----------------------------------------------------------------------------*/
 
 #include <iostream>
+#include <cstdio>
 #include <cstdlib>
 #include <cassert>
+#include <cmath>
 
 #include "Application.hpp"
 #include "SettingsDlg.hpp"
+#include "Timer.hpp"
+#include "Profiler.hpp"
+#include "Trace.hpp"
 
-static const char * DB_FILENAME = "exhibits/mdc.db";
+using std::cout;
+using std::cerr;
+using std::endl;
+
+#define PROGRESS_BAR_HEIGHT 16
+#define PROGRESS_BAR_MARGIN  32
+
+// Camera movement below this is not worth a new pick.
+#define PICK_EPSILON         0.001f
+
+// Camera path keys recorded per second.
+#define RECORD_RATE          60
+
+// Profiler overlay layout, the graph is full height at 2 * PROFILER_BUDGET.
+#define PROFILER_MARGIN      8
+#define PROFILER_WIDTH       ( PROFILER_HISTORY * 2 )
+#define PROFILER_GRAPH       64
+#define PROFILER_LINE        14
+#define PROFILER_STAT_LINES  4
+#define PROFILER_BUDGET      16.7f
 
 /*------------------------------------------------------------------------------
 ; Application::Application()
@@ -35,10 +59,16 @@ static const char * DB_FILENAME = "exhibits/mdc.db";
 ; Application constructor. Creates a new application, setting up some default
 ; parameters for the irrLicht Engine.
 ;-----------------------------------------------------------------------------*/
-mdcApplication::mdcApplication(){
-	int w, h;
+mdcApplication::mdcApplication( video::E_DRIVER_TYPE driverType ){
+	int          w, h;
+	const char * loadingImage = NULL;
+
+	TRACE_SCOPE( "mdcApplication::mdcApplication" );
 
-	settings = mdcSettingsMdl::getInstance();
+	{
+		TRACE_SCOPE( "mdcSettingsMdl::getInstance" );
+		settings = mdcSettingsMdl::getInstance();
+	}
 
 	SIrrlichtCreationParameters params = SIrrlichtCreationParameters();
 
@@ -48,9 +78,19 @@ mdcApplication::mdcApplication(){
 	params.Fullscreen = settings->isFullScreen();
 	params.Vsync      = settings->isVSyncEnabled();
 
+	// Benchmarks pick their own driver and never take over the screen.
+	if ( driverType != video::EDT_COUNT ) {
+		params.DriverType = driverType;
+		params.Fullscreen = false;
+		params.Vsync      = false;
+	}
+
 	params.EventReceiver = this;
 
-	device = createDeviceEx(params);
+	{
+		TRACE_SCOPE( "createDeviceEx" );
+		device = createDeviceEx(params);
+	}
 
 	if( device == NULL ) return;
 
@@ -68,21 +108,26 @@ mdcApplication::mdcApplication(){
 	h = settings->getScreenHeight();
 	loadingScreen = guienv->addImage( core::rect<s32>( 0, 0, w, h ), NULL, 0xABCD );
 	if ( w == 640 && h == 480 ) {
-		loadingScreen->setImage( driver->getTexture( "gfx/loading640x480.png" ) );
+		loadingImage = "gfx/loading640x480.png";
 	} else if( w == 800 && h == 600 ) {
-		loadingScreen->setImage( driver->getTexture( "gfx/loading800x600.png" ) );
+		loadingImage = "gfx/loading800x600.png";
 	} else if( w == 1024 && h == 768 ) {
-		loadingScreen->setImage( driver->getTexture( "gfx/loading1024x768.png" ) );
+		loadingImage = "gfx/loading1024x768.png";
 	} else if( w == 1280 && h == 800 ) {
-		loadingScreen->setImage( driver->getTexture( "gfx/loading1280x800.png" ) );
+		loadingImage = "gfx/loading1280x800.png";
 	} else if( w == 1280 && h == 1024 ) {
-		loadingScreen->setImage( driver->getTexture( "gfx/loading1280x1024.png" ) );
+		loadingImage = "gfx/loading1280x1024.png";
 	} else {
 		// The screen resolution is unrecognized.
 		device->closeDevice();
 		assert( 0 );
 	}
 
+	if ( loadingImage != NULL ) {
+		TRACE_SCOPE_ARG( "getTexture", loadingImage );
+		loadingScreen->setImage( driver->getTexture( loadingImage ) );
+	}
+
 	// Set up the gui font and create the dialog listeners.
 	gui::IGUISkin* skin = guienv->getSkin();
 	gui::IGUIFont* font = guienv->getFont("font/fontcourier.bmp");
@@ -93,11 +138,22 @@ mdcApplication::mdcApplication(){
 
 	// Set scene to NULL so that it will be loaded after the first render.
 	scene = NULL;
+	loader = NULL;
+	camera = NULL;
+	recorder = NULL;
+	renderStats = new mdcRenderStats();
+	headless = false;
+	profilerVisible = false;
+	exhibits = NULL;
 	exDlg = NULL;
 
 	lastFPS = -1;
 	nodeSelected = false;
 	selectedNodeId = 0;
+
+	pickInterval = settings->getPickRate() > 0 ? 1000 / settings->getPickRate() : 0;
+	lastPickTime = 0;
+	pickDirty = true;
 }
 
 /*------------------------------------------------------------------------------
@@ -111,160 +167,453 @@ mdcApplication::~mdcApplication(){
 
 	if ( settings->settingsChanged() ) settings->saveSettings();
 
+	// Stop the database thread before releasing the exhibits model.
+	delete loader;
+
+	// Writes the last recorded keys.
+	delete recorder;
+	delete renderStats;
+
 	mdcSettingsMdl::freeInstance();
-	mdcExhibitMdl::freeInstance();
+	if ( exhibits != NULL )
+		mdcExhibitMdl::freeInstance();
 	delete settingsCtrl;
 	delete scene;
 }
 
+/*------------------------------------------------------------------------------
+; Application::loadScene()
+;
+; Reads the scene file and starts the incremental loader. The render loop
+; calls the loader every frame until onSceneLoaded().
+;-----------------------------------------------------------------------------*/
 void mdcApplication::loadScene(){
-	int                       nEx;
-	vec3_t                    r, s, t;
-	float                     ra;
-	core::stringc             path;
-	int                  *    ids;
-	char                 *    modelPath;
-	scene::IAnimatedMesh *    mesh;
-	scene::ISceneNode    *    node;
+	TRACE_SCOPE( "mdcApplication::loadScene" );
+
+	scene  = new mdcScene( device );
+	loader = new mdcSceneLoader( device, scene );
+}
 
+void mdcApplication::onSceneLoaded(){
 	const SKeyMap        *    f  = settings->getForwardKey();
 	const SKeyMap        *    b  = settings->getBackwardKey();
 	const SKeyMap        *    sl = settings->getStrafeLeftKey();
 	const SKeyMap        *    sr = settings->getStrafeRightKey();
 
-	scene = new mdcScene( device );
+	// Take a reference to the exhibits model before the loader drops its own.
+	exhibits = mdcExhibitMdl::getInstance();
+
+	delete loader;
+	loader = NULL;
 
 	scene->changeCameraKeyMaps( *f, *b, *sl, *sr );
 
-	exhibits = mdcExhibitMdl::getInstance();
+	// The picking index is complete now.
+	pickDirty = true;
+
+	loadingScreen->remove();
+}
+
+void mdcApplication::drawProgressBar(){
+	int w = settings->getScreenWidth();
+	int h = settings->getScreenHeight();
+	int x0 = PROGRESS_BAR_MARGIN;
+	int x1 = w - PROGRESS_BAR_MARGIN;
+	int y1 = h - PROGRESS_BAR_MARGIN;
+	int y0 = y1 - PROGRESS_BAR_HEIGHT;
+	int fill = x0 + ( s32 )( ( x1 - x0 ) * loader->getProgress() );
+
+	driver->draw2DRectangle( video::SColor( 255, 32, 32, 32 ), core::rect<s32>( x0 - 2, y0 - 2, x1 + 2, y1 + 2 ) );
+	driver->draw2DRectangle( video::SColor( 255, 97, 220, 220 ), core::rect<s32>( x0, y0, fill, y1 ) );
+}
 
-	if ( !exhibits->setDatabaseFile( DB_FILENAME ) ) {
-		std::cerr << "The exhibits database could not be opened." << std::endl;
+/*------------------------------------------------------------------------------
+; Application::run()
+;
+; Main loop of the application. It renders the demo scene and calculates the
+; fps count.
+;-----------------------------------------------------------------------------*/
+void mdcApplication::run(){
+	// Render everything until the user requests the application to close itself.
+	if( device != NULL ){
+		loadScene();
+
+		while( pollDevice() ) {
+			runFrame();
+		}
 	}
+}
 
-	device->getFileSystem()->addFileArchive( "exhibits/exhibits.zip" );
+/*------------------------------------------------------------------------------
+; Application::runBenchmark()
+;
+; Loads the scene, then replays the camera path in the given file one key per
+; frame and writes the time and render counters of every frame, followed by
+; the min, median, p95 and p99 times, to the given CSV file. The full frame
+; is run, picking included, but picks are only gated by camera motion so runs
+; can be compared.
+;-----------------------------------------------------------------------------*/
+bool mdcApplication::runBenchmark( const char * pathFile, const char * outFile ){
+	core::array< cameraKey_t >         path;
+	core::array< f32 >                 times;
+	core::array< f32 >                 sorted;
+	core::array< renderStats_t >       stats;
+	mdcTimer                           timer;
+	FILE                    *          out;
+
+	if ( device == NULL ) {
+		return false;
+	}
 
-	nEx = exhibits->getNumOfExhibits();
-	ids = ( int * )malloc( sizeof( int ) * nEx );
-	exhibits->getFirstNExhibitIds( ids, nEx );
+	if ( !readCameraPath( pathFile, path ) ) {
+		cerr << "mdcApplication::runBenchmark() - Could not read the camera path " << pathFile << endl;
+		return false;
+	}
 
-	for ( int i = 0; i < nEx; i++ ) {
+	headless     = true;
+	pickInterval = 0;
 
-		exhibits->getRotationById( r, ids[ i ] );
-		exhibits->getTranslationById( t, ids[ i ] );
-		exhibits->getScalingById( s, ids[ i ] );
-		ra = exhibits->getRotationAmountById( ids [ i ] );
+	loadScene();
+	while ( loader != NULL && pollDevice() ) {
+		runFrame();
+	}
 
-		exhibits->getExhibitModelPathById( &modelPath, ids[ i ] );
+	if ( camera == NULL ) {
+		cerr << "mdcApplication::runBenchmark() - The scene did not finish loading." << endl;
+		return false;
+	}
 
-		if ( modelPath != NULL ) {
-			path = "exhibits/";
-			path += modelPath;
+	// The path drives the camera, not the keyboard or the mouse.
+	camera->setInputReceiverEnabled( false );
 
-			mesh = smgr->getMesh( path.c_str() );
-			node = smgr->addOctreeSceneNode( mesh->getMesh( 0 ), NULL, ids[ i ], 1024 );
-			if ( node != NULL ) {
-				node->setMaterialFlag( video::EMF_LIGHTING, false );
-				node->setMaterialFlag( video::EMF_NORMALIZE_NORMALS, true );
-				node->setMaterialType( video::EMT_SOLID );
+	times.reallocate( path.size() );
+	stats.reallocate( path.size() );
+	for ( u32 i = 0; i < path.size() && pollDevice(); i++ ) {
+		camera->setPosition( path[ i ].position );
+		camera->setTarget( path[ i ].target );
 
-				r.x = 0;
-				r.y = r.y * ra;
-				r.z = 0;
+		timer.start();
+		runFrame();
+		times.push_back( timer.getElapsedMs() );
+		stats.push_back( renderStats->getStats() );
+	}
 
-				node->setRotation( core::vector3df( r.x, r.y, r.z ) );
-				node->setScale( core::vector3df( s.x, s.y, s.z ) );
-				node->setPosition( core::vector3df( t.x, t.y, t.z ) );
+	out = fopen( outFile, "w" );
+	if ( out == NULL ) {
+		cerr << "mdcApplication::runBenchmark() - Could not write " << outFile << endl;
+		return false;
+	}
 
-				scene->addMeshToCollisionDetection( mesh, node );
-			}
-		}
+	fprintf( out, "frame,ms,nodes_drawn,nodes_culled,instances_drawn,instances_culled,primitives,materials,textures,"
+	              "texture_kib\n" );
+	for ( u32 i = 0; i < times.size(); i++ ) {
+		fprintf( out, "%u,%.3f,%u,%u,%u,%u,%u,%u,%u,%u\n", i, times[ i ], stats[ i ].nodesDrawn, stats[ i ].nodesCulled,
+		         stats[ i ].instancesDrawn, stats[ i ].instancesCulled, stats[ i ].primitives, stats[ i ].materials,
+		         stats[ i ].textures, stats[ i ].textureMemory );
+	}
 
-		free( modelPath );
+	if ( !times.empty() ) {
+		sorted = times;
+		sorted.sort();
+
+		fprintf( out, "min,%.3f\n", sorted[ 0 ] );
+		fprintf( out, "median,%.3f\n", getPercentile( sorted, 0.5f ) );
+		fprintf( out, "p95,%.3f\n", getPercentile( sorted, 0.95f ) );
+		fprintf( out, "p99,%.3f\n", getPercentile( sorted, 0.99f ) );
+
+		cout << times.size() << " frames: min " << sorted[ 0 ] << " ms, median " << getPercentile( sorted, 0.5f )
+		     << " ms, p95 " << getPercentile( sorted, 0.95f ) << " ms, p99 " << getPercentile( sorted, 0.99f )
+		     << " ms." << endl;
 	}
 
-	free( ids );
+	fclose( out );
 
-	collMan = smgr->getSceneCollisionManager();
+	return true;
 }
 
 /*------------------------------------------------------------------------------
-; Application::run()
+; Application::startRecording()
 ;
-; Main loop of the application. It renders the demo scene and calculates the
-; fps count.
+; Records the camera path to the given file from the end of loading until
+; the application closes, in the format runBenchmark() reads.
 ;-----------------------------------------------------------------------------*/
-void mdcApplication::run(){
+bool mdcApplication::startRecording( const char * file ){
+	delete recorder;
+
+	recorder = new mdcCameraRecorder();
+	if ( !recorder->open( file, RECORD_RATE ) ) {
+		delete recorder;
+		recorder = NULL;
+		return false;
+	}
+
+	return true;
+}
+
+/*------------------------------------------------------------------------------
+; Application::runFrame()
+;
+; One pass of the main loop: advances the loader, renders, updates the
+; exhibit under the crosshair and records the camera. A headless application
+; renders even without an active window.
+;-----------------------------------------------------------------------------*/
+void mdcApplication::runFrame(){
 	int                                fps;
 	core::stringw                      str;
-	core::line3d<f32>                  ray;
-	scene::ICameraSceneNode *          camera;
-	scene::ISceneNode       *          selectedSceneNode;
-	core::vector3df                    intersection;
-    core::triangle3df                  hitTriangle;
-	
-	camera = NULL;
 
-	// Render everything until the user requests the application to close itself.
-	if( device != NULL ){
-		if( device->isWindowActive() && scene == NULL){
-			driver->beginScene( true, true, video::SColor( 255, 97, 220, 220 ) );
-			guienv->drawAll();
-			driver->endScene();
-			loadScene();
-			loadingScreen->remove();
+	TRACE_SCOPE( "frame" );
+
+	if ( loader != NULL ) {
+		PROFILE_ZONE( ZONE_LOADER );
+		TRACE_SCOPE( "mdcSceneLoader::update" );
+
+		// Keep loading even if the window is not active.
+		if ( loader->update() ) {
+			onSceneLoaded();
 			camera = scene->getCamera();
 		}
+	}
 
-		while( device->run() ) {
-			if( device->isWindowActive() ) {
-				driver->beginScene( true, true, video::SColor( 255, 97, 220, 220 ) );
+	if( headless || device->isWindowActive() ) {
+		driver->beginScene( true, true, video::SColor( 255, 97, 220, 220 ) );
+		if ( loader != NULL ) {
+			PROFILE_ZONE( ZONE_DRAW_GUI );
+			guienv->drawAll();
+			drawProgressBar();
+		} else {
+			{
+				PROFILE_ZONE( ZONE_DRAW_SCENE );
+				if ( camera != NULL ) {
+					scene->updateVisibility( camera );
+				}
 				smgr->drawAll();
+			}
+			{
+				PROFILE_ZONE( ZONE_DRAW_GUI );
 				guienv->drawAll();
-				driver->endScene();
+			}
+		}
 
-				fps = driver->getFPS();
+		if ( profilerVisible ) {
+			drawProfiler();
+		}
 
-				if( !settings->isFullScreen() && lastFPS != fps ) {
-					str = L"Museo de Ciencias :: [";
-					str += driver->getName();
-					str += "] FPS:";
-					str += fps;
-					device->setWindowCaption( str.c_str() );
-					lastFPS = fps;
-				}
+		{
+			PROFILE_ZONE( ZONE_END_SCENE );
+			driver->endScene();
+		}
 
-				if ( scene == NULL ) {
-					loadScene();
-					loadingScreen->remove();
-					camera = scene->getCamera();
-				} else if ( camera != NULL ) {
-					ray.start = camera->getPosition();
-        			ray.end = ray.start + ( camera->getTarget() - ray.start ).normalize() * 300.0f;
-
-        			selectedSceneNode = collMan->getSceneNodeAndCollisionPointFromRay(
-																						ray,
-																						intersection,
-																						hitTriangle,
-																						0,
-																						0
-																					 );
-
-        			if ( selectedSceneNode != NULL && !dlgVisible ) {
-						selectedNodeId = selectedSceneNode->getID();
-						device->getCursorControl()->setActiveIcon( gui::ECI_HAND );
-						device->getCursorControl()->setVisible( true );
-
-        			} else {
-        				if ( !dlgVisible ) {
-							selectedNodeId = 0;
-							device->getCursorControl()->setVisible( false );
-        				}
-        			}
-				}
-			} else device->yield();
+		// Only the overlay and the benchmark show the counters.
+		if ( loader == NULL && scene != NULL && ( profilerVisible || headless ) ) {
+			renderStats->collect( smgr, driver, scene->getHiddenNodeCount() );
+		}
+
+		fps = driver->getFPS();
+
+		if( !headless && !settings->isFullScreen() && lastFPS != fps ) {
+			str = L"Museo de Ciencias :: [";
+			str += driver->getName();
+			str += "] FPS:";
+			str += fps;
+			device->setWindowCaption( str.c_str() );
+			lastFPS = fps;
+		}
+
+		if ( camera != NULL ) {
+			PROFILE_ZONE( ZONE_PICK );
+			updatePick();
+		}
+	} else if ( loader == NULL ) {
+		device->yield();
+	}
+
+	if ( recorder != NULL && camera != NULL ) {
+		recorder->update( device->getTimer()->getRealTime(), camera->getPosition(), camera->getTarget() );
+	}
+
+	mdcProfiler::endFrame();
+}
+
+bool mdcApplication::pollDevice(){
+	PROFILE_ZONE( ZONE_DEVICE_RUN );
+	return device->run();
+}
+
+/*------------------------------------------------------------------------------
+; Application::drawProfiler()
+;
+; Draws the frame time graph of the last PROFILER_HISTORY frames, with a line
+; at the 60 fps budget, the average and worst time of every zone and the
+; render counters of the last frame. Drawn with the driver, so it also shows
+; in fullscreen.
+;-----------------------------------------------------------------------------*/
+void mdcApplication::drawProfiler(){
+	gui::IGUIFont      *   font   = guienv->getSkin()->getFont();
+	s32                    x0     = PROFILER_MARGIN;
+	s32                    y0     = PROFILER_MARGIN;
+	s32                    base   = y0 + PROFILER_GRAPH;
+	s32                    height = PROFILER_GRAPH + PROFILER_LINE * ( NUM_ZONES + 1 + PROFILER_STAT_LINES ) + 4;
+	f32                    scale  = PROFILER_GRAPH / ( 2.0f * PROFILER_BUDGET );
+	s32                    budget = base - ( s32 )( PROFILER_BUDGET * scale );
+	core::stringw          line;
+
+	driver->draw2DRectangle( video::SColor( 160, 0, 0, 0 ),
+	                         core::rect<s32>( x0 - 4, y0 - 4, x0 + PROFILER_WIDTH + 4, y0 + height ) );
+
+	for ( u32 i = 0; i < mdcProfiler::getFrameCount(); i++ ) {
+		f32 ms  = mdcProfiler::getFrameMs( i );
+		s32 top = base - core::min_( PROFILER_GRAPH, ( s32 )( ms * scale ) );
+		s32 x   = x0 + i * 2;
+
+		driver->draw2DRectangle( ms > PROFILER_BUDGET ? video::SColor( 255, 230, 80, 60 ) : video::SColor( 255, 97, 220, 220 ),
+		                         core::rect<s32>( x, top, x + 2, base ) );
+	}
+
+	driver->draw2DLine( core::position2d<s32>( x0, budget ), core::position2d<s32>( x0 + PROFILER_WIDTH, budget ),
+	                    video::SColor( 255, 255, 255, 255 ) );
+
+	if ( font == NULL ) {
+		return;
+	}
+
+	line  = L"frame ";
+	line += core::stringw( mdcProfiler::getAverageFrameMs() );
+	line += L" ms";
+	font->draw( line, core::rect<s32>( x0, base + 2, x0 + PROFILER_WIDTH, base + 2 + PROFILER_LINE ),
+	            video::SColor( 255, 255, 255, 255 ) );
+
+	for ( int z = 0; z < NUM_ZONES; z++ ) {
+		s32 y = base + 2 + PROFILER_LINE * ( z + 1 );
+
+		line  = mdcProfiler::getZoneName( ( profileZone_t )z );
+		line += L": ";
+		line += core::stringw( mdcProfiler::getAverageZoneMs( ( profileZone_t )z ) );
+		line += L" / ";
+		line += core::stringw( mdcProfiler::getMaxZoneMs( ( profileZone_t )z ) );
+		line += L" ms";
+
+		font->draw( line, core::rect<s32>( x0, y, x0 + PROFILER_WIDTH, y + PROFILER_LINE ),
+		            video::SColor( 255, 255, 255, 255 ) );
+	}
+
+	drawRenderStats( font, x0, base + 2 + PROFILER_LINE * ( NUM_ZONES + 1 ) );
+}
+
+void mdcApplication::drawRenderStats( gui::IGUIFont * font, s32 x0, s32 y ){
+	const renderStats_t &  stats = renderStats->getStats();
+	core::stringw          line[ PROFILER_STAT_LINES ];
+
+	line[ 0 ]  = L"nodes: ";
+	line[ 0 ] += stats.nodesDrawn;
+	line[ 0 ] += L" drawn / ";
+	line[ 0 ] += stats.nodesCulled;
+	line[ 0 ] += L" culled";
+
+	line[ 1 ]  = L"instances: ";
+	line[ 1 ] += stats.instancesDrawn;
+	line[ 1 ] += L" drawn / ";
+	line[ 1 ] += stats.instancesCulled;
+	line[ 1 ] += L" culled";
+
+	line[ 2 ]  = L"primitives: ";
+	line[ 2 ] += stats.primitives;
+	line[ 2 ] += L" materials: ";
+	line[ 2 ] += stats.materials;
+
+	line[ 3 ]  = L"textures: ";
+	line[ 3 ] += stats.textures;
+	line[ 3 ] += L" in use, ";
+	line[ 3 ] += stats.textureMemory;
+	line[ 3 ] += L" KiB total";
+
+	for ( int i = 0; i < PROFILER_STAT_LINES; i++, y += PROFILER_LINE ) {
+		font->draw( line[ i ], core::rect<s32>( x0, y, x0 + PROFILER_WIDTH, y + PROFILER_LINE ),
+		            video::SColor( 255, 255, 255, 255 ) );
+	}
+}
+
+/*------------------------------------------------------------------------------
+; Application::readCameraPath()
+;
+; Reads a camera path, one "px,py,pz,tx,ty,tz" line per frame with the
+; camera position and target, as written by mdcCameraRecorder. Lines that do
+; not match, like a header or comments, are skipped. Returns false if the
+; file has no keys.
+;-----------------------------------------------------------------------------*/
+bool mdcApplication::readCameraPath( const char * file, core::array< cameraKey_t > & path ) const {
+	FILE          *    in;
+	char               line[ 256 ];
+	cameraKey_t        key;
+
+	in = fopen( file, "r" );
+	if ( in == NULL ) {
+		return false;
+	}
+
+	while ( fgets( line, sizeof( line ), in ) != NULL ) {
+		if ( sscanf( line, "%f,%f,%f,%f,%f,%f", &key.position.X, &key.position.Y, &key.position.Z,
+		             &key.target.X, &key.target.Y, &key.target.Z ) == 6 ) {
+			path.push_back( key );
 		}
 	}
+
+	fclose( in );
+
+	return !path.empty();
+}
+
+// Nearest rank percentile of a sorted array.
+f32 mdcApplication::getPercentile( const core::array< f32 > & sorted, f32 p ) const {
+	u32 rank = ( u32 )ceilf( p * sorted.size() );
+
+	return sorted[ rank > 0 ? rank - 1 : 0 ];
+}
+
+/*------------------------------------------------------------------------------
+; Application::updatePick()
+;
+; Finds the exhibit under the crosshair. The last pick is kept until the
+; camera moves or the pick is invalidated, and picks are spaced by at least
+; the pick interval whatever the frame rate.
+;-----------------------------------------------------------------------------*/
+void mdcApplication::updatePick(){
+	core::line3d<f32>                  ray;
+	core::vector3df                    intersection;
+	core::vector3df                    position = camera->getPosition();
+	core::vector3df                    target   = camera->getTarget();
+	u32                                now      = device->getTimer()->getRealTime();
+	s32                                pickedId;
+
+	if ( dlgVisible ) {
+		return;
+	}
+
+	if ( !pickDirty && position.equals( lastPickPosition, PICK_EPSILON ) && target.equals( lastPickTarget, PICK_EPSILON ) ) {
+		return;
+	}
+
+	if ( now - lastPickTime < pickInterval ) {
+		return;
+	}
+
+	ray.start = position;
+	ray.end = ray.start + ( target - ray.start ).normalize() * 300.0f;
+
+	pickedId = scene->pickExhibit( ray, intersection );
+
+	lastPickTime     = now;
+	lastPickPosition = position;
+	lastPickTarget   = target;
+	pickDirty        = false;
+
+	if ( pickedId > 0 ) {
+		selectedNodeId = pickedId;
+		device->getCursorControl()->setActiveIcon( gui::ECI_HAND );
+		device->getCursorControl()->setVisible( true );
+	} else {
+		selectedNodeId = 0;
+		device->getCursorControl()->setVisible( false );
+	}
 }
 
 /*------------------------------------------------------------------------------
@@ -279,8 +628,13 @@ bool mdcApplication::OnEvent( const SEvent& event ) {
 			device->closeDevice();
 			return true;
 
+		} else if ( event.KeyInput.Key == irr::KEY_F2 && event.KeyInput.PressedDown ) {
+			profilerVisible = !profilerVisible;
+			return true;
+
 		} else if ( event.KeyInput.Key == irr::KEY_F1 && event.KeyInput.PressedDown ) {
-			if ( !dlgVisible ) {
+			// The settings dialog needs the camera, so wait until loading is done.
+			if ( !dlgVisible && loader == NULL ) {
 				stopMovement();
 				dlgVisible = true;
 				device->getCursorControl()->setActiveIcon( gui::ECI_NORMAL );
@@ -311,6 +665,7 @@ bool mdcApplication::OnEvent( const SEvent& event ) {
 				exDlg = NULL;
 				device->getCursorControl()->setVisible( false );
 				dlgVisible = false;
+				pickDirty = true;
 				guienv->setFocus( 0 );
 				device->getCursorControl()->setPosition( core::vector2d<s32>( w / 2, h / 2 ) );
 				return true;
@@ -324,6 +679,7 @@ void mdcApplication::onSettingsDialogHidden() {
 	int w = settings->getScreenWidth();
 	int h = settings->getScreenHeight();
 	dlgVisible = false;
+	pickDirty = true;
 
 	const SKeyMap * f  = settings->getForwardKey();
 	const SKeyMap * b  = settings->getBackwardKey();
@@ -29,8 +29,11 @@
 #include "SettingsMdl.hpp"
 #include "SettingsCtrl.hpp"
 #include "Scene.hpp"
+#include "SceneLoader.hpp"
 #include "ExhibitMdl.hpp"
 #include "ExhibitDlg.hpp"
+#include "CameraRecorder.hpp"
+#include "RenderStats.hpp"
 
 using namespace irr;
 
@@ -40,11 +43,13 @@ using namespace irr;
 ;-----------------------------------------------------------------------------*/
 class mdcApplication : public IEventReceiver {
 	public:
-		mdcApplication();
+		mdcApplication( video::E_DRIVER_TYPE = video::EDT_COUNT );
 		~mdcApplication();
 
 		void                        onSettingsDialogHidden();
 		void                        run();
+		bool                        runBenchmark( const char *, const char * );
+		bool                        startRecording( const char * );
 		bool                        OnEvent( const SEvent& event );
 
 	private:
@@ -58,16 +63,37 @@ class mdcApplication : public IEventReceiver {
 		mdcSettingsMdl                *      settings;
 		mdcSettingsCtrl               *      settingsCtrl;
 		mdcScene                      *      scene;
+		mdcSceneLoader                *      loader;
 		mdcExhibitMdl                 *      exhibits;
 		mdcExhibitDlg                 *      exDlg;
-		scene::ISceneCollisionManager *      collMan;
+		scene::ICameraSceneNode       *      camera;
+		mdcCameraRecorder             *      recorder;
+		mdcRenderStats                *      renderStats;
 
 		int                         lastFPS;
 		bool                        dlgVisible;
+		bool                        headless;
+		bool                        profilerVisible;
 		bool                        nodeSelected;
 		int                         selectedNodeId;
 
+		// Exhibit picking.
+		u32                         pickInterval;
+		u32                         lastPickTime;
+		core::vector3df             lastPickPosition;
+		core::vector3df             lastPickTarget;
+		bool                        pickDirty;
+
 		void                        loadScene();
+		void                        onSceneLoaded();
+		void                        drawProgressBar();
+		void                        runFrame();
+		bool                        pollDevice();
+		void                        drawProfiler();
+		void                        drawRenderStats( gui::IGUIFont *, s32, s32 );
+		bool                        readCameraPath( const char *, core::array< cameraKey_t > & ) const;
+		f32                         getPercentile( const core::array< f32 > &, f32 )              const;
+		void                        updatePick();
 		void                        stopMovement();
 };
 
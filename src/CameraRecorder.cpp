@@ -0,0 +1,201 @@
+/*------------------------------------------------------------------------------
+; File:          CameraRecorder.cpp
+; Description:   Implementation of the camera path recorder class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#include <iostream>
+
+#include "CameraRecorder.hpp"
+
+using std::cerr;
+using std::endl;
+
+// Keys buffered before they are handed to the writer thread.
+#define RECORDER_BUFFER 256
+
+mdcCameraRecorder::mdcCameraRecorder() {
+	out       = NULL;
+	recording = false;
+	tickMs    = 0;
+	nextTick  = 0;
+	started   = false;
+	stopping  = false;
+}
+
+mdcCameraRecorder::~mdcCameraRecorder() {
+	close();
+}
+
+/*------------------------------------------------------------------------------
+; mdcCameraRecorder::open()
+;
+; Starts recording to the given file at the given number of keys per second.
+; Returns false if the file cannot be created or the writer thread started.
+;-----------------------------------------------------------------------------*/
+bool mdcCameraRecorder::open( const char * path, u32 rate ) {
+	close();
+
+	out = fopen( path, "w" );
+	if ( out == NULL ) {
+		cerr << "mdcCameraRecorder::open() - Could not create " << path << endl;
+		return false;
+	}
+
+	fprintf( out, "# px,py,pz,tx,ty,tz at %u keys per second\n", rate );
+
+	tickMs   = rate > 0 ? 1000 / rate : 0;
+	started  = false;
+	stopping = false;
+	buffer.reallocate( RECORDER_BUFFER );
+
+	pthread_mutex_init( &lock, NULL );
+	pthread_cond_init( &wake, NULL );
+
+	if ( pthread_create( &writer, NULL, writerMain, this ) != 0 ) {
+		cerr << "mdcCameraRecorder::open() - Could not start the writer thread." << endl;
+		pthread_cond_destroy( &wake );
+		pthread_mutex_destroy( &lock );
+		fclose( out );
+		out = NULL;
+		return false;
+	}
+
+	recording = true;
+
+	return true;
+}
+
+/*------------------------------------------------------------------------------
+; mdcCameraRecorder::close()
+;
+; Hands the last keys to the writer thread, waits for it to write them and
+; closes the file.
+;-----------------------------------------------------------------------------*/
+void mdcCameraRecorder::close() {
+	if ( !recording ) {
+		return;
+	}
+
+	flush();
+
+	pthread_mutex_lock( &lock );
+	stopping = true;
+	pthread_cond_signal( &wake );
+	pthread_mutex_unlock( &lock );
+
+	pthread_join( writer, NULL );
+
+	pthread_cond_destroy( &wake );
+	pthread_mutex_destroy( &lock );
+
+	fclose( out );
+	out       = NULL;
+	recording = false;
+}
+
+bool mdcCameraRecorder::isRecording() const {
+	return recording;
+}
+
+/*------------------------------------------------------------------------------
+; mdcCameraRecorder::update()
+;
+; Called every frame with the current time in milliseconds. Adds a key for
+; every tick since the last call, so the recording keeps a fixed rate even if
+; the frame rate changes.
+;-----------------------------------------------------------------------------*/
+void mdcCameraRecorder::update( u32 now, const core::vector3df & position, const core::vector3df & target ) {
+	cameraKey_t key;
+
+	if ( !recording ) {
+		return;
+	}
+
+	if ( !started ) {
+		nextTick = now;
+		started  = true;
+	}
+
+	key.position = position;
+	key.target   = target;
+
+	while ( ( s32 )( now - nextTick ) >= 0 ) {
+		buffer.push_back( key );
+
+		if ( buffer.size() >= RECORDER_BUFFER ) {
+			flush();
+		}
+
+		if ( tickMs == 0 ) {
+			break;
+		}
+		nextTick += tickMs;
+	}
+}
+
+// Appends the buffered keys to the ones waiting for the writer thread.
+void mdcCameraRecorder::flush() {
+	if ( buffer.empty() ) {
+		return;
+	}
+
+	pthread_mutex_lock( &lock );
+	for ( u32 i = 0; i < buffer.size(); i++ ) {
+		pending.push_back( buffer[ i ] );
+	}
+	pthread_cond_signal( &wake );
+	pthread_mutex_unlock( &lock );
+
+	buffer.set_used( 0 );
+}
+
+void * mdcCameraRecorder::writerMain( void * arg ) {
+	static_cast< mdcCameraRecorder * >( arg )->writeKeys();
+	return NULL;
+}
+
+/*------------------------------------------------------------------------------
+; mdcCameraRecorder::writeKeys()
+;
+; Runs on the writer thread. Takes every pending key at once and writes them
+; outside the lock, until close() asks it to stop.
+;-----------------------------------------------------------------------------*/
+void mdcCameraRecorder::writeKeys() {
+	core::array< cameraKey_t > keys;
+	bool                       done = false;
+
+	while ( !done ) {
+		pthread_mutex_lock( &lock );
+		while ( pending.empty() && !stopping ) {
+			pthread_cond_wait( &wake, &lock );
+		}
+		keys.swap( pending );
+		done = stopping && keys.empty();
+		pthread_mutex_unlock( &lock );
+
+		for ( u32 i = 0; i < keys.size(); i++ ) {
+			fprintf( out, "%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+			         keys[ i ].position.X, keys[ i ].position.Y, keys[ i ].position.Z,
+			         keys[ i ].target.X, keys[ i ].target.Y, keys[ i ].target.Z );
+		}
+		keys.set_used( 0 );
+	}
+
+	fflush( out );
+}
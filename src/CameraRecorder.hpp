@@ -0,0 +1,81 @@
+/*------------------------------------------------------------------------------
+; File:          CameraRecorder.hpp
+; Description:   Declaration of the camera path recorder class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#ifndef CAMERARECORDER_H
+#define CAMERARECORDER_H
+
+#include <cstdio>
+#include <pthread.h>
+#include <irrlicht.h>
+
+#include "definitions.hpp"
+
+using namespace irr;
+
+// A camera path key, the camera position and target at one tick.
+typedef struct CAMERA_KEY {
+	core::vector3df             position;
+	core::vector3df             target;
+} cameraKey_t;
+
+/*------------------------------------------------------------------------------
+; Records the camera to a CSV file at a fixed tick, one "px,py,pz,tx,ty,tz"
+; line per key, the format the benchmark and the tours read. Keys are
+; buffered on the main thread and written by a background thread, so a
+; sample costs a copy and, every few hundred keys, a buffer swap.
+;-----------------------------------------------------------------------------*/
+class mdcCameraRecorder {
+	public:
+		mdcCameraRecorder();
+		~mdcCameraRecorder();
+
+		bool                            open( const char *, u32 );
+		void                            close();
+		bool                            isRecording()           const;
+
+		void                            update( u32, const core::vector3df &, const core::vector3df & );
+
+	private:
+		FILE                     *      out;
+		bool                            recording;
+		u32                             tickMs;
+		u32                             nextTick;
+		bool                            started;
+
+		// Keys filled by the main thread.
+		core::array< cameraKey_t >      buffer;
+
+		// Keys handed to the writer thread.
+		pthread_t                       writer;
+		pthread_mutex_t                 lock;
+		pthread_cond_t                  wake;
+		core::array< cameraKey_t >      pending;
+		bool                            stopping;
+
+		mdcCameraRecorder( mdcCameraRecorder const & ) { };
+		mdcCameraRecorder & operator=( mdcCameraRecorder const & ) { return *this; }
+
+		void                            flush();
+		static void            *        writerMain( void * );
+		void                            writeKeys();
+};
+
+#endif // CAMERARECORDER_H
@@ -0,0 +1,539 @@
+/*------------------------------------------------------------------------------
+; File:          CollisionBvh.cpp
+; Description:   Implementation of the static collision BVH class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+
+#include <cstdlib>
+#include <cstring>
+
+#if defined( _WIN32 ) || defined( __MINGW32__ )
+#include <malloc.h>
+#endif
+
+#include "CollisionBvh.hpp"
+
+#define NUM_BINS     12
+#define LEAF_SIZE    4
+#define MAX_LEAF     16
+#define MAX_DEPTH    60
+#define STACK_SIZE   ( MAX_DEPTH + 4 )
+#define NODE_ALIGN   32
+
+// Triangle reference used while building.
+typedef struct BVH_REF {
+	core::aabbox3df    box;
+	core::vector3df    centroid;
+	u32                triangle;
+} bvhRef_t;
+
+static u32    buildNode( core::array< bvhNode_t > &, bvhRef_t *, u32, u32, int );
+static f32    area( const core::aabbox3df & );
+static f32    component( const core::vector3df &, int );
+static void   setBox( bvhNode_t &, const core::aabbox3df & );
+static bool   boxesOverlap( const bvhNode_t &, const core::aabbox3df & );
+static bool   lineHitsBox( const bvhNode_t &, const core::vector3df &, const core::vector3df & );
+static void * alignedAlloc( size_t );
+static void   alignedFree( void * );
+
+mdcCollisionBvh::mdcCollisionBvh() {
+	nodes    = NULL;
+	numNodes = 0;
+}
+
+mdcCollisionBvh::~mdcCollisionBvh() {
+	alignedFree( nodes );
+}
+
+/*------------------------------------------------------------------------------
+; mdcCollisionBvh::addSelector()
+;
+; Copies every triangle of the given selector. The selector must return them
+; in world space, which is the case for the stock selectors and ours. Only
+; occluder triangles count for isSegmentOccluded().
+;-----------------------------------------------------------------------------*/
+void mdcCollisionBvh::addSelector( const scene::ITriangleSelector * selector, bool occluder ) {
+	s32 count = selector->getTriangleCount();
+	s32 written;
+	u32 first = triangles.size();
+
+	if ( count <= 0 ) {
+		return;
+	}
+
+	triangles.set_used( first + count );
+	selector->getTriangles( triangles.pointer() + first, count, written );
+	triangles.set_used( first + written );
+
+	for ( s32 i = 0; i < written; i++ ) {
+		owners.push_back( selector->getSceneNodeForTriangle( i ) );
+		occluders.push_back( occluder );
+	}
+}
+
+/*------------------------------------------------------------------------------
+; mdcCollisionBvh::build()
+;
+; Builds the hierarchy over every triangle added so far and sorts the
+; triangles into leaf order.
+;-----------------------------------------------------------------------------*/
+void mdcCollisionBvh::build() {
+	core::array< bvhNode_t >            tree;
+	core::array< core::triangle3df >    sorted;
+	core::array< scene::ISceneNode * >  sortedOwners;
+	core::array< bool >                 sortedOccluders;
+	bvhRef_t                        *   refs;
+	u32                                 n = triangles.size();
+
+	alignedFree( nodes );
+	nodes    = NULL;
+	numNodes = 0;
+
+	if ( n == 0 ) {
+		return;
+	}
+
+	refs = new bvhRef_t[ n ];
+	for ( u32 i = 0; i < n; i++ ) {
+		refs[ i ].box.reset( triangles[ i ].pointA );
+		refs[ i ].box.addInternalPoint( triangles[ i ].pointB );
+		refs[ i ].box.addInternalPoint( triangles[ i ].pointC );
+		refs[ i ].centroid = refs[ i ].box.getCenter();
+		refs[ i ].triangle = i;
+	}
+
+	tree.reallocate( 2 * n / LEAF_SIZE + 1 );
+	buildNode( tree, refs, 0, n, 0 );
+
+	sorted.reallocate( n );
+	sortedOwners.reallocate( n );
+	sortedOccluders.reallocate( n );
+	for ( u32 i = 0; i < n; i++ ) {
+		sorted.push_back( triangles[ refs[ i ].triangle ] );
+		sortedOwners.push_back( owners[ refs[ i ].triangle ] );
+		sortedOccluders.push_back( occluders[ refs[ i ].triangle ] );
+	}
+	triangles = sorted;
+	owners    = sortedOwners;
+	occluders = sortedOccluders;
+
+	// Copy for the ray kernels, in the same order.
+	blocks.set_used( ( n + KERNEL_WIDTH - 1 ) / KERNEL_WIDTH );
+	memset( blocks.pointer(), 0, sizeof( triBlock_t ) * blocks.size() );
+	for ( u32 i = 0; i < n; i++ ) {
+		mdcRayKernels::packTriangle( blocks.pointer(), i, triangles[ i ] );
+	}
+
+	delete[] refs;
+
+	numNodes = tree.size();
+	nodes    = ( bvhNode_t * )alignedAlloc( sizeof( bvhNode_t ) * numNodes );
+	memcpy( nodes, tree.const_pointer(), sizeof( bvhNode_t ) * numNodes );
+}
+
+/*------------------------------------------------------------------------------
+; mdcCollisionBvh::isSegmentOccluded()
+;
+; Returns true if the line segment crosses an occluder triangle.
+;-----------------------------------------------------------------------------*/
+bool mdcCollisionBvh::isSegmentOccluded( const core::line3d< f32 > & line ) const {
+	u32             stack[ STACK_SIZE ];
+	u32             top = 0;
+	kernelRay_t     ray;
+	f32             t[ KERNEL_WIDTH ];
+	core::vector3df invDir;
+
+	mdcRayKernels::makeRay( ray, line );
+	invDir.set( ray.invDir[ 0 ], ray.invDir[ 1 ], ray.invDir[ 2 ] );
+
+	if ( numNodes > 0 ) {
+		stack[ top++ ] = 0;
+	}
+
+	while ( top > 0 ) {
+		u32               index = stack[ --top ];
+		const bvhNode_t & node  = nodes[ index ];
+		u32               last;
+
+		if ( !lineHitsBox( node, line.start, invDir ) ) {
+			continue;
+		}
+
+		if ( node.count == 0 ) {
+			stack[ top++ ] = node.offset;
+			stack[ top++ ] = index + 1;
+			continue;
+		}
+
+		last = ( node.offset + node.count - 1 ) / KERNEL_WIDTH;
+		for ( u32 b = node.offset / KERNEL_WIDTH; b <= last; b++ ) {
+			u32 mask = mdcRayKernels::intersectTriangles( blocks[ b ], ray, 1.0f, t ) &
+			           mdcRayKernels::getLaneMask( b, node.offset, node.count );
+
+			for ( u32 lane = 0; mask != 0; lane++, mask >>= 1 ) {
+				if ( ( mask & 1 ) && occluders[ b * KERNEL_WIDTH + lane ] ) {
+					return true;
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
+const triBlock_t * mdcCollisionBvh::getTriangleBlocks() const {
+	return blocks.const_pointer();
+}
+
+u32 mdcCollisionBvh::getTriangleBlockCount() const {
+	return blocks.size();
+}
+
+s32 mdcCollisionBvh::getTriangleCount() const {
+	return triangles.size();
+}
+
+void mdcCollisionBvh::getTriangles( core::triangle3df * out, s32 arraySize, s32 & outCount, const core::matrix4 * transform ) const {
+	s32 n = core::min_( arraySize, ( s32 )triangles.size() );
+
+	for ( s32 i = 0; i < n; i++ ) {
+		copyTriangle( out[ i ], i, transform );
+	}
+
+	outCount = n;
+}
+
+/*------------------------------------------------------------------------------
+; mdcCollisionBvh::getTriangles()
+;
+; Returns the triangles whose bounding box touches the given world space box.
+;-----------------------------------------------------------------------------*/
+void mdcCollisionBvh::getTriangles( core::triangle3df * out, s32 arraySize, s32 & outCount,
+                                    const core::aabbox3d< f32 > & box, const core::matrix4 * transform ) const {
+	u32 stack[ STACK_SIZE ];
+	u32 top = 0;
+	s32 n   = 0;
+
+	if ( numNodes > 0 ) {
+		stack[ top++ ] = 0;
+	}
+
+	while ( top > 0 && n < arraySize ) {
+		u32               index = stack[ --top ];
+		const bvhNode_t & node  = nodes[ index ];
+
+		if ( !boxesOverlap( node, box ) ) {
+			continue;
+		}
+
+		if ( node.count == 0 ) {
+			stack[ top++ ] = node.offset;
+			stack[ top++ ] = index + 1;
+			continue;
+		}
+
+		for ( u32 i = node.offset; i < node.offset + node.count && n < arraySize; i++ ) {
+			const core::triangle3df & tri = triangles[ i ];
+			core::aabbox3df           triBox( tri.pointA );
+
+			triBox.addInternalPoint( tri.pointB );
+			triBox.addInternalPoint( tri.pointC );
+
+			if ( triBox.intersectsWithBox( box ) ) {
+				copyTriangle( out[ n++ ], i, transform );
+			}
+		}
+	}
+
+	outCount = n;
+}
+
+/*------------------------------------------------------------------------------
+; mdcCollisionBvh::getTriangles()
+;
+; Returns the triangles of every leaf crossed by the line segment.
+;-----------------------------------------------------------------------------*/
+void mdcCollisionBvh::getTriangles( core::triangle3df * out, s32 arraySize, s32 & outCount,
+                                    const core::line3d< f32 > & line, const core::matrix4 * transform ) const {
+	u32             stack[ STACK_SIZE ];
+	u32             top = 0;
+	s32             n   = 0;
+	core::vector3df dir = line.end - line.start;
+	core::vector3df invDir;
+
+	// A zero component gives an infinite inverse, which the slab test handles.
+	invDir.X = dir.X != 0.0f ? 1.0f / dir.X : 1e30f;
+	invDir.Y = dir.Y != 0.0f ? 1.0f / dir.Y : 1e30f;
+	invDir.Z = dir.Z != 0.0f ? 1.0f / dir.Z : 1e30f;
+
+	if ( numNodes > 0 ) {
+		stack[ top++ ] = 0;
+	}
+
+	while ( top > 0 && n < arraySize ) {
+		u32               index = stack[ --top ];
+		const bvhNode_t & node  = nodes[ index ];
+
+		if ( !lineHitsBox( node, line.start, invDir ) ) {
+			continue;
+		}
+
+		if ( node.count == 0 ) {
+			stack[ top++ ] = node.offset;
+			stack[ top++ ] = index + 1;
+			continue;
+		}
+
+		for ( u32 i = node.offset; i < node.offset + node.count && n < arraySize; i++ ) {
+			copyTriangle( out[ n++ ], i, transform );
+		}
+	}
+
+	outCount = n;
+}
+
+scene::ISceneNode * mdcCollisionBvh::getSceneNodeForTriangle( u32 index ) const {
+	return index < owners.size() ? owners[ index ] : NULL;
+}
+
+u32 mdcCollisionBvh::getSelectorCount() const {
+	return 1;
+}
+
+scene::ITriangleSelector * mdcCollisionBvh::getSelector( u32 index ) {
+	return index == 0 ? this : NULL;
+}
+
+const scene::ITriangleSelector * mdcCollisionBvh::getSelector( u32 index ) const {
+	return index == 0 ? this : NULL;
+}
+
+void mdcCollisionBvh::copyTriangle( core::triangle3df & out, u32 index, const core::matrix4 * transform ) const {
+	out = triangles[ index ];
+
+	if ( transform != NULL ) {
+		transform->transformVect( out.pointA );
+		transform->transformVect( out.pointB );
+		transform->transformVect( out.pointC );
+	}
+}
+
+/*------------------------------------------------------------------------------
+; buildNode()
+;
+; Builds the subtree over refs[ first, first + count ) and returns its index.
+; The split is chosen among NUM_BINS planes along the axis where centroids
+; spread the most, by the surface area heuristic.
+;-----------------------------------------------------------------------------*/
+static u32 buildNode( core::array< bvhNode_t > & tree, bvhRef_t * refs, u32 first, u32 count, int depth ) {
+	core::aabbox3df   bounds( refs[ first ].box );
+	core::aabbox3df   centroids( refs[ first ].centroid );
+	core::aabbox3df   binBoxes[ NUM_BINS ];
+	u32               binCounts[ NUM_BINS ];
+	f32               rightAreas[ NUM_BINS ];
+	u32               rightCounts[ NUM_BINS ];
+	core::aabbox3df   acc;
+	core::vector3df   extent;
+	bvhNode_t         node;
+	u32               index = tree.size();
+	u32               accCount;
+	u32               mid;
+	u32               right;
+	u32               bestSplit = 0;
+	f32               bestCost  = 0.0f;
+	f32               cmin;
+	f32               scale;
+	int               axis;
+
+	for ( u32 i = first + 1; i < first + count; i++ ) {
+		bounds.addInternalBox( refs[ i ].box );
+		centroids.addInternalPoint( refs[ i ].centroid );
+	}
+
+	setBox( node, bounds );
+	node.offset = first;
+	node.count  = count;
+	tree.push_back( node );
+
+	if ( count <= LEAF_SIZE || depth >= MAX_DEPTH ) {
+		return index;
+	}
+
+	extent = centroids.getExtent();
+	axis   = extent.X > extent.Y ? ( extent.X > extent.Z ? 0 : 2 ) : ( extent.Y > extent.Z ? 1 : 2 );
+
+	if ( component( extent, axis ) <= 0.0f ) {
+		// Every centroid is the same point, nothing to split.
+		return index;
+	}
+
+	cmin  = component( centroids.MinEdge, axis );
+	scale = NUM_BINS / component( extent, axis );
+
+	for ( int b = 0; b < NUM_BINS; b++ ) {
+		binCounts[ b ] = 0;
+	}
+
+	for ( u32 i = first; i < first + count; i++ ) {
+		int b = core::min_( NUM_BINS - 1, ( int )( ( component( refs[ i ].centroid, axis ) - cmin ) * scale ) );
+
+		if ( binCounts[ b ] == 0 ) {
+			binBoxes[ b ] = refs[ i ].box;
+		} else {
+			binBoxes[ b ].addInternalBox( refs[ i ].box );
+		}
+		binCounts[ b ]++;
+	}
+
+	// Sweep from the right to get the cost of everything past each plane.
+	accCount = 0;
+	for ( int b = NUM_BINS - 1; b > 0; b-- ) {
+		if ( binCounts[ b ] > 0 ) {
+			if ( accCount == 0 ) acc = binBoxes[ b ];
+			else acc.addInternalBox( binBoxes[ b ] );
+			accCount += binCounts[ b ];
+		}
+		rightCounts[ b ] = accCount;
+		rightAreas[ b ]  = accCount > 0 ? area( acc ) : 0.0f;
+	}
+
+	// Then from the left, the plane before bin b splits [0, b) from [b, NUM_BINS).
+	accCount = 0;
+	for ( int b = 1; b < NUM_BINS; b++ ) {
+		if ( binCounts[ b - 1 ] > 0 ) {
+			if ( accCount == 0 ) acc = binBoxes[ b - 1 ];
+			else acc.addInternalBox( binBoxes[ b - 1 ] );
+			accCount += binCounts[ b - 1 ];
+		}
+
+		if ( accCount > 0 && rightCounts[ b ] > 0 ) {
+			f32 cost = accCount * area( acc ) + rightCounts[ b ] * rightAreas[ b ];
+			if ( bestSplit == 0 || cost < bestCost ) {
+				bestCost  = cost;
+				bestSplit = b;
+			}
+		}
+	}
+
+	if ( bestSplit == 0 ) {
+		return index;
+	}
+
+	// Keep small sets as leaves when splitting does not pay off.
+	if ( count <= MAX_LEAF && bestCost >= count * area( bounds ) ) {
+		return index;
+	}
+
+	// Partition the references in place.
+	mid = first;
+	for ( u32 i = first; i < first + count; i++ ) {
+		int b = core::min_( NUM_BINS - 1, ( int )( ( component( refs[ i ].centroid, axis ) - cmin ) * scale ) );
+
+		if ( b < ( int )bestSplit ) {
+			bvhRef_t tmp = refs[ i ];
+			refs[ i ]    = refs[ mid ];
+			refs[ mid ]  = tmp;
+			mid++;
+		}
+	}
+
+	if ( mid == first || mid == first + count ) {
+		mid = first + count / 2;
+	}
+
+	// The children may grow the array, so only index it once they are built.
+	buildNode( tree, refs, first, mid - first, depth + 1 );
+	right = buildNode( tree, refs, mid, first + count - mid, depth + 1 );
+
+	tree[ index ].offset = right;
+	tree[ index ].count  = 0;
+
+	return index;
+}
+
+static f32 area( const core::aabbox3df & box ) {
+	core::vector3df e = box.getExtent();
+	return 2.0f * ( e.X * e.Y + e.Y * e.Z + e.Z * e.X );
+}
+
+static f32 component( const core::vector3df & v, int axis ) {
+	return axis == 0 ? v.X : ( axis == 1 ? v.Y : v.Z );
+}
+
+static void setBox( bvhNode_t & node, const core::aabbox3df & box ) {
+	node.min[ 0 ] = box.MinEdge.X;
+	node.min[ 1 ] = box.MinEdge.Y;
+	node.min[ 2 ] = box.MinEdge.Z;
+	node.max[ 0 ] = box.MaxEdge.X;
+	node.max[ 1 ] = box.MaxEdge.Y;
+	node.max[ 2 ] = box.MaxEdge.Z;
+}
+
+static bool boxesOverlap( const bvhNode_t & node, const core::aabbox3df & box ) {
+	return node.min[ 0 ] <= box.MaxEdge.X && node.max[ 0 ] >= box.MinEdge.X &&
+	       node.min[ 1 ] <= box.MaxEdge.Y && node.max[ 1 ] >= box.MinEdge.Y &&
+	       node.min[ 2 ] <= box.MaxEdge.Z && node.max[ 2 ] >= box.MinEdge.Z;
+}
+
+// Slab test of the segment start + t * dir, t in [0, 1], against the node box.
+static bool lineHitsBox( const bvhNode_t & node, const core::vector3df & start, const core::vector3df & invDir ) {
+	f32 tmin = 0.0f;
+	f32 tmax = 1.0f;
+
+	for ( int a = 0; a < 3; a++ ) {
+		f32 t0 = ( node.min[ a ] - component( start, a ) ) * component( invDir, a );
+		f32 t1 = ( node.max[ a ] - component( start, a ) ) * component( invDir, a );
+
+		if ( t0 > t1 ) {
+			f32 tmp = t0;
+			t0 = t1;
+			t1 = tmp;
+		}
+
+		tmin = t0 > tmin ? t0 : tmin;
+		tmax = t1 < tmax ? t1 : tmax;
+
+		if ( tmin > tmax ) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void * alignedAlloc( size_t size ) {
+#if defined( _WIN32 ) || defined( __MINGW32__ )
+	return _aligned_malloc( size, NODE_ALIGN );
+#elif defined( __linux__ )
+	void * ptr;
+	return posix_memalign( &ptr, NODE_ALIGN, size ) == 0 ? ptr : NULL;
+#else
+#error "Not a GNU/Linux or Windows platform."
+#endif
+}
+
+static void alignedFree( void * ptr ) {
+#if defined( _WIN32 ) || defined( __MINGW32__ )
+	_aligned_free( ptr );
+#elif defined( __linux__ )
+	free( ptr );
+#else
+#error "Not a GNU/Linux or Windows platform."
+#endif
+}
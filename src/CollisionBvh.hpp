@@ -0,0 +1,93 @@
+/*------------------------------------------------------------------------------
+; File:          CollisionBvh.hpp
+; Description:   Declaration of the static collision BVH class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+
+#ifndef COLLISIONBVH_H
+#define COLLISIONBVH_H
+
+#include <irrlicht.h>
+
+#include "definitions.hpp"
+#include "RayKernels.hpp"
+
+using namespace irr;
+
+// BVH node, 32 bytes. Inner nodes have count zero, their left child follows
+// them and offset holds the right child. Leaves hold count triangles starting
+// at offset.
+typedef struct BVH_NODE {
+	f32    min[ 3 ];
+	u32    offset;
+	f32    max[ 3 ];
+	u32    count;
+} bvhNode_t;
+
+/*------------------------------------------------------------------------------
+; A single triangle selector over every static triangle of the scene. The
+; triangles of the selectors added with addSelector() are copied in world
+; space and sorted into a bounding volume hierarchy built with binned SAH
+; splits, so a query costs about the same however many meshes there are.
+; Triangle indices used by getSceneNodeForTriangle() are positions in the
+; sorted order. Triangles can be marked as occluders for visibility tests.
+;-----------------------------------------------------------------------------*/
+class mdcCollisionBvh : public scene::ITriangleSelector {
+	public:
+		mdcCollisionBvh();
+		virtual ~mdcCollisionBvh();
+
+		// Building.
+		void                            addSelector( const scene::ITriangleSelector *, bool = true );
+		void                            build();
+
+		// Visibility.
+		bool                            isSegmentOccluded( const core::line3d< f32 > & )                const;
+		const triBlock_t         *      getTriangleBlocks()                                             const;
+		u32                             getTriangleBlockCount()                                         const;
+
+		virtual s32                     getTriangleCount()                                              const;
+		virtual void                    getTriangles( core::triangle3df *, s32, s32 &,
+		                                              const core::matrix4 * = 0 )                       const;
+		virtual void                    getTriangles( core::triangle3df *, s32, s32 &,
+		                                              const core::aabbox3d< f32 > &,
+		                                              const core::matrix4 * = 0 )                       const;
+		virtual void                    getTriangles( core::triangle3df *, s32, s32 &,
+		                                              const core::line3d< f32 > &,
+		                                              const core::matrix4 * = 0 )                       const;
+		virtual scene::ISceneNode *     getSceneNodeForTriangle( u32 )                                  const;
+		virtual u32                     getSelectorCount()                                              const;
+		virtual scene::ITriangleSelector * getSelector( u32 );
+		virtual const scene::ITriangleSelector * getSelector( u32 )                                     const;
+
+	private:
+		bvhNode_t                *      nodes;
+		u32                             numNodes;
+		core::array< core::triangle3df > triangles;
+		core::array< scene::ISceneNode * > owners;
+		core::array< bool >             occluders;
+		core::array< triBlock_t >       blocks;
+
+		mdcCollisionBvh( mdcCollisionBvh const & ) { };
+		mdcCollisionBvh & operator=( mdcCollisionBvh const & ) { return *this; }
+
+		void                            copyTriangle( core::triangle3df &, u32, const core::matrix4 * ) const;
+};
+
+#endif // COLLISIONBVH_H
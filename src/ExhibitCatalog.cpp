@@ -0,0 +1,360 @@
+/*------------------------------------------------------------------------------
+; File:          ExhibitCatalog.cpp
+; Description:   Implementation of the in-memory exhibit catalog class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+
+#include "ExhibitMdl.hpp"
+#include "ExhibitCatalog.hpp"
+
+#define INITIAL_ROWS     64
+#define INITIAL_STRINGS  4096
+#define INITIAL_TABLE    128
+
+static unsigned int hashString( const char * );
+static unsigned int hashInt( int );
+
+mdcExhibitCatalog::mdcExhibitCatalog() {
+	count           = 0;
+	capacity        = 0;
+	ids             = NULL;
+	titles          = NULL;
+	descriptions    = NULL;
+	modelPaths      = NULL;
+	photoPaths      = NULL;
+	translations    = NULL;
+	rotations       = NULL;
+	scalings        = NULL;
+	rotationAmounts = NULL;
+	strings         = NULL;
+	stringsSize     = 0;
+	stringsCapacity = 0;
+	stringTable     = NULL;
+	stringTableSize = 0;
+	numStrings      = 0;
+	idTable         = NULL;
+	idTableSize     = 0;
+}
+
+mdcExhibitCatalog::~mdcExhibitCatalog() {
+	clear();
+}
+
+void mdcExhibitCatalog::clear() {
+	free( ids );
+	free( titles );
+	free( descriptions );
+	free( modelPaths );
+	free( photoPaths );
+	free( translations );
+	free( rotations );
+	free( scalings );
+	free( rotationAmounts );
+	free( strings );
+	free( stringTable );
+	free( idTable );
+
+	count           = 0;
+	capacity        = 0;
+	ids             = NULL;
+	titles          = NULL;
+	descriptions    = NULL;
+	modelPaths      = NULL;
+	photoPaths      = NULL;
+	translations    = NULL;
+	rotations       = NULL;
+	scalings        = NULL;
+	rotationAmounts = NULL;
+	strings         = NULL;
+	stringsSize     = 0;
+	stringsCapacity = 0;
+	stringTable     = NULL;
+	stringTableSize = 0;
+	numStrings      = 0;
+	idTable         = NULL;
+	idTableSize     = 0;
+}
+
+/*------------------------------------------------------------------------------
+; mdcExhibitCatalog::addExhibit()
+;
+; Appends a row to the catalog. buildIndex() must be called after the last row
+; is added and before any lookup by id.
+;-----------------------------------------------------------------------------*/
+void mdcExhibitCatalog::addExhibit( int id, const char * title, const char * desc, const char * model,
+                                    const char * photo, const vec3_t & t, const vec3_t & r, const vec3_t & s,
+                                    float ra ) {
+	if ( count == capacity ) {
+		capacity = capacity == 0 ? INITIAL_ROWS : capacity * 2;
+
+		ids             = ( int * )realloc( ids, sizeof( int ) * capacity );
+		titles          = ( int * )realloc( titles, sizeof( int ) * capacity );
+		descriptions    = ( int * )realloc( descriptions, sizeof( int ) * capacity );
+		modelPaths      = ( int * )realloc( modelPaths, sizeof( int ) * capacity );
+		photoPaths      = ( int * )realloc( photoPaths, sizeof( int ) * capacity );
+		translations    = ( vec3_t * )realloc( translations, sizeof( vec3_t ) * capacity );
+		rotations       = ( vec3_t * )realloc( rotations, sizeof( vec3_t ) * capacity );
+		scalings        = ( vec3_t * )realloc( scalings, sizeof( vec3_t ) * capacity );
+		rotationAmounts = ( float * )realloc( rotationAmounts, sizeof( float ) * capacity );
+	}
+
+	ids[ count ]             = id;
+	titles[ count ]          = internString( title );
+	descriptions[ count ]    = internString( desc );
+	modelPaths[ count ]      = internString( model );
+	photoPaths[ count ]      = internString( photo );
+	translations[ count ]    = t;
+	rotations[ count ]       = r;
+	scalings[ count ]        = s;
+	rotationAmounts[ count ] = ra;
+
+	count++;
+}
+
+/*------------------------------------------------------------------------------
+; mdcExhibitCatalog::buildIndex()
+;
+; Fills the id -> row table. The table is kept at most half full so probe
+; sequences stay short.
+;-----------------------------------------------------------------------------*/
+void mdcExhibitCatalog::buildIndex() {
+	unsigned int slot;
+
+	free( idTable );
+
+	idTableSize = INITIAL_TABLE;
+	while ( idTableSize < count * 2 ) {
+		idTableSize *= 2;
+	}
+
+	idTable = ( int * )calloc( idTableSize, sizeof( int ) );
+
+	for ( int i = 0; i < count; i++ ) {
+		slot = hashInt( ids[ i ] ) & ( idTableSize - 1 );
+
+		while ( idTable[ slot ] != 0 && ids[ idTable[ slot ] - 1 ] != ids[ i ] ) {
+			slot = ( slot + 1 ) & ( idTableSize - 1 );
+		}
+
+		idTable[ slot ] = i + 1;
+	}
+}
+
+int mdcExhibitCatalog::getNumOfExhibits() const {
+	return count;
+}
+
+/*------------------------------------------------------------------------------
+; mdcExhibitCatalog::getIndexById()
+;
+; Returns the row of the exhibit with the given id or -1 if there is none.
+;-----------------------------------------------------------------------------*/
+int mdcExhibitCatalog::getIndexById( int id ) const {
+	unsigned int slot;
+
+	if ( idTable == NULL ) {
+		return -1;
+	}
+
+	slot = hashInt( id ) & ( idTableSize - 1 );
+
+	while ( idTable[ slot ] != 0 ) {
+		if ( ids[ idTable[ slot ] - 1 ] == id ) {
+			return idTable[ slot ] - 1;
+		}
+		slot = ( slot + 1 ) & ( idTableSize - 1 );
+	}
+
+	return -1;
+}
+
+/*------------------------------------------------------------------------------
+; mdcExhibitCatalog::getFirstIndexAfterId()
+;
+; Binary search for the first row whose id is greater than the given one.
+; Returns the number of rows if there is no such row.
+;-----------------------------------------------------------------------------*/
+int mdcExhibitCatalog::getFirstIndexAfterId( int id ) const {
+	int lo = 0;
+	int hi = count;
+	int mid;
+
+	while ( lo < hi ) {
+		mid = lo + ( hi - lo ) / 2;
+		if ( ids[ mid ] <= id ) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+
+int mdcExhibitCatalog::getIdByIndex( int i ) const {
+	assert( i >= 0 && i < count );
+	return ids[ i ];
+}
+
+const char * mdcExhibitCatalog::getTitleByIndex( int i ) const {
+	assert( i >= 0 && i < count );
+	return getString( titles[ i ] );
+}
+
+const char * mdcExhibitCatalog::getDescriptionByIndex( int i ) const {
+	assert( i >= 0 && i < count );
+	return getString( descriptions[ i ] );
+}
+
+const char * mdcExhibitCatalog::getModelPathByIndex( int i ) const {
+	assert( i >= 0 && i < count );
+	return getString( modelPaths[ i ] );
+}
+
+const char * mdcExhibitCatalog::getPhotoPathByIndex( int i ) const {
+	assert( i >= 0 && i < count );
+	return getString( photoPaths[ i ] );
+}
+
+const vec3_t & mdcExhibitCatalog::getTranslationByIndex( int i ) const {
+	assert( i >= 0 && i < count );
+	return translations[ i ];
+}
+
+const vec3_t & mdcExhibitCatalog::getRotationByIndex( int i ) const {
+	assert( i >= 0 && i < count );
+	return rotations[ i ];
+}
+
+const vec3_t & mdcExhibitCatalog::getScalingByIndex( int i ) const {
+	assert( i >= 0 && i < count );
+	return scalings[ i ];
+}
+
+float mdcExhibitCatalog::getRotationAmountByIndex( int i ) const {
+	assert( i >= 0 && i < count );
+	return rotationAmounts[ i ];
+}
+
+/*------------------------------------------------------------------------------
+; mdcExhibitCatalog::internString()
+;
+; Returns the pool offset of the given string, adding it to the pool only if
+; an equal string is not there already. NULL strings map to NO_STRING.
+;-----------------------------------------------------------------------------*/
+int mdcExhibitCatalog::internString( const char * str ) {
+	unsigned int   slot;
+	int            len;
+	int            offset;
+
+	if ( str == NULL ) {
+		return NO_STRING;
+	}
+
+	if ( ( numStrings + 1 ) * 2 > stringTableSize ) {
+		growStringTable();
+	}
+
+	slot = hashString( str ) & ( stringTableSize - 1 );
+
+	while ( stringTable[ slot ] != NO_STRING ) {
+		if ( strcmp( strings + stringTable[ slot ], str ) == 0 ) {
+			return stringTable[ slot ];
+		}
+		slot = ( slot + 1 ) & ( stringTableSize - 1 );
+	}
+
+	len = strlen( str ) + 1;
+
+	if ( stringsSize + len > stringsCapacity ) {
+		if ( stringsCapacity == 0 ) {
+			stringsCapacity = INITIAL_STRINGS;
+		}
+		while ( stringsSize + len > stringsCapacity ) {
+			stringsCapacity *= 2;
+		}
+		strings = ( char * )realloc( strings, stringsCapacity );
+	}
+
+	offset = stringsSize;
+	memcpy( strings + offset, str, len );
+	stringsSize += len;
+
+	stringTable[ slot ] = offset;
+	numStrings++;
+
+	return offset;
+}
+
+void mdcExhibitCatalog::growStringTable() {
+	int   *        oldTable = stringTable;
+	int            oldSize  = stringTableSize;
+	unsigned int   slot;
+
+	stringTableSize = oldSize == 0 ? INITIAL_TABLE : oldSize * 2;
+	stringTable     = ( int * )malloc( sizeof( int ) * stringTableSize );
+
+	for ( int i = 0; i < stringTableSize; i++ ) {
+		stringTable[ i ] = NO_STRING;
+	}
+
+	for ( int i = 0; i < oldSize; i++ ) {
+		if ( oldTable[ i ] != NO_STRING ) {
+			slot = hashString( strings + oldTable[ i ] ) & ( stringTableSize - 1 );
+			while ( stringTable[ slot ] != NO_STRING ) {
+				slot = ( slot + 1 ) & ( stringTableSize - 1 );
+			}
+			stringTable[ slot ] = oldTable[ i ];
+		}
+	}
+
+	free( oldTable );
+}
+
+const char * mdcExhibitCatalog::getString( int offset ) const {
+	return offset == NO_STRING ? NULL : strings + offset;
+}
+
+// FNV-1a.
+static unsigned int hashString( const char * str ) {
+	unsigned int h = 2166136261u;
+
+	while ( *str ) {
+		h ^= ( unsigned char )*str++;
+		h *= 16777619u;
+	}
+
+	return h;
+}
+
+// Integer finalizer from MurmurHash3, ids are usually consecutive.
+static unsigned int hashInt( int key ) {
+	unsigned int h = ( unsigned int )key;
+
+	h ^= h >> 16;
+	h *= 0x85ebca6bu;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35u;
+	h ^= h >> 16;
+
+	return h;
+}
@@ -0,0 +1,98 @@
+/*------------------------------------------------------------------------------
+; File:          ExhibitCatalog.hpp
+; Description:   Declaration of the in-memory exhibit catalog class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#ifndef EXHIBITCATALOG_H
+#define EXHIBITCATALOG_H
+
+#include "definitions.hpp"
+
+#define NO_STRING -1
+
+/*------------------------------------------------------------------------------
+; A read-only copy of the exhibits table. Every column is stored in its own
+; array indexed by row, strings are interned in a single pool and rows are
+; found by id through an open addressing hash table. Rows must be added in
+; ascending id order.
+;-----------------------------------------------------------------------------*/
+class mdcExhibitCatalog {
+	public:
+		mdcExhibitCatalog();
+		~mdcExhibitCatalog();
+
+		// Building.
+		void                      clear();
+		void                      addExhibit( int, const char *, const char *, const char *, const char *,
+		                                      const vec3_t &, const vec3_t &, const vec3_t &, float );
+		void                      buildIndex();
+
+		// Lookup.
+		int                       getNumOfExhibits()                const;
+		int                       getIndexById( int )               const;
+		int                       getFirstIndexAfterId( int )       const;
+
+		// Row getters. The strings belong to the catalog and are NULL when the
+		// column was NULL in the database.
+		int                       getIdByIndex( int )               const;
+		const char           *    getTitleByIndex( int )            const;
+		const char           *    getDescriptionByIndex( int )      const;
+		const char           *    getModelPathByIndex( int )        const;
+		const char           *    getPhotoPathByIndex( int )        const;
+		const vec3_t         &    getTranslationByIndex( int )      const;
+		const vec3_t         &    getRotationByIndex( int )         const;
+		const vec3_t         &    getScalingByIndex( int )          const;
+		float                     getRotationAmountByIndex( int )   const;
+
+	private:
+		int                       count;
+		int                       capacity;
+
+		// One array per column.
+		int                  *    ids;
+		int                  *    titles;
+		int                  *    descriptions;
+		int                  *    modelPaths;
+		int                  *    photoPaths;
+		vec3_t               *    translations;
+		vec3_t               *    rotations;
+		vec3_t               *    scalings;
+		float                *    rotationAmounts;
+
+		// Interned string pool and its lookup table of pool offsets.
+		char                 *    strings;
+		int                       stringsSize;
+		int                       stringsCapacity;
+		int                  *    stringTable;
+		int                       stringTableSize;
+		int                       numStrings;
+
+		// id -> row table, holds row + 1 so that zero marks an empty slot.
+		int                  *    idTable;
+		int                       idTableSize;
+
+		mdcExhibitCatalog( mdcExhibitCatalog const & ) { };
+		mdcExhibitCatalog & operator=( mdcExhibitCatalog const & ) { return *this; }
+
+		int                       internString( const char * );
+		void                      growStringTable();
+		const char           *    getString( int )                  const;
+};
+
+#endif // EXHIBITCATALOG_H
@@ -24,6 +24,7 @@
 
 #include "SettingsMdl.hpp"
 #include "ExhibitDlg.hpp"
+#include "Trace.hpp"
 
 #define WIN_W 600
 #define WIN_H 400
@@ -55,11 +56,11 @@ int mdcExhibitDlg::w = -1;
 int mdcExhibitDlg::h = -1;
 
 mdcExhibitDlg::mdcExhibitDlg( gui::IGUIEnvironment * gui, video::IVideoDriver * driver, int exId ) {
-	stringw               title, desc, photo;
+	stringw               title, desc;
 	mdcSettingsMdl   *    settings = mdcSettingsMdl::getInstance();
-	char             *    exhibitTitle;
-	char             *    exhibitDesc;
-	char             *    photoPath;
+	const char       *    exhibitTitle;
+	const char       *    exhibitDesc;
+	const char       *    photoPath;
 	gui::IGUIImage   *    img;
 
 	if ( w == -1 && h == -1) {
@@ -77,19 +78,18 @@ mdcExhibitDlg::mdcExhibitDlg( gui::IGUIEnvironment * gui, video::IVideoDriver *
 
 	model = mdcExhibitMdl::getInstance();
 
-	model->getExhibitTitleById( &exhibitTitle, exId );
-	model->getExhibitDescriptionById( &exhibitDesc, exId );
+	// These strings belong to the model, they must not be freed.
+	exhibitTitle = model->getExhibitTitleViewById( exId );
+	exhibitDesc  = model->getExhibitDescriptionViewById( exId );
 
 	if ( exhibitTitle != NULL ) {
 		title = exhibitTitle;
-		free( exhibitTitle );
 	} else {
 		title = DEF_TITLE;
 	}
 
 	if ( exhibitDesc != NULL ) {
 		desc = exhibitDesc;
-		free( exhibitDesc );
 	} else {
 		desc = DEF_DESCR;
 	}
@@ -107,12 +107,11 @@ mdcExhibitDlg::mdcExhibitDlg( gui::IGUIEnvironment * gui, video::IVideoDriver *
 
 	img = gui->addImage( core::rect<s32>( 25, 40, 240, WIN_H - 25 ), win, -1 );
 
-	model->getExhibitPhotoPathById( &photoPath, exId );
+	photoPath = model->getExhibitPhotoPathViewById( exId );
 
 	if ( photoPath != NULL ) {
-		photo = photoPath;
-		free( photoPath );
-		img->setImage( driver->getTexture( photo.c_str() ) );
+		TRACE_SCOPE_ARG( "getTexture", photoPath );
+		img->setImage( driver->getTexture( photoPath ) );
 	}
 }
 
@@ -23,10 +23,13 @@
 #include <cstdlib>
 #include <cstring>
 #include <cassert>
+#include <climits>
 
 #include <sqlite/sqlite3.h>
 
 #include "ExhibitMdl.hpp"
+#include "ExhibitCatalog.hpp"
+#include "Trace.hpp"
 
 using std::cout;
 using std::cerr;
@@ -34,6 +37,31 @@ using std::endl;
 
 void swap( int &, int & );
 
+// Query text for each entry of exhibitStmt_t, in the same order.
+static const char * STATEMENTS[ STMT_COUNT ] = {
+  "SELECT COUNT(*) FROM exhibits",
+  "SELECT id FROM exhibits ORDER BY id LIMIT ?",
+  "SELECT id FROM exhibits ORDER BY id LIMIT ? OFFSET ?",
+  "SELECT id FROM exhibits WHERE id > ? ORDER BY id LIMIT ?",
+  "SELECT id, model_path, translation_x, translation_y, translation_z, "
+  "rotation_x, rotation_y, rotation_z, scaling_x, scaling_y, scaling_z, "
+  "rotation_amout FROM exhibits ORDER BY id",
+  "SELECT id, model_path, translation_x, translation_y, translation_z, "
+  "rotation_x, rotation_y, rotation_z, scaling_x, scaling_y, scaling_z, "
+  "rotation_amout FROM exhibits WHERE id > ? ORDER BY id LIMIT ?",
+  "SELECT id, title, description, model_path, photo_path, translation_x, translation_y, translation_z, "
+  "rotation_x, rotation_y, rotation_z, scaling_x, scaling_y, scaling_z, "
+  "rotation_amout FROM exhibits ORDER BY id",
+  "SELECT title FROM exhibits WHERE id = ?",
+  "SELECT description FROM exhibits WHERE id = ?",
+  "SELECT model_path FROM exhibits WHERE id = ?",
+  "SELECT photo_path FROM exhibits WHERE id = ?",
+  "SELECT translation_x, translation_y, translation_z FROM exhibits WHERE id = ?",
+  "SELECT rotation_x, rotation_y, rotation_z FROM exhibits WHERE id = ?",
+  "SELECT rotation_amout FROM exhibits WHERE id = ?",
+  "SELECT scaling_x, scaling_y, scaling_z FROM exhibits WHERE id = ?"
+};
+
 mdcExhibitMdl * mdcExhibitMdl::instance = NULL;
 
 mdcExhibitMdl * mdcExhibitMdl::getInstance() {
@@ -51,17 +79,27 @@ void mdcExhibitMdl::freeInstance() {
       instance->releaseDatabase();
 
       delete instance;
+      instance = NULL;
     }
   }
 }
 
-mdcExhibitMdl::mdcExhibitMdl(): db(NULL), refs(0) { }
+mdcExhibitMdl::mdcExhibitMdl(): db(NULL), catalog(NULL), refs(0), dbUsable(false) {
+  for ( int i = 0; i < STMT_COUNT; i++ ) {
+    stmts[ i ] = NULL;
+  }
+}
 
 mdcExhibitMdl::~mdcExhibitMdl() { }
 
 bool mdcExhibitMdl::setDatabaseFile( const char * file ){
   int rc;
 
+  TRACE_SCOPE_ARG( "mdcExhibitMdl::setDatabaseFile", file );
+
+  // Only one database can be open at a time.
+  releaseDatabase();
+
   rc = sqlite3_open_v2( file, &db, SQLITE_OPEN_READONLY, NULL );
 
   if ( rc != SQLITE_OK ) {
@@ -69,7 +107,12 @@ bool mdcExhibitMdl::setDatabaseFile( const char * file ){
     sqlite3_close(db);
     db = NULL;
     dbUsable = false;
-  }else{
+  } else if ( !prepareStatements() ) {
+    finalizeStatements();
+    sqlite3_close(db);
+    db = NULL;
+    dbUsable = false;
+  } else {
     dbUsable = true;
   }
 
@@ -78,6 +121,9 @@ bool mdcExhibitMdl::setDatabaseFile( const char * file ){
 
 bool mdcExhibitMdl::releaseDatabase() {
   if ( dbUsable ) {
+    delete catalog;
+    catalog = NULL;
+    finalizeStatements();
     sqlite3_close(db);
     db = NULL;
     dbUsable = false;
@@ -87,37 +133,295 @@ bool mdcExhibitMdl::releaseDatabase() {
   return false;
 }
 
+/*------------------------------------------------------------------------------
+; mdcExhibitMdl::preloadCatalog()
+;
+; Copies the whole exhibits table into an mdcExhibitCatalog. Once loaded every
+; getter is served from memory until the database is released. The database
+; is opened read-only so the copy can never go stale.
+;-----------------------------------------------------------------------------*/
+bool mdcExhibitMdl::preloadCatalog() {
+  sqlite3_stmt   *   ppStmt;
+  int                rc;
+  vec3_t             t, r, s;
+
+  if ( !dbUsable ) {
+    cerr << "mdcExhibitMdl::preloadCatalog() - Database is unusable." << endl;
+    return false;
+  }
+
+  if ( catalog != NULL ) {
+    return true;
+  }
+
+  TRACE_SCOPE_ARG( "sql", "preloadCatalog" );
+
+  ppStmt = getStatement( STMT_CATALOG, "preloadCatalog" );
+
+  if ( ppStmt == NULL ) {
+    return false;
+  }
+
+  catalog = new mdcExhibitCatalog();
+
+  while( ( rc = sqlite3_step( ppStmt ) ) == SQLITE_ROW ) {
+    t.x = ( float )sqlite3_column_double( ppStmt, 5 );
+    t.y = ( float )sqlite3_column_double( ppStmt, 6 );
+    t.z = ( float )sqlite3_column_double( ppStmt, 7 );
+    r.x = ( float )sqlite3_column_double( ppStmt, 8 );
+    r.y = ( float )sqlite3_column_double( ppStmt, 9 );
+    r.z = ( float )sqlite3_column_double( ppStmt, 10 );
+    s.x = ( float )sqlite3_column_double( ppStmt, 11 );
+    s.y = ( float )sqlite3_column_double( ppStmt, 12 );
+    s.z = ( float )sqlite3_column_double( ppStmt, 13 );
+
+    catalog->addExhibit( sqlite3_column_int( ppStmt, 0 ),
+                         reinterpret_cast< const char * >( sqlite3_column_text( ppStmt, 1 ) ),
+                         reinterpret_cast< const char * >( sqlite3_column_text( ppStmt, 2 ) ),
+                         reinterpret_cast< const char * >( sqlite3_column_text( ppStmt, 3 ) ),
+                         reinterpret_cast< const char * >( sqlite3_column_text( ppStmt, 4 ) ),
+                         t, r, s,
+                         ( float )sqlite3_column_double( ppStmt, 14 ) );
+  }
+
+  sqlite3_reset( ppStmt );
+
+  if ( rc != SQLITE_DONE ) {
+    cerr << "mdcExhibitMdl::preloadCatalog() - Error processing query: " << sqlite3_errmsg( db ) << endl;
+    delete catalog;
+    catalog = NULL;
+    return false;
+  }
+
+  catalog->buildIndex();
+
+  return true;
+}
+
+bool mdcExhibitMdl::isCatalogLoaded() const {
+  return catalog != NULL;
+}
+
+/*------------------------------------------------------------------------------
+; mdcExhibitMdl::prepareStatements()
+;
+; Compiles every query in STATEMENTS so the getters only need to bind and step.
+;-----------------------------------------------------------------------------*/
+bool mdcExhibitMdl::prepareStatements() {
+  int rc;
+
+  TRACE_SCOPE( "mdcExhibitMdl::prepareStatements" );
+
+  for ( int i = 0; i < STMT_COUNT; i++ ) {
+    rc = sqlite3_prepare_v2( db, STATEMENTS[ i ], -1, &stmts[ i ], NULL );
+
+    if ( rc != SQLITE_OK ) {
+      cerr << "mdcExhibitMdl::prepareStatements() - Failed to prepare query \"" << STATEMENTS[ i ] << "\": " << sqlite3_errmsg( db ) << endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void mdcExhibitMdl::finalizeStatements() {
+  for ( int i = 0; i < STMT_COUNT; i++ ) {
+    sqlite3_finalize( stmts[ i ] );
+    stmts[ i ] = NULL;
+  }
+}
+
+/*------------------------------------------------------------------------------
+; mdcExhibitMdl::getStatement()
+;
+; Returns the cached statement ready to be stepped from the first row, or NULL
+; on error. The caller name is only used for error messages.
+;-----------------------------------------------------------------------------*/
+sqlite3_stmt * mdcExhibitMdl::getStatement( exhibitStmt_t which, const char * caller ) {
+  sqlite3_stmt * ppStmt = stmts[ which ];
+
+  if ( sqlite3_reset( ppStmt ) != SQLITE_OK || sqlite3_clear_bindings( ppStmt ) != SQLITE_OK ) {
+    cerr << "mdcExhibitMdl::" << caller << "() - Failed to reset query: " << sqlite3_errmsg( db ) << endl;
+    return NULL;
+  }
+
+  return ppStmt;
+}
+
+sqlite3_stmt * mdcExhibitMdl::getStatementById( exhibitStmt_t which, int id, const char * caller ) {
+  sqlite3_stmt * ppStmt = getStatement( which, caller );
+
+  if ( ppStmt != NULL && sqlite3_bind_int( ppStmt, 1, id ) != SQLITE_OK ) {
+    cerr << "mdcExhibitMdl::" << caller << "() - Failed to bind parameters for query: " << sqlite3_errmsg( db ) << endl;
+    return NULL;
+  }
+
+  return ppStmt;
+}
+
+/*------------------------------------------------------------------------------
+; mdcExhibitMdl::getTextById()
+;
+; Copies the single text column returned by a cached statement into a malloc'ed
+; string. Sets *text to NULL when the exhibit or the column does not exist.
+;-----------------------------------------------------------------------------*/
+void mdcExhibitMdl::getTextById( exhibitStmt_t which, char ** text, int id, const char * caller ) {
+  sqlite3_stmt *   ppStmt;
+  const char   *   value;
+  int              rc;
+
+  *text = NULL;
+
+  if ( catalog != NULL ) {
+    value = getCatalogText( which, id );
+
+    if ( value != NULL ) {
+      *text = ( char * )malloc( sizeof( char ) * strlen( value ) + 1 );
+      strcpy( *text, value );
+    }
+    return;
+  }
+
+  if ( !dbUsable ) {
+    cerr << "mdcExhibitMdl::" << caller << "() - Database is unusable." << endl;
+    return;
+  }
+
+  TRACE_SCOPE_ARG( "sql", caller );
+
+  ppStmt = getStatementById( which, id, caller );
+
+  if ( ppStmt == NULL ) {
+    return;
+  }
+
+  rc = sqlite3_step( ppStmt );
+
+  if ( rc == SQLITE_ROW ) {
+    value = reinterpret_cast< const char * >( sqlite3_column_text( ppStmt, 0 ) );
+
+    if ( value != NULL ) {
+      *text = ( char * )malloc( sizeof( char ) * strlen( value ) + 1 );
+      strcpy( *text, value );
+    }
+
+  } else if ( rc != SQLITE_DONE ) {
+    cerr << "mdcExhibitMdl::" << caller << "() - Failed to get an exhibit from the database: " << sqlite3_errmsg( db ) << endl;
+  }
+
+  sqlite3_reset( ppStmt );
+}
+
+/*------------------------------------------------------------------------------
+; mdcExhibitMdl::getCatalogText()
+;
+; Returns the catalog string that the given text statement would have read,
+; or NULL if there is no such exhibit or the column is NULL.
+;-----------------------------------------------------------------------------*/
+const char * mdcExhibitMdl::getCatalogText( exhibitStmt_t which, int id ) const {
+  int i = catalog->getIndexById( id );
+
+  if ( i < 0 ) {
+    return NULL;
+  }
+
+  switch ( which ) {
+    case STMT_TITLE:       return catalog->getTitleByIndex( i );
+    case STMT_DESCRIPTION: return catalog->getDescriptionByIndex( i );
+    case STMT_MODEL_PATH:  return catalog->getModelPathByIndex( i );
+    case STMT_PHOTO_PATH:  return catalog->getPhotoPathByIndex( i );
+    default:               assert( 0 ); break;
+  }
+
+  return NULL;
+}
+
+/*------------------------------------------------------------------------------
+; mdcExhibitMdl::getVectorById()
+;
+; Reads the three real columns returned by a cached statement. All components
+; are set to BAD_VALUE on error or when the exhibit does not exist.
+;-----------------------------------------------------------------------------*/
+void mdcExhibitMdl::getVectorById( exhibitStmt_t which, vec3_t & vec, int id, const char * caller ) {
+  sqlite3_stmt *   ppStmt;
+  int              rc;
+  int              i;
+
+  vec.x = BAD_VALUE;
+  vec.y = BAD_VALUE;
+  vec.z = BAD_VALUE;
+
+  if ( catalog != NULL ) {
+    i = catalog->getIndexById( id );
+
+    if ( i >= 0 ) {
+      switch ( which ) {
+        case STMT_TRANSLATION: vec = catalog->getTranslationByIndex( i ); break;
+        case STMT_ROTATION:    vec = catalog->getRotationByIndex( i );    break;
+        case STMT_SCALING:     vec = catalog->getScalingByIndex( i );     break;
+        default:               assert( 0 );                              break;
+      }
+    }
+    return;
+  }
+
+  if ( !dbUsable ) {
+    cerr << "mdcExhibitMdl::" << caller << "() - Database is unusable." << endl;
+    return;
+  }
+
+  TRACE_SCOPE_ARG( "sql", caller );
+
+  ppStmt = getStatementById( which, id, caller );
+
+  if ( ppStmt == NULL ) {
+    return;
+  }
+
+  rc = sqlite3_step( ppStmt );
+
+  if ( rc == SQLITE_ROW ) {
+    vec.x = ( float )sqlite3_column_double( ppStmt, 0 );
+    vec.y = ( float )sqlite3_column_double( ppStmt, 1 );
+    vec.z = ( float )sqlite3_column_double( ppStmt, 2 );
+
+  } else if ( rc != SQLITE_DONE ) {
+    cerr << "mdcExhibitMdl::" << caller << "() - Failed to get an exhibit from the database: " << sqlite3_errmsg( db ) << endl;
+  }
+
+  sqlite3_reset( ppStmt );
+}
+
 // Different methods to get row ids.
 int mdcExhibitMdl::getNumOfExhibits() {
-  const char   *   query = "SELECT id FROM exhibits";
   sqlite3_stmt *   ppStmt;
   int              rc;
-  int              i = 0;
+  int              n = BAD_VALUE;
+
+  if ( catalog != NULL ) {
+    return catalog->getNumOfExhibits();
+  }
 
   if ( dbUsable ) {
-    rc = sqlite3_prepare_v2( db, query, 24, &ppStmt, NULL);
+    TRACE_SCOPE_ARG( "sql", "getNumOfExhibits" );
 
-    if ( rc != SQLITE_OK ) {
-      cerr << "mdcExhibitMdl::getNumOfExhibits() - Failed to prepare query: " << sqlite3_errmsg( db ) << endl;
+    ppStmt = getStatement( STMT_NUM_EXHIBITS, "getNumOfExhibits" );
+
+    if ( ppStmt == NULL ) {
       return BAD_VALUE;
     }
 
-    while( ( rc = sqlite3_step( ppStmt ) ) == SQLITE_ROW ){
-      i++;
-    }
+    rc = sqlite3_step( ppStmt );
 
-    if ( rc != SQLITE_DONE ) {
+    if ( rc == SQLITE_ROW ) {
+      n = sqlite3_column_int( ppStmt, 0 );
+    } else {
       cerr << "mdcExhibitMdl::getNumOfExhibits() - Error processing query: " << sqlite3_errmsg( db ) << endl;
     }
 
-    rc = sqlite3_finalize( ppStmt );
+    sqlite3_reset( ppStmt );
 
-    if ( rc != SQLITE_OK ) {
-      cerr << "mdcExhibitMdl::getNumOfExhibits() - Error finalizing query: " << sqlite3_errmsg( db ) << endl;
-      return BAD_VALUE;
-    }
-
-    return i;
+    return n;
 
   }else{
     cerr << "mdcExhibitMdl::getNumOfExhibits() - Database is unusable." << endl;
@@ -127,37 +431,26 @@ int mdcExhibitMdl::getNumOfExhibits() {
 }
 
 int mdcExhibitMdl::getFirstNExhibitIds( int * exhibits, int n ) {
-  const char   *   query = "SELECT id FROM exhibits";
   sqlite3_stmt *   ppStmt;
-  int              rc;
   int              i = 0;
 
   if ( dbUsable ) {
     if ( n > 0 ) {
-      rc = sqlite3_prepare_v2( db, query, 24, &ppStmt, NULL);
-
-      if ( rc != SQLITE_OK ) {
-	cerr << "mdcExhibitMdl::getFirstNExhibitIds() - Failed to prepare query: " << sqlite3_errmsg( db ) << endl;
-	return BAD_VALUE;
+      if ( catalog != NULL ) {
+        for ( ; i < n && i < catalog->getNumOfExhibits(); i++ ) {
+          exhibits[ i ] = catalog->getIdByIndex( i );
+        }
+        return i;
       }
 
-      while( ( rc = sqlite3_step( ppStmt ) ) == SQLITE_ROW && i < n ){
-	exhibits[i] = sqlite3_column_int( ppStmt, 0 );
-	i++;
-      }
+      ppStmt = getStatement( STMT_FIRST_IDS, "getFirstNExhibitIds" );
 
-      if ( i != n && rc != SQLITE_DONE ) {
-	cerr << "mdcExhibitMdl::getFirstNExhibitIds() - Error processing query: " << sqlite3_errmsg( db ) << endl;
-      }
-
-      rc = sqlite3_finalize( ppStmt );
-
-      if ( rc != SQLITE_OK ) {
-	cerr << "mdcExhibitMdl::getFirstNExhibitIds() - Error finalizing query: " << sqlite3_errmsg( db ) << endl;
+      if ( ppStmt == NULL || sqlite3_bind_int( ppStmt, 1, n ) != SQLITE_OK ) {
+	cerr << "mdcExhibitMdl::getFirstNExhibitIds() - Failed to prepare query: " << sqlite3_errmsg( db ) << endl;
 	return BAD_VALUE;
       }
 
-      return i;
+      return readIds( ppStmt, exhibits, "getFirstNExhibitIds" );
 
     } else {
       cerr << "mdcExhibitMdl::getFirstExhibitIds() - Received a negative number or zero as parameter." << endl;
@@ -169,10 +462,15 @@ int mdcExhibitMdl::getFirstNExhibitIds( int * exhibits, int n ) {
   }
 }
 
+/*------------------------------------------------------------------------------
+; mdcExhibitMdl::getExhibitsIdsRange()
+;
+; Gets the ids of the exhibits in positions n1 to n2, both inclusive, with the
+; exhibits ordered by id. The range is skipped by SQLite itself, but OFFSET is
+; still linear in n1; use a cursor to walk the whole table page by page.
+;-----------------------------------------------------------------------------*/
 int mdcExhibitMdl::getExhibitsIdsRange( int * exhibits, int n1, int n2 ) {
-  const char   *   query = "SELECT id FROM exhibits";
   sqlite3_stmt *   ppStmt;
-  int              rc;
   int              i = 0;
   int              j = 0;
   int              a = n1;
@@ -188,32 +486,23 @@ int mdcExhibitMdl::getExhibitsIdsRange( int * exhibits, int n1, int n2 ) {
       swap(a, b);
     }
 
-    rc = sqlite3_prepare_v2( db, query, 24, &ppStmt, NULL);
-
-    if ( rc != SQLITE_OK ) {
-      cerr << "mdcExhibitMdl::getExhibitsIdsRange() - Failed to prepare query: " << sqlite3_errmsg( db ) << endl;
-      return BAD_VALUE;
-    }
-
-    while( ( rc = sqlite3_step( ppStmt ) ) == SQLITE_ROW && i <= b ){
-      if ( i >= a ) {
-	exhibits[j++] = sqlite3_column_int( ppStmt, 0 );
+    if ( catalog != NULL ) {
+      for ( i = a; i <= b && i < catalog->getNumOfExhibits(); i++ ) {
+        exhibits[ j++ ] = catalog->getIdByIndex( i );
       }
-      i++;
-    }
-
-    if ( i != b + 1 && rc != SQLITE_DONE ) {
-      cerr << "mdcExhibitMdl::getExhibitsIdsRange() - Error processing query: " << sqlite3_errmsg( db ) << endl;
+      return j;
     }
 
-    rc = sqlite3_finalize( ppStmt );
+    ppStmt = getStatement( STMT_IDS_RANGE, "getExhibitsIdsRange" );
 
-    if ( rc != SQLITE_OK ) {
-      cerr << "mdcExhibitMdl::getExhibitsIdsRange() - Error finalizing query: " << sqlite3_errmsg( db ) << endl;
+    if ( ppStmt == NULL ||
+         sqlite3_bind_int( ppStmt, 1, b - a + 1 ) != SQLITE_OK ||
+         sqlite3_bind_int( ppStmt, 2, a ) != SQLITE_OK ) {
+      cerr << "mdcExhibitMdl::getExhibitsIdsRange() - Failed to prepare query: " << sqlite3_errmsg( db ) << endl;
       return BAD_VALUE;
     }
 
-    return j;
+    return readIds( ppStmt, exhibits, "getExhibitsIdsRange" );
 
   } else {
     cerr << "mdcExhibitMdl::getExhibitsIdsRange() - Database is unusable." << endl;
@@ -221,333 +510,399 @@ int mdcExhibitMdl::getExhibitsIdsRange( int * exhibits, int n1, int n2 ) {
   }
 }
 
-// Text getters.
-void mdcExhibitMdl::getExhibitTitleById( char ** title, int id ) {
-  const char   *   query = "SELECT title FROM exhibits WHERE id = ?";
-  sqlite3_stmt *   ppStmt;
-  int              rc;
+// Cursor methods.
 
-  if ( dbUsable ) {
+/*------------------------------------------------------------------------------
+; mdcExhibitMdl::openExhibitCursor()
+;
+; Positions a cursor before the exhibit with the lowest id.
+;-----------------------------------------------------------------------------*/
+void mdcExhibitMdl::openExhibitCursor( exhibitCursor_t & cursor ) const {
+  cursor.lastId = INT_MIN;
+  cursor.done   = false;
+}
 
-    rc = sqlite3_prepare_v2( db, query, 40, &ppStmt, NULL);
+/*------------------------------------------------------------------------------
+; mdcExhibitMdl::getNextExhibitIds()
+;
+; Gets up to n ids following the cursor and advances it. Every page is a
+; single indexed range scan on the primary key, so walking the whole table
+; costs the same no matter the page size. Returns the number of ids read,
+; zero once the cursor is exhausted, or BAD_VALUE on error.
+;-----------------------------------------------------------------------------*/
+int mdcExhibitMdl::getNextExhibitIds( exhibitCursor_t & cursor, int * exhibits, int n ) {
+  sqlite3_stmt *   ppStmt;
+  int              first;
+  int              i = 0;
 
-    if ( rc != SQLITE_OK ) {
-      cerr << "mdcExhibitMdl::getExhibitTitleById() - Failed to prepare query: " << sqlite3_errmsg( db ) << endl;
-      sqlite3_finalize( ppStmt );
-      *title = NULL;
-      return;
-    }
+  if ( n <= 0 ) {
+    cerr << "mdcExhibitMdl::getNextExhibitIds() - Received a negative number or zero as parameter." << endl;
+    return BAD_VALUE;
+  }
 
-    rc = sqlite3_bind_int( ppStmt, 1, id );
+  if ( cursor.done ) {
+    return 0;
+  }
 
-    if ( rc != SQLITE_OK ) {
-      cerr << "mdcExhibitMdl::getExhibitTitleById() - Failed to bind parameters for query: " << sqlite3_errmsg( db ) << endl;
-      sqlite3_finalize( ppStmt );
-      *title = NULL;
-      return;
+  if ( catalog != NULL ) {
+    first = catalog->getFirstIndexAfterId( cursor.lastId );
+    for ( ; i < n && first + i < catalog->getNumOfExhibits(); i++ ) {
+      exhibits[ i ] = catalog->getIdByIndex( first + i );
     }
 
-    rc = sqlite3_step( ppStmt );
+  } else if ( dbUsable ) {
+    ppStmt = getStatement( STMT_IDS_AFTER, "getNextExhibitIds" );
 
-    if ( rc != SQLITE_ROW && rc != SQLITE_DONE ) {
-    	cerr << "mdcExhibitMdl::getExhibitTitleById() - Failed to get an exhibit from the database: " << sqlite3_errmsg( db ) << endl;
-    	*title = NULL;
-    	return;
+    if ( ppStmt == NULL ||
+         sqlite3_bind_int( ppStmt, 1, cursor.lastId ) != SQLITE_OK ||
+         sqlite3_bind_int( ppStmt, 2, n ) != SQLITE_OK ) {
+      cerr << "mdcExhibitMdl::getNextExhibitIds() - Failed to prepare query: " << sqlite3_errmsg( db ) << endl;
+      return BAD_VALUE;
     }
 
-    *title = ( char * )malloc( sizeof( char ) * strlen( reinterpret_cast< const char * >( sqlite3_column_text( ppStmt, 0 ) ) ) + 1 );
-    strcpy( *title, reinterpret_cast< const char * >( sqlite3_column_text( ppStmt, 0 ) ) );
+    i = readIds( ppStmt, exhibits, "getNextExhibitIds" );
 
-    rc = sqlite3_finalize( ppStmt );
-
-    if ( rc != SQLITE_OK ) {
-      cerr << "mdcExhibitMdl::getExhibitTitleById() - Error finalizing query: " << sqlite3_errmsg( db ) << endl;
+    if ( i == BAD_VALUE ) {
+      return BAD_VALUE;
     }
 
   } else {
-    cerr << "mdcExhibitMdl::getExhibitTitleById() - Database is unusable." << endl;
+    cerr << "mdcExhibitMdl::getNextExhibitIds() - Database is unusable." << endl;
+    return BAD_VALUE;
+  }
+
+  if ( i > 0 ) {
+    cursor.lastId = exhibits[ i - 1 ];
   }
+  cursor.done = i < n;
+
+  return i;
 }
 
-void mdcExhibitMdl::getExhibitDescriptionById( char ** desc, int id ) {
-  const char   *   query = "SELECT description FROM exhibits WHERE id = ?";
+/*------------------------------------------------------------------------------
+; mdcExhibitMdl::getNextExhibitRecords()
+;
+; Same as getNextExhibitIds() but reads whole placement records, returned in
+; the same kind of block as getExhibitRecords().
+;-----------------------------------------------------------------------------*/
+int mdcExhibitMdl::getNextExhibitRecords( exhibitCursor_t & cursor, exhibitRecord_t ** records, int n ) {
   sqlite3_stmt *   ppStmt;
-  int              rc;
-
-  if ( dbUsable ) {
+  int              first;
+  int              i;
 
-    rc = sqlite3_prepare_v2( db, query, 46, &ppStmt, NULL);
+  *records = NULL;
 
-    if ( rc != SQLITE_OK ) {
-      cerr << "mdcExhibitMdl::getExhibitDescriptionById() - Failed to prepare query: " << sqlite3_errmsg( db ) << endl;
-      sqlite3_finalize( ppStmt );
-      *desc = NULL;
-      return;
-    }
+  if ( n <= 0 ) {
+    cerr << "mdcExhibitMdl::getNextExhibitRecords() - Received a negative number or zero as parameter." << endl;
+    return BAD_VALUE;
+  }
 
-    rc = sqlite3_bind_int( ppStmt, 1, id );
+  if ( cursor.done ) {
+    return 0;
+  }
 
-    if ( rc != SQLITE_OK ) {
-      cerr << "mdcExhibitMdl::getExhibitDescriptionById() - Failed to bind parameters for query: " << sqlite3_errmsg( db ) << endl;
-      sqlite3_finalize( ppStmt );
-      *desc = NULL;
-      return;
-    }
+  if ( catalog != NULL ) {
+    first = catalog->getFirstIndexAfterId( cursor.lastId );
+    i = catalog->getNumOfExhibits() - first;
+    i = getCatalogRecords( records, first, i < n ? i : n );
 
-    rc = sqlite3_step( ppStmt );
+  } else if ( dbUsable ) {
+    ppStmt = getStatement( STMT_RECORDS_AFTER, "getNextExhibitRecords" );
 
-    if ( rc != SQLITE_ROW && rc != SQLITE_DONE ) {
-    	cerr << "mdcExhibitMdl::getExhibitDescriptionById() - Failed to get an exhibit from the database: " << sqlite3_errmsg( db ) << endl;
-    	*desc = NULL;
-    	return;
+    if ( ppStmt == NULL ||
+         sqlite3_bind_int( ppStmt, 1, cursor.lastId ) != SQLITE_OK ||
+         sqlite3_bind_int( ppStmt, 2, n ) != SQLITE_OK ) {
+      cerr << "mdcExhibitMdl::getNextExhibitRecords() - Failed to prepare query: " << sqlite3_errmsg( db ) << endl;
+      return BAD_VALUE;
     }
 
-    *desc = ( char * )malloc( sizeof( char ) * strlen( reinterpret_cast< const char * >( sqlite3_column_text( ppStmt, 0 ) ) ) + 1 );
-    strcpy( *desc, reinterpret_cast< const char * >( sqlite3_column_text( ppStmt, 0 ) ) );
-
-    rc = sqlite3_finalize( ppStmt );
-
-    if ( rc != SQLITE_OK ) {
-      cerr << "mdcExhibitMdl::getExhibitDescriptionById() - Error finalizing query: " << sqlite3_errmsg( db ) << endl;
-    }
+    i = readRecords( ppStmt, records, "getNextExhibitRecords" );
 
   } else {
-    cerr << "mdcExhibitMdl::getExhibitDescriptionById() - Database is unusable." << endl;
+    cerr << "mdcExhibitMdl::getNextExhibitRecords() - Database is unusable." << endl;
+    return BAD_VALUE;
   }
-}
 
-void mdcExhibitMdl::getExhibitModelPathById( char ** path, int id ) {
-  const char   *   query = "SELECT model_path FROM exhibits WHERE id = ?";
-  sqlite3_stmt *   ppStmt;
-  int              rc;
+  if ( i > 0 ) {
+    cursor.lastId = ( *records )[ i - 1 ].id;
+  }
+  cursor.done = i < n;
 
-  if ( dbUsable ) {
+  return i;
+}
 
-    rc = sqlite3_prepare_v2( db, query, 45, &ppStmt, NULL);
+/*------------------------------------------------------------------------------
+; mdcExhibitMdl::readIds()
+;
+; Steps a statement whose first column is an exhibit id and stores every row.
+; The statement's LIMIT must not exceed the size of the output array.
+;-----------------------------------------------------------------------------*/
+int mdcExhibitMdl::readIds( sqlite3_stmt * ppStmt, int * exhibits, const char * caller ) {
+  int rc;
+  int i = 0;
 
-    if ( rc != SQLITE_OK ) {
-      cerr << "mdcExhibitMdl::getExhibitModelPathById() - Failed to prepare query: " << sqlite3_errmsg( db ) << endl;
-      sqlite3_finalize( ppStmt );
-      *path = NULL;
-      return;
-    }
+  TRACE_SCOPE_ARG( "sql", caller );
 
-    rc = sqlite3_bind_int( ppStmt, 1, id );
+  while( ( rc = sqlite3_step( ppStmt ) ) == SQLITE_ROW ) {
+    exhibits[ i++ ] = sqlite3_column_int( ppStmt, 0 );
+  }
 
-    if ( rc != SQLITE_OK ) {
-      cerr << "mdcExhibitMdl::getExhibitModelPathById() - Failed to bind parameters for query: " << sqlite3_errmsg( db ) << endl;
-      sqlite3_finalize( ppStmt );
-      *path = NULL;
-      return;
-    }
+  sqlite3_reset( ppStmt );
 
-    rc = sqlite3_step( ppStmt );
+  if ( rc != SQLITE_DONE ) {
+    cerr << "mdcExhibitMdl::" << caller << "() - Error processing query: " << sqlite3_errmsg( db ) << endl;
+    return BAD_VALUE;
+  }
 
-    if ( rc != SQLITE_ROW && rc != SQLITE_DONE ) {
+  return i;
+}
 
-    	cerr << rc << " mdcExhibitMdl::getExhibitModelPathById() - Failed to get an exhibit from the database: " << sqlite3_errmsg( db ) << endl;
-    	*path = NULL;
-    	return;
-    }
+// Bulk getters.
 
-    *path = ( char * )malloc( sizeof( char ) * strlen( reinterpret_cast< const char * >( sqlite3_column_text( ppStmt, 0 ) ) ) + 1 );
-    strcpy( *path, reinterpret_cast< const char * >( sqlite3_column_text( ppStmt, 0 ) ) );
+/*------------------------------------------------------------------------------
+; mdcExhibitMdl::getExhibitRecords()
+;
+; Reads the placement data of every exhibit with a single query. On success
+; *records points to a malloc'ed block holding the record array followed by
+; the model path strings, so a single free( *records ) releases everything.
+; Returns the number of records or BAD_VALUE on error.
+;-----------------------------------------------------------------------------*/
+int mdcExhibitMdl::getExhibitRecords( exhibitRecord_t ** records ) {
+  sqlite3_stmt    *   ppStmt;
 
-    rc = sqlite3_finalize( ppStmt );
+  *records = NULL;
 
-    if ( rc != SQLITE_OK ) {
-      cerr << "mdcExhibitMdl::getExhibitModelPathById() - Error finalizing query: " << sqlite3_errmsg( db ) << endl;
-    }
+  if ( catalog != NULL ) {
+    return getCatalogRecords( records, 0, catalog->getNumOfExhibits() );
+  }
 
-  } else {
-    cerr << "mdcExhibitMdl::getExhibitModelPathById() - Database is unusable." << endl;
+  if ( !dbUsable ) {
+    cerr << "mdcExhibitMdl::getExhibitRecords() - Database is unusable." << endl;
+    return BAD_VALUE;
   }
-}
 
-void mdcExhibitMdl::getExhibitPhotoPathById( char ** path, int id ) {
-  const char   *   query = "SELECT photo_path FROM exhibits WHERE id = ?";
-  sqlite3_stmt *   ppStmt;
-  int              rc;
+  ppStmt = getStatement( STMT_RECORDS, "getExhibitRecords" );
 
-  if ( dbUsable ) {
+  if ( ppStmt == NULL ) {
+    return BAD_VALUE;
+  }
 
-    rc = sqlite3_prepare_v2( db, query, 45, &ppStmt, NULL);
+  return readRecords( ppStmt, records, "getExhibitRecords" );
+}
 
-    if ( rc != SQLITE_OK ) {
-      cerr << "mdcExhibitMdl::getExhibitPhotoPathById() - Failed to prepare query: " << sqlite3_errmsg( db ) << endl;
-      sqlite3_finalize( ppStmt );
-      *path = NULL;
-      return;
+/*------------------------------------------------------------------------------
+; mdcExhibitMdl::readRecords()
+;
+; Steps a placement records statement and packs every row it returns into a
+; single malloc'ed block.
+;-----------------------------------------------------------------------------*/
+int mdcExhibitMdl::readRecords( sqlite3_stmt * ppStmt, exhibitRecord_t ** records, const char * caller ) {
+  int                 rc;
+  int                 n = 0;
+  int                 capacity = 64;
+  size_t              strSize = 0;
+  size_t              strCapacity = 1024;
+  size_t              len;
+  exhibitRecord_t *   recs;
+  size_t          *   pathOffsets;
+  char            *   strings;
+  char            *   block;
+  const char      *   text;
+
+  TRACE_SCOPE_ARG( "sql", caller );
+
+  recs        = ( exhibitRecord_t * )malloc( sizeof( exhibitRecord_t ) * capacity );
+  pathOffsets = ( size_t * )malloc( sizeof( size_t ) * capacity );
+  strings     = ( char * )malloc( strCapacity );
+
+  while( ( rc = sqlite3_step( ppStmt ) ) == SQLITE_ROW ) {
+    if ( n == capacity ) {
+      capacity *= 2;
+      recs        = ( exhibitRecord_t * )realloc( recs, sizeof( exhibitRecord_t ) * capacity );
+      pathOffsets = ( size_t * )realloc( pathOffsets, sizeof( size_t ) * capacity );
+    }
+
+    recs[ n ].id              = sqlite3_column_int( ppStmt, 0 );
+    recs[ n ].modelPath       = NULL;
+    recs[ n ].translation.x   = ( float )sqlite3_column_double( ppStmt, 2 );
+    recs[ n ].translation.y   = ( float )sqlite3_column_double( ppStmt, 3 );
+    recs[ n ].translation.z   = ( float )sqlite3_column_double( ppStmt, 4 );
+    recs[ n ].rotation.x      = ( float )sqlite3_column_double( ppStmt, 5 );
+    recs[ n ].rotation.y      = ( float )sqlite3_column_double( ppStmt, 6 );
+    recs[ n ].rotation.z      = ( float )sqlite3_column_double( ppStmt, 7 );
+    recs[ n ].scaling.x       = ( float )sqlite3_column_double( ppStmt, 8 );
+    recs[ n ].scaling.y       = ( float )sqlite3_column_double( ppStmt, 9 );
+    recs[ n ].scaling.z       = ( float )sqlite3_column_double( ppStmt, 10 );
+    recs[ n ].rotationAmount  = ( float )sqlite3_column_double( ppStmt, 11 );
+
+    // Strings are packed in a separate buffer and fixed up once the final
+    // block is allocated, as the buffer may move while growing.
+    text = reinterpret_cast< const char * >( sqlite3_column_text( ppStmt, 1 ) );
+    if ( text != NULL ) {
+      len = strlen( text ) + 1;
+      while ( strSize + len > strCapacity ) {
+        strCapacity *= 2;
+        strings = ( char * )realloc( strings, strCapacity );
+      }
+      memcpy( strings + strSize, text, len );
+      pathOffsets[ n ] = strSize;
+      strSize += len;
+    } else {
+      pathOffsets[ n ] = ( size_t )-1;
     }
 
-    rc = sqlite3_bind_int( ppStmt, 1, id );
-
-    if ( rc != SQLITE_OK ) {
-      cerr << "mdcExhibitMdl::getExhibitPhotoPathById() - Failed to bind parameters for query: " << sqlite3_errmsg( db ) << endl;
-      sqlite3_finalize( ppStmt );
-      *path = NULL;
-      return;
-    }
+    n++;
+  }
 
-    rc = sqlite3_step( ppStmt );
+  if ( rc != SQLITE_DONE ) {
+    cerr << "mdcExhibitMdl::" << caller << "() - Error processing query: " << sqlite3_errmsg( db ) << endl;
+  }
 
-    if ( rc != SQLITE_ROW && rc != SQLITE_DONE ) {
-    	cerr << "mdcExhibitMdl::getExhibitPhotoPathById() - Failed to get an exhibit from the database: " << sqlite3_errmsg( db ) << endl;
-    	*path = NULL;
-    	return;
-    }
+  sqlite3_reset( ppStmt );
 
-    *path = ( char * )malloc( sizeof( char ) * strlen( reinterpret_cast< const char * >( sqlite3_column_text( ppStmt, 0 ) ) ) + 1 );
-    strcpy( *path, reinterpret_cast< const char * >( sqlite3_column_text( ppStmt, 0 ) ) );
+  if ( n == 0 ) {
+    free( recs );
+    free( pathOffsets );
+    free( strings );
+    return 0;
+  }
 
-    rc = sqlite3_finalize( ppStmt );
+  // Pack the records and their strings in a single block.
+  block = ( char * )malloc( sizeof( exhibitRecord_t ) * n + strSize );
+  memcpy( block, recs, sizeof( exhibitRecord_t ) * n );
+  memcpy( block + sizeof( exhibitRecord_t ) * n, strings, strSize );
 
-    if ( rc != SQLITE_OK ) {
-      cerr << "mdcExhibitMdl::getExhibitPhotoPathById() - Error finalizing query: " << sqlite3_errmsg( db ) << endl;
+  *records = reinterpret_cast< exhibitRecord_t * >( block );
+  for ( int i = 0; i < n; i++ ) {
+    if ( pathOffsets[ i ] != ( size_t )-1 ) {
+      ( *records )[ i ].modelPath = block + sizeof( exhibitRecord_t ) * n + pathOffsets[ i ];
     }
-
-  } else {
-    cerr << "mdcExhibitMdl::getExhibitPhotoPathById() - Database is unusable." << endl;
   }
-}
-
-// Geometric transformation getters.
-void mdcExhibitMdl::getTranslationById( vec3_t & trans, int id ) {
-  const char   *   query = "SELECT translation_x, translation_y, translation_z FROM exhibits WHERE id = ?";
-  sqlite3_stmt *   ppStmt;
-  int              rc;
 
-  if ( dbUsable ) {
-    rc = sqlite3_prepare_v2( db, query, 78, &ppStmt, NULL);
+  free( recs );
+  free( pathOffsets );
+  free( strings );
 
-    if ( rc != SQLITE_OK ) {
-      cerr << "mdcExhibitMdl::getTranslationById() - Failed to prepare query: " << sqlite3_errmsg( db ) << endl;
-      trans.x = BAD_VALUE;
-      trans.y = BAD_VALUE;
-      trans.z = BAD_VALUE;
-      sqlite3_finalize( ppStmt );
-      return;
-    }
+  return n;
+}
 
-    rc = sqlite3_bind_int( ppStmt, 1, id );
+/*------------------------------------------------------------------------------
+; mdcExhibitMdl::getCatalogRecords()
+;
+; Same as getExhibitRecords() but built from n rows of the preloaded catalog
+; starting at the given row. The model paths point straight into the catalog.
+;-----------------------------------------------------------------------------*/
+int mdcExhibitMdl::getCatalogRecords( exhibitRecord_t ** records, int first, int n ) const {
+  if ( n <= 0 ) {
+    *records = NULL;
+    return 0;
+  }
 
-    if ( rc != SQLITE_OK ) {
-      cerr << "mdcExhibitMdl::getTranslationById() - Failed to bind parameters for query: " << sqlite3_errmsg( db ) << endl;
-      trans.x = BAD_VALUE;
-      trans.y = BAD_VALUE;
-      trans.z = BAD_VALUE;
-      sqlite3_finalize( ppStmt );
-      return;
-    }
+  *records = ( exhibitRecord_t * )malloc( sizeof( exhibitRecord_t ) * n );
 
-    rc = sqlite3_step( ppStmt );
+  for ( int i = 0; i < n; i++ ) {
+    exhibitRecord_t & rec = ( *records )[ i ];
 
-    trans.x = ( float )sqlite3_column_double( ppStmt, 0 );
-    trans.y = ( float )sqlite3_column_double( ppStmt, 1 );
-    trans.z = ( float )sqlite3_column_double( ppStmt, 2 );
+    rec.id             = catalog->getIdByIndex( first + i );
+    rec.modelPath      = catalog->getModelPathByIndex( first + i );
+    rec.translation    = catalog->getTranslationByIndex( first + i );
+    rec.rotation       = catalog->getRotationByIndex( first + i );
+    rec.scaling        = catalog->getScalingByIndex( first + i );
+    rec.rotationAmount = catalog->getRotationAmountByIndex( first + i );
+  }
 
-    rc = sqlite3_finalize( ppStmt );
+  return n;
+}
 
-    if ( rc != SQLITE_OK ) {
-      cerr << "mdcExhibitMdl::getTranslationById() - Error finalizing query: " << sqlite3_errmsg( db ) << endl;
-      trans.x = BAD_VALUE;
-      trans.y = BAD_VALUE;
-      trans.z = BAD_VALUE;
-    }
+// Text getters.
+void mdcExhibitMdl::getExhibitTitleById( char ** title, int id ) {
+  getTextById( STMT_TITLE, title, id, "getExhibitTitleById" );
+}
 
-  } else {
-    cerr << "mdcExhibitMdl::getTranslationById() - Database is unusable." << endl;
-    trans.x = BAD_VALUE;
-	trans.y = BAD_VALUE;
-	trans.z = BAD_VALUE;
-  }
+void mdcExhibitMdl::getExhibitDescriptionById( char ** desc, int id ) {
+  getTextById( STMT_DESCRIPTION, desc, id, "getExhibitDescriptionById" );
 }
 
-void mdcExhibitMdl::getRotationById( vec3_t & rot, int id ) {
-  const char   *   query = "SELECT rotation_x, rotation_y, rotation_z FROM exhibits WHERE id = ?";
-  sqlite3_stmt *   ppStmt;
-  int              rc;
+void mdcExhibitMdl::getExhibitModelPathById( char ** path, int id ) {
+  getTextById( STMT_MODEL_PATH, path, id, "getExhibitModelPathById" );
+}
 
-  if ( dbUsable ) {
-    rc = sqlite3_prepare_v2( db, query, 69, &ppStmt, NULL);
+void mdcExhibitMdl::getExhibitPhotoPathById( char ** path, int id ) {
+  getTextById( STMT_PHOTO_PATH, path, id, "getExhibitPhotoPathById" );
+}
 
-    if ( rc != SQLITE_OK ) {
-      cerr << "mdcExhibitMdl::getRotationById() - Failed to prepare query: " << sqlite3_errmsg( db ) << endl;
-      rot.x = BAD_VALUE;
-      rot.y = BAD_VALUE;
-      rot.z = BAD_VALUE;
-      sqlite3_finalize( ppStmt );
-      return;
-    }
+// Zero-copy text getters.
+const char * mdcExhibitMdl::getExhibitTitleViewById( int id ) {
+  return getTextViewById( STMT_TITLE, id, "getExhibitTitleViewById" );
+}
 
-    rc = sqlite3_bind_int( ppStmt, 1, id );
+const char * mdcExhibitMdl::getExhibitDescriptionViewById( int id ) {
+  return getTextViewById( STMT_DESCRIPTION, id, "getExhibitDescriptionViewById" );
+}
 
-    if ( rc != SQLITE_OK ) {
-      cerr << "mdcExhibitMdl::getRotationById() - Failed to bind parameters for query: " << sqlite3_errmsg( db ) << endl;
-      rot.x = BAD_VALUE;
-      rot.y = BAD_VALUE;
-      rot.z = BAD_VALUE;
-      sqlite3_finalize( ppStmt );
-      return;
-    }
+const char * mdcExhibitMdl::getExhibitModelPathViewById( int id ) {
+  return getTextViewById( STMT_MODEL_PATH, id, "getExhibitModelPathViewById" );
+}
 
-    rc = sqlite3_step( ppStmt );
+const char * mdcExhibitMdl::getExhibitPhotoPathViewById( int id ) {
+  return getTextViewById( STMT_PHOTO_PATH, id, "getExhibitPhotoPathViewById" );
+}
 
-    rot.x = ( float )sqlite3_column_double( ppStmt, 0 );
-    rot.y = ( float )sqlite3_column_double( ppStmt, 1 );
-    rot.z = ( float )sqlite3_column_double( ppStmt, 2 );
+/*------------------------------------------------------------------------------
+; mdcExhibitMdl::getTextViewById()
+;
+; Returns a pointer into the catalog string pool, loading the catalog first if
+; needed. SQLite column text is never handed out because it only lives until
+; the next step or reset of its statement.
+;-----------------------------------------------------------------------------*/
+const char * mdcExhibitMdl::getTextViewById( exhibitStmt_t which, int id, const char * caller ) {
+  if ( catalog == NULL && !preloadCatalog() ) {
+    cerr << "mdcExhibitMdl::" << caller << "() - The exhibit catalog is unavailable." << endl;
+    return NULL;
+  }
 
-    rc = sqlite3_finalize( ppStmt );
+  return getCatalogText( which, id );
+}
 
-    if ( rc != SQLITE_OK ) {
-      cerr << "mdcExhibitMdl::getRotationById() - Error finalizing query: " << sqlite3_errmsg( db ) << endl;
-      rot.x = BAD_VALUE;
-      rot.y = BAD_VALUE;
-      rot.z = BAD_VALUE;
-    }
+// Geometric transformation getters.
+void mdcExhibitMdl::getTranslationById( vec3_t & trans, int id ) {
+  getVectorById( STMT_TRANSLATION, trans, id, "getTranslationById" );
+}
 
-  } else {
-    cerr << "mdcExhibitMdl::getRotationById() - Database is unusable." << endl;
-    rot.x = BAD_VALUE;
-    rot.y = BAD_VALUE;
-	rot.z = BAD_VALUE;
-  }
+void mdcExhibitMdl::getRotationById( vec3_t & rot, int id ) {
+  getVectorById( STMT_ROTATION, rot, id, "getRotationById" );
 }
 
 float mdcExhibitMdl::getRotationAmountById( int id ) {
-  const char   *   query = "SELECT rotation_amout FROM exhibits WHERE id = ?";
   sqlite3_stmt *   ppStmt;
   int              rc;
-  float            value;
+  float            value = BAD_VALUE;
+  int              i;
 
-  if ( dbUsable ) {
-    rc = sqlite3_prepare_v2( db, query, 69, &ppStmt, NULL);
+  if ( catalog != NULL ) {
+    i = catalog->getIndexById( id );
+    return i < 0 ? BAD_VALUE : catalog->getRotationAmountByIndex( i );
+  }
 
-    if ( rc != SQLITE_OK ) {
-      cerr << "mdcExhibitMdl::getRotationAmountById() - Failed to prepare query: " << sqlite3_errmsg( db ) << endl;
-      sqlite3_finalize( ppStmt );
-      return BAD_VALUE;
-    }
+  if ( dbUsable ) {
+    TRACE_SCOPE_ARG( "sql", "getRotationAmountById" );
 
-    rc = sqlite3_bind_int( ppStmt, 1, id );
+    ppStmt = getStatementById( STMT_ROTATION_AMOUNT, id, "getRotationAmountById" );
 
-    if ( rc != SQLITE_OK ) {
-      cerr << "mdcExhibitMdl::getRotationAmountById() - Failed to bind parameters for query: " << sqlite3_errmsg( db ) << endl;
-      sqlite3_finalize( ppStmt );
+    if ( ppStmt == NULL ) {
       return BAD_VALUE;
     }
 
     rc = sqlite3_step( ppStmt );
 
-    value = ( float )sqlite3_column_double( ppStmt, 0 );
-
-    rc = sqlite3_finalize( ppStmt );
-
-    if ( rc != SQLITE_OK ) {
-      cerr << "mdcExhibitMdl::getRotationAmountById() - Error finalizing query: " << sqlite3_errmsg( db ) << endl;
-      return BAD_VALUE;
+    if ( rc == SQLITE_ROW ) {
+      value = ( float )sqlite3_column_double( ppStmt, 0 );
+    } else if ( rc != SQLITE_DONE ) {
+      cerr << "mdcExhibitMdl::getRotationAmountById() - Failed to get an exhibit from the database: " << sqlite3_errmsg( db ) << endl;
     }
 
+    sqlite3_reset( ppStmt );
+
     return value;
 
   } else {
@@ -558,53 +913,7 @@ float mdcExhibitMdl::getRotationAmountById( int id ) {
 }
 
 void mdcExhibitMdl::getScalingById( vec3_t & scal, int id ) {
-  const char   *   query = "SELECT scaling_x, scaling_y, scaling_z FROM exhibits WHERE id = ?";
-  sqlite3_stmt *   ppStmt;
-  int              rc;
-
-  if ( dbUsable ) {
-    rc = sqlite3_prepare_v2( db, query, 66, &ppStmt, NULL);
-
-    if ( rc != SQLITE_OK ) {
-      cerr << "mdcExhibitMdl::getScalingById() - Failed to prepare query: " << sqlite3_errmsg( db ) << endl;
-      scal.x = BAD_VALUE;
-      scal.y = BAD_VALUE;
-      scal.z = BAD_VALUE;
-      sqlite3_finalize( ppStmt );
-      return;
-    }
-
-    rc = sqlite3_bind_int( ppStmt, 1, id );
-
-    if ( rc != SQLITE_OK ) {
-      cerr << "mdcExhibitMdl::getScalingById() - Failed to bind parameters for query: " << sqlite3_errmsg( db ) << endl;
-      scal.x = BAD_VALUE;
-      scal.y = BAD_VALUE;
-      scal.z = BAD_VALUE;
-      sqlite3_finalize( ppStmt );
-      return;
-    }
-
-    rc = sqlite3_step( ppStmt );
-
-    scal.x = ( float )sqlite3_column_double( ppStmt, 0 );
-    scal.y = ( float )sqlite3_column_double( ppStmt, 1 );
-    scal.z = ( float )sqlite3_column_double( ppStmt, 2 );
-
-    rc = sqlite3_finalize( ppStmt );
-
-    if ( rc != SQLITE_OK ) {
-      cerr << "mdcExhibitMdl::getScalingById() - Error finalizing query: " << sqlite3_errmsg( db ) << endl;
-      scal.x = BAD_VALUE;
-      scal.y = BAD_VALUE;
-      scal.z = BAD_VALUE;
-    }
-  } else {
-    cerr << "mdcExhibitMdl::ScalingById() - Database is unusable." << endl;
-    scal.x = BAD_VALUE;
-    scal.y = BAD_VALUE;
-	scal.z = BAD_VALUE;
-  }
+  getVectorById( STMT_SCALING, scal, id, "getScalingById" );
 }
 
 void swap( int & a, int & b ){
@@ -36,6 +36,43 @@ typedef struct VEC_3 {
   float z;
 } vec3_t;
 
+// Everything needed to place an exhibit in the scene. The model path is
+// valid until the record block is freed or the database is released.
+typedef struct EXHIBIT_RECORD {
+  int            id;
+  const char *   modelPath;
+  vec3_t         translation;
+  vec3_t         rotation;
+  vec3_t         scaling;
+  float          rotationAmount;
+} exhibitRecord_t;
+
+// Keyset paging position over the exhibits ordered by id.
+typedef struct EXHIBIT_CURSOR {
+  int            lastId;
+  bool           done;
+} exhibitCursor_t;
+
+// Queries prepared once per database and reused by the getters.
+typedef enum EXHIBIT_STATEMENT {
+  STMT_NUM_EXHIBITS = 0,
+  STMT_FIRST_IDS,
+  STMT_IDS_RANGE,
+  STMT_IDS_AFTER,
+  STMT_RECORDS,
+  STMT_RECORDS_AFTER,
+  STMT_CATALOG,
+  STMT_TITLE,
+  STMT_DESCRIPTION,
+  STMT_MODEL_PATH,
+  STMT_PHOTO_PATH,
+  STMT_TRANSLATION,
+  STMT_ROTATION,
+  STMT_ROTATION_AMOUNT,
+  STMT_SCALING,
+  STMT_COUNT
+} exhibitStmt_t;
+
 class mdcExhibitMdl {
 	public:
 		static mdcExhibitMdl *    getInstance();
@@ -45,17 +82,38 @@ class mdcExhibitMdl {
 		bool                      setDatabaseFile( const char * );
 		bool                      releaseDatabase();
 
+		// Preload mode. Reads the whole exhibits table into memory so the
+		// getters below stop touching the database.
+		bool                      preloadCatalog();
+		bool                      isCatalogLoaded()                   const;
+
 		// Different methods to get row ids.
 		int                       getNumOfExhibits();
 		int                       getFirstNExhibitIds( int *, int );
 		int                       getExhibitsIdsRange( int *, int, int );
 
+		// Paging through the exhibits without rescanning the table.
+		void                      openExhibitCursor( exhibitCursor_t & ) const;
+		int                       getNextExhibitIds( exhibitCursor_t &, int *, int );
+		int                       getNextExhibitRecords( exhibitCursor_t &, exhibitRecord_t **, int );
+
+		// Bulk getters.
+		int                       getExhibitRecords( exhibitRecord_t ** );
+
 		// Text getters.
 		void                      getExhibitTitleById( char**, int );
 		void                      getExhibitDescriptionById( char**, int );
 		void                      getExhibitModelPathById( char**, int );
 		void                      getExhibitPhotoPathById( char**, int );
 
+		// Zero-copy text getters. The strings live in the catalog, which is
+		// preloaded on first use, and stay valid until releaseDatabase().
+		// They must not be freed. NULL means no such exhibit or column.
+		const char           *    getExhibitTitleViewById( int );
+		const char           *    getExhibitDescriptionViewById( int );
+		const char           *    getExhibitModelPathViewById( int );
+		const char           *    getExhibitPhotoPathViewById( int );
+
 		// Geometric transformation getters.
 		void                      getTranslationById( vec3_t &, int );
 		void                      getRotationById( vec3_t &, int );
@@ -65,6 +123,8 @@ class mdcExhibitMdl {
 	private:
 		static mdcExhibitMdl *    instance;
 		sqlite3              *    db;
+		sqlite3_stmt         *    stmts[ STMT_COUNT ];
+		mdcExhibitCatalog    *    catalog;
 
 		int                       refs;
 		bool                      dbUsable;
@@ -74,6 +134,21 @@ class mdcExhibitMdl {
 		mdcExhibitMdl( mdcExhibitMdl const & ) { };
 		~mdcExhibitMdl();
 		mdcExhibitMdl & operator=( mdcExhibitMdl const & ) { return *instance; }
+
+		// Statement cache helpers.
+		bool                      prepareStatements();
+		void                      finalizeStatements();
+		sqlite3_stmt         *    getStatement( exhibitStmt_t, const char * );
+		sqlite3_stmt         *    getStatementById( exhibitStmt_t, int, const char * );
+		void                      getTextById( exhibitStmt_t, char **, int, const char * );
+		void                      getVectorById( exhibitStmt_t, vec3_t &, int, const char * );
+		const char           *    getTextViewById( exhibitStmt_t, int, const char * );
+		int                       readIds( sqlite3_stmt *, int *, const char * );
+		int                       readRecords( sqlite3_stmt *, exhibitRecord_t **, const char * );
+
+		// Catalog helpers.
+		const char           *    getCatalogText( exhibitStmt_t, int ) const;
+		int                       getCatalogRecords( exhibitRecord_t **, int, int ) const;
 };
 
 #endif
@@ -0,0 +1,343 @@
+/*------------------------------------------------------------------------------
+; File:          ExhibitPicker.cpp
+; Description:   Implementation of the exhibit picking index.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#include <cstring>
+
+#include "ExhibitPicker.hpp"
+
+// One block of boxes for the ray kernels.
+#define LEAF_SIZE       KERNEL_WIDTH
+#define STACK_SIZE      64
+
+// Fraction of the ray kept clear in front of a hit, so the floor under an
+// exhibit does not count as an occluder.
+#define OCCLUDER_SLACK  0.001f
+
+static u32    buildNode( core::array< bvhNode_t > &, pickEntry_t *, u32, u32 );
+static void   selectMedian( pickEntry_t *, u32, u32, u32, int );
+static f32    center( const pickEntry_t &, int );
+static f32    component( const core::vector3df &, int );
+static bool   lineHitsBox( const bvhNode_t &, const core::vector3df &, const core::vector3df &, f32, f32 & );
+
+mdcExhibitPicker::mdcExhibitPicker() { }
+
+mdcExhibitPicker::~mdcExhibitPicker() {
+	for ( u32 i = 0; i < entries.size(); i++ ) {
+		entries[ i ].selector->drop();
+	}
+}
+
+/*------------------------------------------------------------------------------
+; mdcExhibitPicker::addExhibit()
+;
+; Adds an exhibit with its id and world bounding box. The selector must
+; return its triangles in world space. build() must be called before the
+; next pick().
+;-----------------------------------------------------------------------------*/
+void mdcExhibitPicker::addExhibit( s32 id, const core::aabbox3df & box, scene::ITriangleSelector * selector ) {
+	pickEntry_t entry;
+
+	entry.box      = box;
+	entry.id       = id;
+	entry.selector = selector;
+	selector->grab();
+
+	entries.push_back( entry );
+}
+
+/*------------------------------------------------------------------------------
+; mdcExhibitPicker::build()
+;
+; Builds the hierarchy by splitting the exhibits at the median box center
+; along the longest axis. Exhibit counts are small enough that the SAH used
+; for the collision triangles does not pay for itself here.
+;-----------------------------------------------------------------------------*/
+void mdcExhibitPicker::build() {
+	nodes.clear();
+
+	if ( entries.empty() ) {
+		return;
+	}
+
+	nodes.reallocate( 2 * entries.size() );
+	buildNode( nodes, entries.pointer(), 0, entries.size() );
+
+	boxBlocks.set_used( ( entries.size() + KERNEL_WIDTH - 1 ) / KERNEL_WIDTH );
+	memset( boxBlocks.pointer(), 0, sizeof( boxBlock_t ) * boxBlocks.size() );
+	for ( u32 i = 0; i < entries.size(); i++ ) {
+		mdcRayKernels::packBox( boxBlocks.pointer(), i, entries[ i ].box );
+	}
+}
+
+/*------------------------------------------------------------------------------
+; mdcExhibitPicker::pick()
+;
+; Returns the id of the closest exhibit hit by the ray and the hit point, or
+; zero if no exhibit is hit or the hit is hidden by an occluder of the given
+; collision world, which may be NULL.
+;-----------------------------------------------------------------------------*/
+s32 mdcExhibitPicker::pick( const core::line3d< f32 > & ray, const mdcCollisionBvh * world, core::vector3df & hit ) {
+	u32             stack[ STACK_SIZE ];
+	u32             top  = 0;
+	s32             id   = 0;
+	f32             best = 1.0f;
+	f32             tNear;
+	f32             tBoxes[ KERNEL_WIDTH ];
+	core::vector3df dir  = ray.end - ray.start;
+	core::vector3df invDir;
+	kernelRay_t     kray;
+
+	if ( nodes.empty() ) {
+		return 0;
+	}
+
+	mdcRayKernels::makeRay( kray, ray );
+	invDir.set( kray.invDir[ 0 ], kray.invDir[ 1 ], kray.invDir[ 2 ] );
+
+	stack[ top++ ] = 0;
+
+	while ( top > 0 ) {
+		u32               index = stack[ --top ];
+		const bvhNode_t & node  = nodes[ index ];
+
+		// Subtrees that start past the closest hit so far can be skipped.
+		if ( !lineHitsBox( node, ray.start, invDir, best, tNear ) ) {
+			continue;
+		}
+
+		if ( node.count == 0 ) {
+			u32  left  = index + 1;
+			u32  right = node.offset;
+			f32  tLeft;
+			f32  tRight;
+			bool hitLeft  = lineHitsBox( nodes[ left ], ray.start, invDir, best, tLeft );
+			bool hitRight = lineHitsBox( nodes[ right ], ray.start, invDir, best, tRight );
+
+			// Visit the nearer child first so its hits prune the other one.
+			if ( hitLeft && hitRight ) {
+				stack[ top++ ] = tLeft <= tRight ? right : left;
+				stack[ top++ ] = tLeft <= tRight ? left : right;
+			} else if ( hitLeft ) {
+				stack[ top++ ] = left;
+			} else if ( hitRight ) {
+				stack[ top++ ] = right;
+			}
+			continue;
+		}
+
+		for ( u32 b = node.offset / KERNEL_WIDTH; b <= ( node.offset + node.count - 1 ) / KERNEL_WIDTH; b++ ) {
+			u32 mask = mdcRayKernels::intersectBoxes( boxBlocks[ b ], kray, best, tBoxes ) &
+			           mdcRayKernels::getLaneMask( b, node.offset, node.count );
+
+			for ( u32 lane = 0; mask != 0; lane++, mask >>= 1 ) {
+				if ( ( mask & 1 ) && refine( entries[ b * KERNEL_WIDTH + lane ], kray, best, hit ) ) {
+					id = entries[ b * KERNEL_WIDTH + lane ].id;
+				}
+			}
+		}
+	}
+
+	if ( id != 0 && world != NULL ) {
+		core::line3d< f32 > toHit( ray.start, ray.start + dir * ( best * ( 1.0f - OCCLUDER_SLACK ) ) );
+
+		if ( world->isSegmentOccluded( toHit ) ) {
+			id = 0;
+		}
+	}
+
+	return id;
+}
+
+u32 mdcExhibitPicker::getExhibitCount() const {
+	return entries.size();
+}
+
+/*------------------------------------------------------------------------------
+; mdcExhibitPicker::refine()
+;
+; Tests the triangles of a candidate exhibit against the part of the ray
+; before the closest hit so far. Updates best, as a fraction of the ray, and
+; the hit point if a closer hit is found.
+;-----------------------------------------------------------------------------*/
+bool mdcExhibitPicker::refine( const pickEntry_t & entry, const kernelRay_t & ray, f32 & best, core::vector3df & hit ) {
+	core::vector3df     start( ray.origin[ 0 ], ray.origin[ 1 ], ray.origin[ 2 ] );
+	core::vector3df     dir( ray.dir[ 0 ], ray.dir[ 1 ], ray.dir[ 2 ] );
+	core::line3d< f32 > segment( start, start + dir * best );
+	f32                 t[ KERNEL_WIDTH ];
+	bool                found   = false;
+	s32                 count   = entry.selector->getTriangleCount();
+	s32                 written;
+
+	if ( count <= 0 ) {
+		return false;
+	}
+
+	if ( scratch.size() < ( u32 )count ) {
+		scratch.set_used( count );
+	}
+
+	entry.selector->getTriangles( scratch.pointer(), count, written, segment );
+
+	scratchBlocks.set_used( ( written + KERNEL_WIDTH - 1 ) / KERNEL_WIDTH );
+	memset( scratchBlocks.pointer(), 0, sizeof( triBlock_t ) * scratchBlocks.size() );
+	for ( s32 i = 0; i < written; i++ ) {
+		mdcRayKernels::packTriangle( scratchBlocks.pointer(), i, scratch[ i ] );
+	}
+
+	for ( u32 b = 0; b < scratchBlocks.size(); b++ ) {
+		u32 mask = mdcRayKernels::intersectTriangles( scratchBlocks[ b ], ray, best, t );
+
+		for ( u32 lane = 0; mask != 0; lane++, mask >>= 1 ) {
+			if ( ( mask & 1 ) && t[ lane ] < best ) {
+				best  = t[ lane ];
+				found = true;
+			}
+		}
+	}
+
+	if ( found ) {
+		hit = start + dir * best;
+	}
+
+	return found;
+}
+
+/*------------------------------------------------------------------------------
+; buildNode()
+;
+; Builds the subtree over entries[ first, first + count ) and returns its
+; index. Inner nodes are laid out like the collision BVH ones.
+;-----------------------------------------------------------------------------*/
+static u32 buildNode( core::array< bvhNode_t > & tree, pickEntry_t * entries, u32 first, u32 count ) {
+	core::aabbox3df   bounds( entries[ first ].box );
+	core::aabbox3df   centers( entries[ first ].box.getCenter() );
+	core::vector3df   extent;
+	bvhNode_t         node;
+	u32               index = tree.size();
+	u32               mid;
+	u32               right;
+	int               axis;
+
+	for ( u32 i = first + 1; i < first + count; i++ ) {
+		bounds.addInternalBox( entries[ i ].box );
+		centers.addInternalPoint( entries[ i ].box.getCenter() );
+	}
+
+	node.min[ 0 ] = bounds.MinEdge.X;
+	node.min[ 1 ] = bounds.MinEdge.Y;
+	node.min[ 2 ] = bounds.MinEdge.Z;
+	node.max[ 0 ] = bounds.MaxEdge.X;
+	node.max[ 1 ] = bounds.MaxEdge.Y;
+	node.max[ 2 ] = bounds.MaxEdge.Z;
+	node.offset   = first;
+	node.count    = count;
+	tree.push_back( node );
+
+	if ( count <= LEAF_SIZE ) {
+		return index;
+	}
+
+	extent = centers.getExtent();
+	axis   = extent.X > extent.Y ? ( extent.X > extent.Z ? 0 : 2 ) : ( extent.Y > extent.Z ? 1 : 2 );
+	mid    = first + count / 2;
+
+	selectMedian( entries, first, first + count - 1, mid, axis );
+
+	// The children may grow the array, so only index it once they are built.
+	buildNode( tree, entries, first, mid - first );
+	right = buildNode( tree, entries, mid, first + count - mid );
+
+	tree[ index ].offset = right;
+	tree[ index ].count  = 0;
+
+	return index;
+}
+
+// Quickselect, leaves the entry with the k-th smallest center at k with no
+// larger center before it and no smaller one after it.
+static void selectMedian( pickEntry_t * entries, u32 first, u32 last, u32 k, int axis ) {
+	s32 lo = first;
+	s32 hi = last;
+
+	while ( lo < hi ) {
+		f32          pivot = center( entries[ lo + ( hi - lo ) / 2 ], axis );
+		s32          i     = lo;
+		s32          j     = hi;
+		pickEntry_t  tmp;
+
+		while ( i <= j ) {
+			while ( center( entries[ i ], axis ) < pivot ) i++;
+			while ( center( entries[ j ], axis ) > pivot ) j--;
+
+			if ( i <= j ) {
+				tmp          = entries[ i ];
+				entries[ i ] = entries[ j ];
+				entries[ j ] = tmp;
+				i++;
+				j--;
+			}
+		}
+
+		if ( ( s32 )k <= j ) {
+			hi = j;
+		} else if ( ( s32 )k >= i ) {
+			lo = i;
+		} else {
+			return;
+		}
+	}
+}
+
+static f32 center( const pickEntry_t & entry, int axis ) {
+	return component( entry.box.getCenter(), axis );
+}
+
+static f32 component( const core::vector3df & v, int axis ) {
+	return axis == 0 ? v.X : ( axis == 1 ? v.Y : v.Z );
+}
+
+// Slab test of start + t * dir, t in [0, tMax], against the node box.
+static bool lineHitsBox( const bvhNode_t & node, const core::vector3df & start, const core::vector3df & invDir,
+                         f32 tMax, f32 & tNear ) {
+	f32 tmin = 0.0f;
+	f32 tmax = tMax;
+
+	for ( int a = 0; a < 3; a++ ) {
+		f32 t0 = ( node.min[ a ] - component( start, a ) ) * component( invDir, a );
+		f32 t1 = ( node.max[ a ] - component( start, a ) ) * component( invDir, a );
+
+		if ( t0 > t1 ) {
+			f32 tmp = t0;
+			t0 = t1;
+			t1 = tmp;
+		}
+
+		tmin = t0 > tmin ? t0 : tmin;
+		tmax = t1 < tmax ? t1 : tmax;
+
+		if ( tmin > tmax ) {
+			return false;
+		}
+	}
+
+	tNear = tmin;
+	return true;
+}
@@ -0,0 +1,73 @@
+/*------------------------------------------------------------------------------
+; File:          ExhibitPicker.hpp
+; Description:   Declaration of the exhibit picking index.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#ifndef EXHIBITPICKER_H
+#define EXHIBITPICKER_H
+
+#include <irrlicht.h>
+
+#include "definitions.hpp"
+#include "CollisionBvh.hpp"
+
+using namespace irr;
+
+// An exhibit in the picking index.
+typedef struct PICK_ENTRY {
+	core::aabbox3df                 box;
+	s32                             id;
+	scene::ITriangleSelector   *    selector;
+} pickEntry_t;
+
+/*------------------------------------------------------------------------------
+; Finds the exhibit under a ray. The exhibits' world bounding boxes are kept
+; in a bounding volume hierarchy that uses the same node layout as
+; mdcCollisionBvh, and only the exhibits whose box is crossed by the ray have
+; their triangles tested. The room geometry is only used to check that
+; nothing hides the closest hit. Both tests use the ray kernels.
+;-----------------------------------------------------------------------------*/
+class mdcExhibitPicker {
+	public:
+		mdcExhibitPicker();
+		~mdcExhibitPicker();
+
+		// Building.
+		void                            addExhibit( s32, const core::aabbox3df &, scene::ITriangleSelector * );
+		void                            build();
+
+		s32                             pick( const core::line3d< f32 > &, const mdcCollisionBvh *,
+		                                      core::vector3df & );
+		u32                             getExhibitCount()                                               const;
+
+	private:
+		core::array< pickEntry_t >      entries;
+		core::array< bvhNode_t >        nodes;
+		core::array< boxBlock_t >       boxBlocks;
+		core::array< core::triangle3df > scratch;
+		core::array< triBlock_t >       scratchBlocks;
+
+		mdcExhibitPicker( mdcExhibitPicker const & ) { };
+		mdcExhibitPicker & operator=( mdcExhibitPicker const & ) { return *this; }
+
+		bool                            refine( const pickEntry_t &, const kernelRay_t &, f32 &,
+		                                        core::vector3df & );
+};
+
+#endif // EXHIBITPICKER_H
@@ -0,0 +1,129 @@
+/*------------------------------------------------------------------------------
+; File:          InstanceShader.cpp
+; Description:   Implementation of the instancing shader class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#include <iostream>
+
+#include "InstanceShader.hpp"
+
+using std::cerr;
+using std::endl;
+
+#define STRINGIFY_( x ) #x
+#define STRINGIFY( x )  STRINGIFY_( x )
+
+static const char * VERTEX_SHADER =
+	"uniform mat4 uViewProj;\n"
+	"uniform vec4 uInstances[ " STRINGIFY( INSTANCE_BATCH ) " * 3 ];\n"
+	"\n"
+	"void main() {\n"
+	"	int  i = int( gl_MultiTexCoord1.x ) * 3;\n"
+	"	vec4 p = vec4( gl_Vertex.xyz, 1.0 );\n"
+	"\n"
+	"	gl_Position    = uViewProj * vec4( dot( uInstances[ i ], p ), dot( uInstances[ i + 1 ], p ),\n"
+	"	                                   dot( uInstances[ i + 2 ], p ), 1.0 );\n"
+	"	gl_FrontColor  = gl_Color;\n"
+	"	gl_TexCoord[0] = gl_MultiTexCoord0;\n"
+	"}\n";
+
+static const char * PIXEL_SHADER =
+	"uniform sampler2D uTexture;\n"
+	"uniform int       uTextured;\n"
+	"\n"
+	"void main() {\n"
+	"	vec4 color = gl_Color;\n"
+	"\n"
+	"	if ( uTextured != 0 ) {\n"
+	"		color *= texture2D( uTexture, gl_TexCoord[0].xy );\n"
+	"	}\n"
+	"\n"
+	"	gl_FragColor = color;\n"
+	"}\n";
+
+mdcInstanceShader::mdcInstanceShader() {
+	materialType = -1;
+	instances    = NULL;
+	textured     = false;
+}
+
+/*------------------------------------------------------------------------------
+; mdcInstanceShader::create()
+;
+; Compiles the shaders. Returns false if the driver is not OpenGL with GLSL,
+; in which case the caller must draw every instance on its own.
+;-----------------------------------------------------------------------------*/
+bool mdcInstanceShader::create( video::IVideoDriver * driver ) {
+	video::IGPUProgrammingServices * gpu = driver->getGPUProgrammingServices();
+
+	if ( driver->getDriverType() != video::EDT_OPENGL || gpu == NULL ||
+	     !driver->queryFeature( video::EVDF_ARB_GLSL ) || !driver->queryFeature( video::EVDF_VERTEX_BUFFER_OBJECT ) ) {
+		return false;
+	}
+
+	materialType = gpu->addHighLevelShaderMaterial( VERTEX_SHADER, "main", video::EVST_VS_1_1,
+	                                                PIXEL_SHADER, "main", video::EPST_PS_1_1,
+	                                                this, video::EMT_SOLID );
+
+	if ( materialType < 0 ) {
+		cerr << "mdcInstanceShader::create() - Could not compile the instancing shaders." << endl;
+		return false;
+	}
+
+	return true;
+}
+
+video::E_MATERIAL_TYPE mdcInstanceShader::getMaterialType() const {
+	return ( video::E_MATERIAL_TYPE )materialType;
+}
+
+// The array must hold INSTANCE_BATCH * INSTANCE_FLOATS floats and live until the draw.
+void mdcInstanceShader::setInstances( const f32 * data ) {
+	instances = data;
+}
+
+void mdcInstanceShader::OnSetMaterial( const video::SMaterial & material ) {
+	textured = material.getTexture( 0 ) != NULL;
+}
+
+/*------------------------------------------------------------------------------
+; mdcInstanceShader::OnSetConstants()
+;
+; Called by the driver before every draw with the material. Some drivers
+; name uniform arrays after their first element.
+;-----------------------------------------------------------------------------*/
+void mdcInstanceShader::OnSetConstants( video::IMaterialRendererServices * services, s32 userData ) {
+	video::IVideoDriver * driver  = services->getVideoDriver();
+	core::matrix4         viewProj;
+	s32                   sampler = 0;
+	s32                   useTex  = textured ? 1 : 0;
+
+	viewProj  = driver->getTransform( video::ETS_PROJECTION );
+	viewProj *= driver->getTransform( video::ETS_VIEW );
+
+	services->setVertexShaderConstant( "uViewProj", viewProj.pointer(), 16 );
+
+	if ( instances != NULL &&
+	     !services->setVertexShaderConstant( "uInstances", instances, INSTANCE_BATCH * INSTANCE_FLOATS ) ) {
+		services->setVertexShaderConstant( "uInstances[0]", instances, INSTANCE_BATCH * INSTANCE_FLOATS );
+	}
+
+	services->setPixelShaderConstant( "uTexture", &sampler, 1 );
+	services->setPixelShaderConstant( "uTextured", &useTex, 1 );
+}
@@ -0,0 +1,63 @@
+/*------------------------------------------------------------------------------
+; File:          InstanceShader.hpp
+; Description:   Declaration of the instancing shader class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#ifndef INSTANCESHADER_H
+#define INSTANCESHADER_H
+
+#include <irrlicht.h>
+
+#include "definitions.hpp"
+
+using namespace irr;
+
+// Instances drawn by one call, limited by the vertex uniforms GL 2.0 has.
+#define INSTANCE_BATCH      32
+
+// Floats per instance, the first three rows of its world matrix.
+#define INSTANCE_FLOATS     12
+
+/*------------------------------------------------------------------------------
+; A GLSL material that draws up to INSTANCE_BATCH copies of a mesh in one
+; call. The copies live in one buffer whose second texture coordinate holds
+; the copy number, which picks the world matrix of the copy from a uniform
+; array set with setInstances() before each draw.
+;-----------------------------------------------------------------------------*/
+class mdcInstanceShader : public video::IShaderConstantSetCallBack {
+	public:
+		mdcInstanceShader();
+
+		bool                            create( video::IVideoDriver * );
+		video::E_MATERIAL_TYPE          getMaterialType()                                   const;
+		void                            setInstances( const f32 * );
+
+		virtual void                    OnSetMaterial( const video::SMaterial & );
+		virtual void                    OnSetConstants( video::IMaterialRendererServices *, s32 );
+
+	private:
+		s32                             materialType;
+		const f32                *      instances;
+		bool                            textured;
+
+		mdcInstanceShader( mdcInstanceShader const & ) { };
+		mdcInstanceShader & operator=( mdcInstanceShader const & ) { return *this; }
+};
+
+#endif // INSTANCESHADER_H
@@ -0,0 +1,370 @@
+/*------------------------------------------------------------------------------
+; File:          InstancedMeshNode.cpp
+; Description:   Implementation of the instanced mesh scene node class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#include <iostream>
+#include <cstring>
+#include <cmath>
+
+#include "InstanceShader.hpp"
+#include "InstancedMeshNode.hpp"
+
+using std::cerr;
+using std::endl;
+
+mdcInstancedMeshNode::mdcInstancedMeshNode( scene::IMesh * mesh, mdcInstanceShader * s, scene::ISceneNode * parent,
+                                            scene::ISceneManager * mgr, s32 id ) : scene::ISceneNode( parent, mgr, id ) {
+	shader = s;
+	drawn  = 0;
+
+	if ( shader != NULL ) {
+		shader->grab();
+	}
+
+	for ( u32 b = 0; b < mesh->getMeshBufferCount(); b++ ) {
+		materials.push_back( mesh->getMeshBuffer( b )->getMaterial() );
+	}
+
+	addLevel( mesh );
+
+	constants.set_used( INSTANCE_BATCH * INSTANCE_FLOATS );
+}
+
+mdcInstancedMeshNode::~mdcInstancedMeshNode() {
+	for ( u32 b = 0; b < replicas.size(); b++ ) {
+		if ( replicas[ b ] != NULL ) {
+			replicas[ b ]->drop();
+		}
+	}
+
+	if ( shader != NULL ) {
+		shader->drop();
+	}
+
+	for ( u32 l = 0; l < levels.size(); l++ ) {
+		levels[ l ]->drop();
+	}
+}
+
+/*------------------------------------------------------------------------------
+; mdcInstancedMeshNode::addLevel()
+;
+; Adds the next coarser detail level. It must have the buffers of the mesh
+; given to the constructor in the same order, their materials are ignored.
+;-----------------------------------------------------------------------------*/
+void mdcInstancedMeshNode::addLevel( scene::IMesh * level ) {
+	if ( level->getMeshBufferCount() != materials.size() || levels.size() == LOD_LEVELS ) {
+		cerr << "mdcInstancedMeshNode::addLevel() - Ignoring a level that does not match the mesh." << endl;
+		return;
+	}
+
+	level->grab();
+	level->setHardwareMappingHint( scene::EHM_STATIC );
+	levels.push_back( level );
+
+	for ( u32 b = 0; b < level->getMeshBufferCount(); b++ ) {
+		replicas.push_back( NULL );
+		copies.push_back( 1 );
+	}
+}
+
+void mdcInstancedMeshNode::addInstance( const core::matrix4 & transform ) {
+	core::aabbox3d< f32 > instanceBox = levels[ 0 ]->getBoundingBox();
+
+	transform.transformBoxEx( instanceBox );
+
+	if ( instances.empty() ) {
+		box = instanceBox;
+	} else {
+		box.addInternalBox( instanceBox );
+	}
+
+	instances.push_back( transform );
+	boxes.push_back( instanceBox );
+	shown.push_back( true );
+	lods.push_back( 0 );
+}
+
+u32 mdcInstancedMeshNode::getInstanceCount() const {
+	return instances.size();
+}
+
+const core::aabbox3d< f32 > & mdcInstancedMeshNode::getInstanceBox( u32 i ) const {
+	return boxes[ i ];
+}
+
+void mdcInstancedMeshNode::setInstanceVisible( u32 i, bool visible ) {
+	shown[ i ] = visible;
+}
+
+// Instances drawn by the last frame, zero when the whole node was culled.
+u32 mdcInstancedMeshNode::getDrawnCount() const {
+	return drawn;
+}
+
+void mdcInstancedMeshNode::OnRegisterSceneNode() {
+	drawn = 0;
+
+	if ( IsVisible && !instances.empty() ) {
+		SceneManager->registerNodeForRendering( this, scene::ESNRP_SOLID );
+	}
+
+	ISceneNode::OnRegisterSceneNode();
+}
+
+/*------------------------------------------------------------------------------
+; mdcInstancedMeshNode::render()
+;
+; Draws the visible instances buffer by buffer, so each material is set once
+; for all the levels.
+;-----------------------------------------------------------------------------*/
+void mdcInstancedMeshNode::render() {
+	video::IVideoDriver * driver = SceneManager->getVideoDriver();
+
+	drawn = cullInstances();
+	if ( drawn == 0 ) {
+		return;
+	}
+
+	for ( u32 b = 0; b < materials.size(); b++ ) {
+		for ( u32 l = 0; l < levels.size(); l++ ) {
+			if ( visible[ l ].empty() ) {
+				continue;
+			}
+
+			// A lone instance draws no cheaper from the replicated buffer.
+			if ( shader != NULL && visible[ l ].size() > 1 ) {
+				replicate( l, b );
+			}
+
+			if ( replicas[ l * materials.size() + b ] != NULL && visible[ l ].size() > 1 ) {
+				drawReplicated( driver, l, b );
+			} else {
+				drawSingle( driver, l, b );
+			}
+		}
+	}
+}
+
+const core::aabbox3d< f32 > & mdcInstancedMeshNode::getBoundingBox() const {
+	return box;
+}
+
+u32 mdcInstancedMeshNode::getMaterialCount() const {
+	return materials.size();
+}
+
+video::SMaterial & mdcInstancedMeshNode::getMaterial( u32 i ) {
+	return materials[ i ];
+}
+
+scene::ESCENE_NODE_TYPE mdcInstancedMeshNode::getType() const {
+	return ESNT_INSTANCED_MESH;
+}
+
+/*------------------------------------------------------------------------------
+; mdcInstancedMeshNode::replicate()
+;
+; Builds the buffer holding the copies of a buffer of a level, each tagged
+; with its copy number, with no more copies than there are instances. Does
+; nothing if the buffer already has that many, and leaves buffers that fit
+; less than two copies alone.
+;-----------------------------------------------------------------------------*/
+void mdcInstancedMeshNode::replicate( u32 level, u32 b ) {
+	const scene::IMeshBuffer      *    src = levels[ level ]->getMeshBuffer( b );
+	const video::S3DVertex        *    vertices;
+	const u16                     *    indices;
+	scene::SMeshBufferLightMap    *    out;
+	u32                                slot = level * materials.size() + b;
+	u32                                n;
+
+	if ( src->getVertexType() != video::EVT_STANDARD || src->getIndexType() != video::EIT_16BIT ||
+	     src->getVertexCount() == 0 ) {
+		return;
+	}
+
+	n = core::min_( ( u32 )INSTANCE_BATCH, 65536 / src->getVertexCount(), instances.size() );
+	if ( n < 2 || n == copies[ slot ] ) {
+		return;
+	}
+
+	// Instances were added since the last one was built.
+	if ( replicas[ slot ] != NULL ) {
+		SceneManager->getVideoDriver()->removeHardwareBuffer( replicas[ slot ] );
+		replicas[ slot ]->drop();
+	}
+
+	vertices = static_cast< const video::S3DVertex * >( src->getVertices() );
+	indices  = src->getIndices();
+	out      = new scene::SMeshBufferLightMap();
+
+	out->Vertices.reallocate( n * src->getVertexCount() );
+	out->Indices.reallocate( n * src->getIndexCount() );
+
+	for ( u32 c = 0; c < n; c++ ) {
+		for ( u32 v = 0; v < src->getVertexCount(); v++ ) {
+			out->Vertices.push_back( video::S3DVertex2TCoords( vertices[ v ].Pos, vertices[ v ].Normal, vertices[ v ].Color,
+			                                                   vertices[ v ].TCoords, core::vector2df( ( f32 )c, 0.0f ) ) );
+		}
+
+		for ( u32 i = 0; i < src->getIndexCount(); i++ ) {
+			out->Indices.push_back( ( u16 )( indices[ i ] + c * src->getVertexCount() ) );
+		}
+	}
+
+	out->recalculateBoundingBox();
+	out->setHardwareMappingHint( scene::EHM_STATIC );
+
+	replicas[ slot ] = out;
+	copies[ slot ]   = n;
+}
+
+/*------------------------------------------------------------------------------
+; mdcInstancedMeshNode::cullInstances()
+;
+; Sorts the instances whose box is not fully outside a frustum plane by their
+; detail level. Returns how many there are.
+;-----------------------------------------------------------------------------*/
+u32 mdcInstancedMeshNode::cullInstances() {
+	const scene::ICameraSceneNode  *   camera = SceneManager->getActiveCamera();
+	const scene::SViewFrustum      *   frustum;
+	core::vector3df                    eye;
+	f32                                tanHalfFov;
+	bool                               inside;
+	u32                                count = 0;
+
+	for ( u32 l = 0; l < LOD_LEVELS; l++ ) {
+		visible[ l ].set_used( 0 );
+	}
+
+	if ( camera == NULL ) {
+		return 0;
+	}
+
+	frustum    = camera->getViewFrustum();
+	eye        = camera->getAbsolutePosition();
+	tanHalfFov = tanf( camera->getFOV() * 0.5f );
+
+	for ( u32 i = 0; i < boxes.size(); i++ ) {
+		inside = shown[ i ];
+
+		for ( u32 p = 0; p < scene::SViewFrustum::VF_PLANE_COUNT && inside; p++ ) {
+			if ( boxes[ i ].classifyPlaneRelation( frustum->planes[ p ] ) == core::ISREL3D_FRONT ) {
+				inside = false;
+			}
+		}
+
+		if ( inside ) {
+			visible[ selectLevel( i, eye, tanHalfFov ) ].push_back( i );
+			count++;
+		}
+	}
+
+	return count;
+}
+
+/*------------------------------------------------------------------------------
+; mdcInstancedMeshNode::selectLevel()
+;
+; Returns the detail level of an instance for its current size on screen. The
+; level only changes once the size is LOD_HYSTERESIS past a switch size.
+;-----------------------------------------------------------------------------*/
+u32 mdcInstancedMeshNode::selectLevel( u32 i, const core::vector3df & eye, f32 tanHalfFov ) {
+	f32 radius   = boxes[ i ].getExtent().getLength() * 0.5f;
+	f32 distance = boxes[ i ].getCenter().getDistanceFrom( eye );
+	f32 size     = 1.0f;
+	u32 level    = lods[ i ];
+
+	if ( distance > radius && tanHalfFov > 0.0f ) {
+		size = radius / ( distance * tanHalfFov );
+	}
+
+	while ( level + 1 < levels.size() && size < LOD_SCREEN_SIZE / ( 1 << level ) * ( 1.0f - LOD_HYSTERESIS ) ) {
+		level++;
+	}
+
+	while ( level > 0 && size > LOD_SCREEN_SIZE / ( 1 << ( level - 1 ) ) * ( 1.0f + LOD_HYSTERESIS ) ) {
+		level--;
+	}
+
+	lods[ i ] = level;
+
+	return level;
+}
+
+/*------------------------------------------------------------------------------
+; mdcInstancedMeshNode::drawReplicated()
+;
+; Draws the visible instances of a level as many at a time as the buffer
+; has copies. Unused copies of the last draw get a zero matrix, which
+; collapses them to a point.
+;-----------------------------------------------------------------------------*/
+void mdcInstancedMeshNode::drawReplicated( video::IVideoDriver * driver, u32 level, u32 b ) {
+	const core::array< u32 > & shownNow = visible[ level ];
+	scene::IMeshBuffer       * replica  = replicas[ level * materials.size() + b ];
+	u32                        batch    = copies[ level * materials.size() + b ];
+	video::SMaterial           material = materials[ b ];
+	f32                    *   out;
+	const f32              *   m;
+	u32                        n;
+
+	material.MaterialType = shader->getMaterialType();
+
+	driver->setTransform( video::ETS_WORLD, core::IdentityMatrix );
+	driver->setMaterial( material );
+
+	for ( u32 first = 0; first < shownNow.size(); first += batch ) {
+		n = core::min_( batch, shownNow.size() - first );
+
+		for ( u32 c = 0; c < batch; c++ ) {
+			out = constants.pointer() + c * INSTANCE_FLOATS;
+
+			if ( c >= n ) {
+				memset( out, 0, sizeof( f32 ) * INSTANCE_FLOATS );
+				continue;
+			}
+
+			// Rows of the column major matrix.
+			m = instances[ shownNow[ first + c ] ].pointer();
+			for ( u32 r = 0; r < 3; r++ ) {
+				out[ r * 4 + 0 ] = m[ r ];
+				out[ r * 4 + 1 ] = m[ r + 4 ];
+				out[ r * 4 + 2 ] = m[ r + 8 ];
+				out[ r * 4 + 3 ] = m[ r + 12 ];
+			}
+		}
+
+		shader->setInstances( constants.pointer() );
+		driver->drawMeshBuffer( replica );
+	}
+
+	shader->setInstances( NULL );
+}
+
+void mdcInstancedMeshNode::drawSingle( video::IVideoDriver * driver, u32 level, u32 b ) {
+	const scene::IMeshBuffer * buffer = levels[ level ]->getMeshBuffer( b );
+
+	driver->setMaterial( materials[ b ] );
+
+	for ( u32 i = 0; i < visible[ level ].size(); i++ ) {
+		driver->setTransform( video::ETS_WORLD, instances[ visible[ level ][ i ] ] );
+		driver->drawMeshBuffer( buffer );
+	}
+}
@@ -0,0 +1,109 @@
+/*------------------------------------------------------------------------------
+; File:          InstancedMeshNode.hpp
+; Description:   Declaration of the instanced mesh scene node class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#ifndef INSTANCEDMESHNODE_H
+#define INSTANCEDMESHNODE_H
+
+#include <irrlicht.h>
+
+#include "definitions.hpp"
+#include "MeshSimplifier.hpp"
+
+using namespace irr;
+
+// Screen size, the radius of an instance over half the screen height, below
+// which the first detail level switches to the next. Each following switch
+// is at half the size of the one before it.
+#define LOD_SCREEN_SIZE     0.25f
+
+// Fraction around a switch size an instance must go past before its level
+// changes, so instances near it do not flicker between levels.
+#define LOD_HYSTERESIS      0.15f
+
+// Node type returned by mdcInstancedMeshNode::getType().
+#define ESNT_INSTANCED_MESH ( ( scene::ESCENE_NODE_TYPE )MAKE_IRR_ID( 'm', 'i', 'n', 's' ) )
+
+/*------------------------------------------------------------------------------
+; Draws every placement of one mesh. With an instancing shader, the buffers
+; of meshes placed more than once are replicated once per instance, up to
+; INSTANCE_BATCH or as often as 16 bit indices allow, the first time two of
+; them are visible, and the visible instances are drawn that many per call.
+; Without one, for buffers too big to replicate and when a single instance
+; is visible, each visible instance is drawn on its own, which still saves
+; the scene graph work of a node per placement. The node
+; sits at the origin, its box holds every instance and each instance is
+; culled against the view frustum. Instances can also be hidden one by one.
+; Simplified versions of the mesh can be added as detail levels, each
+; instance then uses the one that suits its size on screen.
+;-----------------------------------------------------------------------------*/
+class mdcInstancedMeshNode : public scene::ISceneNode {
+	public:
+		mdcInstancedMeshNode( scene::IMesh *, mdcInstanceShader *, scene::ISceneNode *, scene::ISceneManager *, s32 = -1 );
+		virtual ~mdcInstancedMeshNode();
+
+		void                                    addLevel( scene::IMesh * );
+		void                                    addInstance( const core::matrix4 & );
+		u32                                     getInstanceCount()                  const;
+		const core::aabbox3d< f32 > &           getInstanceBox( u32 )               const;
+		void                                    setInstanceVisible( u32, bool );
+		u32                                     getDrawnCount()                     const;
+
+		virtual void                            OnRegisterSceneNode();
+		virtual void                            render();
+		virtual const core::aabbox3d< f32 > &   getBoundingBox()                    const;
+		virtual u32                             getMaterialCount()                  const;
+		virtual video::SMaterial &              getMaterial( u32 );
+		virtual scene::ESCENE_NODE_TYPE         getType()                           const;
+
+	private:
+		core::array< scene::IMesh * >           levels;
+		mdcInstanceShader                *      shader;
+		core::array< video::SMaterial >         materials;
+		core::aabbox3d< f32 >                   box;
+
+		// World matrix, box, visibility and detail level of every instance.
+		core::array< core::matrix4 >            instances;
+		core::array< core::aabbox3d< f32 > >    boxes;
+		core::array< bool >                     shown;
+		core::array< u32 >                      lods;
+
+		// Per buffer of each level, the replicated buffer and its number of
+		// copies, NULL and one when the buffer is drawn per instance or has
+		// not been needed yet.
+		core::array< scene::IMeshBuffer * >     replicas;
+		core::array< u32 >                      copies;
+
+		// Scratch for each frame, the visible instances of each level.
+		core::array< u32 >                      visible[ LOD_LEVELS ];
+		core::array< f32 >                      constants;
+		u32                                     drawn;
+
+		mdcInstancedMeshNode( mdcInstancedMeshNode const & );
+		mdcInstancedMeshNode & operator=( mdcInstancedMeshNode const & );
+
+		void                                    replicate( u32, u32 );
+		u32                                     cullInstances();
+		u32                                     selectLevel( u32, const core::vector3df &, f32 );
+		void                                    drawReplicated( video::IVideoDriver *, u32, u32 );
+		void                                    drawSingle( video::IVideoDriver *, u32, u32 );
+};
+
+#endif // INSTANCEDMESHNODE_H
@@ -0,0 +1,170 @@
+/*------------------------------------------------------------------------------
+; File:          MappedFile.cpp
+; Description:   Implementation of the memory mapped file class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#if defined( _WIN32 ) || defined( __MINGW32__ )
+#include <windows.h>
+#elif defined( __linux__ )
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#else
+#error "Not a GNU/Linux or Windows platform."
+#endif
+
+#include "MappedFile.hpp"
+
+mdcMappedFile::mdcMappedFile() {
+	data = NULL;
+	size = 0;
+#if defined( _WIN32 ) || defined( __MINGW32__ )
+	file    = INVALID_HANDLE_VALUE;
+	mapping = NULL;
+#endif
+}
+
+mdcMappedFile::~mdcMappedFile() {
+	close();
+}
+
+/*------------------------------------------------------------------------------
+; mdcMappedFile::open()
+;
+; Maps the given file. Returns false if it does not exist, is empty or cannot
+; be mapped.
+;-----------------------------------------------------------------------------*/
+bool mdcMappedFile::open( const char * path ) {
+	close();
+
+#if defined( _WIN32 ) || defined( __MINGW32__ )
+	LARGE_INTEGER fileSize;
+
+	file = CreateFileA( path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+	if ( file == INVALID_HANDLE_VALUE ) {
+		return false;
+	}
+
+	if ( !GetFileSizeEx( file, &fileSize ) || fileSize.QuadPart == 0 ) {
+		close();
+		return false;
+	}
+
+	mapping = CreateFileMappingA( file, NULL, PAGE_WRITECOPY, 0, 0, NULL );
+	if ( mapping == NULL ) {
+		close();
+		return false;
+	}
+
+	data = ( char * )MapViewOfFile( mapping, FILE_MAP_COPY, 0, 0, 0 );
+	if ( data == NULL ) {
+		close();
+		return false;
+	}
+
+	size = ( size_t )fileSize.QuadPart;
+#elif defined( __linux__ )
+	struct stat info;
+	void *      ptr;
+	int         fd;
+
+	fd = ::open( path, O_RDONLY );
+	if ( fd < 0 ) {
+		return false;
+	}
+
+	if ( fstat( fd, &info ) != 0 || info.st_size == 0 ) {
+		::close( fd );
+		return false;
+	}
+
+	ptr = mmap( NULL, info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+	::close( fd );
+
+	if ( ptr == MAP_FAILED ) {
+		return false;
+	}
+
+	data = ( char * )ptr;
+	size = info.st_size;
+#else
+#error "Not a GNU/Linux or Windows platform."
+#endif
+
+	return true;
+}
+
+void mdcMappedFile::close() {
+#if defined( _WIN32 ) || defined( __MINGW32__ )
+	if ( data != NULL )
+		UnmapViewOfFile( data );
+	if ( mapping != NULL )
+		CloseHandle( mapping );
+	if ( file != INVALID_HANDLE_VALUE )
+		CloseHandle( file );
+
+	mapping = NULL;
+	file    = INVALID_HANDLE_VALUE;
+#elif defined( __linux__ )
+	if ( data != NULL )
+		munmap( data, size );
+#else
+#error "Not a GNU/Linux or Windows platform."
+#endif
+
+	data = NULL;
+	size = 0;
+}
+
+bool mdcMappedFile::isOpen() const {
+	return data != NULL;
+}
+
+char * mdcMappedFile::getData() const {
+	return data;
+}
+
+size_t mdcMappedFile::getSize() const {
+	return size;
+}
+
+/*------------------------------------------------------------------------------
+; mdcMappedFile::isNewer()
+;
+; Returns true if the first file exists and is not older than the second one,
+; or if the second one does not exist.
+;-----------------------------------------------------------------------------*/
+bool mdcMappedFile::isNewer( const char * path, const char * source ) {
+	struct stat pathInfo;
+	struct stat sourceInfo;
+
+	if ( stat( path, &pathInfo ) != 0 ) {
+		return false;
+	}
+
+	if ( stat( source, &sourceInfo ) != 0 ) {
+		return true;
+	}
+
+	return pathInfo.st_mtime >= sourceInfo.st_mtime;
+}
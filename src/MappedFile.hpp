@@ -0,0 +1,60 @@
+/*------------------------------------------------------------------------------
+; File:          MappedFile.hpp
+; Description:   Declaration of the memory mapped file class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+
+#include "definitions.hpp"
+
+/*------------------------------------------------------------------------------
+; A whole file mapped copy-on-write into memory. Writes to the mapping are
+; private to the process and never reach the file.
+;-----------------------------------------------------------------------------*/
+class mdcMappedFile {
+	public:
+		mdcMappedFile();
+		~mdcMappedFile();
+
+		bool                      open( const char * );
+		void                      close();
+
+		bool                      isOpen()                const;
+		char                 *    getData()               const;
+		size_t                    getSize()               const;
+
+		static bool               isNewer( const char *, const char * );
+
+	private:
+		char                 *    data;
+		size_t                    size;
+#if defined( _WIN32 ) || defined( __MINGW32__ )
+		void                 *    file;
+		void                 *    mapping;
+#endif
+
+		mdcMappedFile( mdcMappedFile const & ) { };
+		mdcMappedFile & operator=( mdcMappedFile const & ) { return *this; }
+};
+
+#endif // MAPPEDFILE_H
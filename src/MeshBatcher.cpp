@@ -0,0 +1,230 @@
+/*------------------------------------------------------------------------------
+; File:          MeshBatcher.cpp
+; Description:   Implementation of the static mesh batcher class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#include "MeshBatcher.hpp"
+
+// Marks a source vertex not yet copied to the current output buffer.
+#define NO_VERTEX  0xFFFFFFFF
+
+mdcMeshBatcher::mdcMeshBatcher() { }
+
+mdcMeshBatcher::~mdcMeshBatcher() {
+	clear();
+}
+
+bool mdcMeshBatcher::canBatch( const scene::IMeshBuffer * buffer ) {
+	return buffer->getVertexType() == video::EVT_STANDARD && buffer->getIndexType() == video::EIT_16BIT;
+}
+
+/*------------------------------------------------------------------------------
+; mdcMeshBatcher::addBuffer()
+;
+; Queues a buffer to be drawn with the given material, which replaces the
+; buffer's own. The buffer is kept until build() or clear().
+;-----------------------------------------------------------------------------*/
+void mdcMeshBatcher::addBuffer( const scene::IMeshBuffer * buffer, const video::SMaterial & material ) {
+	batchSource_t source;
+
+	if ( !canBatch( buffer ) || buffer->getIndexCount() < 3 ) {
+		return;
+	}
+
+	buffer->grab();
+
+	source.buffer   = buffer;
+	source.material = getMaterialIndex( material );
+	sources.push_back( source );
+}
+
+/*------------------------------------------------------------------------------
+; mdcMeshBatcher::build()
+;
+; Copies the queued triangles into the chunk buffers and adds a mesh node for
+; every chunk. Vertices shared by triangles of the same source, chunk and
+; output buffer are copied once. Returns the number of nodes added.
+;-----------------------------------------------------------------------------*/
+u32 mdcMeshBatcher::build( scene::ISceneManager * smgr ) {
+	core::array< batchTriangle_t >  triangles;
+	core::array< u32 >              remap;
+	core::array< u32 >              touched;
+	scene::SMesh               *    mesh   = NULL;
+	scene::SMeshBuffer         *    out    = NULL;
+	u32                             nodes  = 0;
+	u32                             maxVertices = 0;
+	bool                            newRun;
+	bool                            full;
+
+	if ( sources.empty() ) {
+		return 0;
+	}
+
+	for ( u32 i = 0; i < sources.size(); i++ ) {
+		maxVertices = core::max_( maxVertices, sources[ i ].buffer->getVertexCount() );
+	}
+
+	remap.set_used( maxVertices );
+	for ( u32 i = 0; i < maxVertices; i++ ) {
+		remap[ i ] = NO_VERTEX;
+	}
+
+	sortTriangles( triangles );
+
+	for ( u32 i = 0; i < triangles.size(); i++ ) {
+		const batchTriangle_t     &    t        = triangles[ i ];
+		const scene::IMeshBuffer  *    src      = sources[ t.source ].buffer;
+		const video::S3DVertex    *    vertices = static_cast< const video::S3DVertex * >( src->getVertices() );
+		const u16                 *    indices  = src->getIndices();
+
+		// Every chunk is a mesh of its own.
+		if ( i == 0 || t.key / materials.size() != triangles[ i - 1 ].key / materials.size() ) {
+			if ( mesh != NULL && addChunk( smgr, mesh ) ) {
+				nodes++;
+			}
+			mesh = new scene::SMesh();
+		}
+
+		newRun = i == 0 || t.key != triangles[ i - 1 ].key || t.source != triangles[ i - 1 ].source;
+		full   = out != NULL && out->Vertices.size() + 3 > BATCH_MAX_VERTICES;
+
+		// The remapping is only valid for one source and one output buffer.
+		if ( newRun || full ) {
+			for ( u32 j = 0; j < touched.size(); j++ ) {
+				remap[ touched[ j ] ] = NO_VERTEX;
+			}
+			touched.set_used( 0 );
+		}
+
+		if ( i == 0 || t.key != triangles[ i - 1 ].key || full ) {
+			out = new scene::SMeshBuffer();
+			out->Material = materials[ t.key % materials.size() ];
+			mesh->addMeshBuffer( out );
+			out->drop();
+		}
+
+		for ( u32 k = 0; k < 3; k++ ) {
+			u16 v = indices[ t.first + k ];
+
+			if ( remap[ v ] == NO_VERTEX ) {
+				remap[ v ] = out->Vertices.size();
+				out->Vertices.push_back( vertices[ v ] );
+				touched.push_back( v );
+			}
+			out->Indices.push_back( ( u16 )remap[ v ] );
+		}
+	}
+
+	if ( mesh != NULL && addChunk( smgr, mesh ) ) {
+		nodes++;
+	}
+
+	clear();
+
+	return nodes;
+}
+
+void mdcMeshBatcher::clear() {
+	for ( u32 i = 0; i < sources.size(); i++ ) {
+		sources[ i ].buffer->drop();
+	}
+
+	sources.clear();
+	materials.clear();
+}
+
+u32 mdcMeshBatcher::getMaterialIndex( const video::SMaterial & material ) {
+	for ( u32 i = 0; i < materials.size(); i++ ) {
+		if ( !( materials[ i ] != material ) ) {
+			return i;
+		}
+	}
+
+	materials.push_back( material );
+
+	return materials.size() - 1;
+}
+
+/*------------------------------------------------------------------------------
+; mdcMeshBatcher::sortTriangles()
+;
+; Gives every queued triangle the chunk its centroid falls in and sorts them
+; by chunk, material and source. Chunks are cubes, BATCH_GRID of them span
+; the longest side of the bounding box of all the sources.
+;-----------------------------------------------------------------------------*/
+void mdcMeshBatcher::sortTriangles( core::array< batchTriangle_t > & triangles ) const {
+	core::aabbox3df     box      = sources[ 0 ].buffer->getBoundingBox();
+	core::vector3df     extent;
+	core::vector3df     centroid;
+	batchTriangle_t     t;
+	f32                 size;
+	u32                 total    = 0;
+	s32                 x, y, z;
+
+	for ( u32 i = 0; i < sources.size(); i++ ) {
+		box.addInternalBox( sources[ i ].buffer->getBoundingBox() );
+		total += sources[ i ].buffer->getIndexCount() / 3;
+	}
+
+	extent = box.getExtent();
+	size   = core::max_( extent.X, extent.Y, extent.Z ) / BATCH_GRID;
+	if ( size <= 0.0f ) {
+		size = 1.0f;
+	}
+
+	triangles.reallocate( total );
+
+	for ( u32 i = 0; i < sources.size(); i++ ) {
+		const scene::IMeshBuffer  *    src      = sources[ i ].buffer;
+		const video::S3DVertex    *    vertices = static_cast< const video::S3DVertex * >( src->getVertices() );
+		const u16                 *    indices  = src->getIndices();
+
+		for ( u32 j = 0; j + 2 < src->getIndexCount(); j += 3 ) {
+			centroid = ( vertices[ indices[ j ] ].Pos + vertices[ indices[ j + 1 ] ].Pos +
+			             vertices[ indices[ j + 2 ] ].Pos ) / 3.0f - box.MinEdge;
+
+			x = core::clamp( ( s32 )( centroid.X / size ), 0, BATCH_GRID - 1 );
+			y = core::clamp( ( s32 )( centroid.Y / size ), 0, BATCH_GRID - 1 );
+			z = core::clamp( ( s32 )( centroid.Z / size ), 0, BATCH_GRID - 1 );
+
+			t.key    = ( ( z * BATCH_GRID + y ) * BATCH_GRID + x ) * materials.size() + sources[ i ].material;
+			t.source = i;
+			t.first  = j;
+			triangles.push_back( t );
+		}
+	}
+
+	triangles.sort();
+}
+
+// Adds a mesh node for a finished chunk and releases the mesh.
+bool mdcMeshBatcher::addChunk( scene::ISceneManager * smgr, scene::SMesh * mesh ) const {
+	scene::IMeshSceneNode * node;
+
+	for ( u32 i = 0; i < mesh->getMeshBufferCount(); i++ ) {
+		mesh->getMeshBuffer( i )->recalculateBoundingBox();
+	}
+	mesh->recalculateBoundingBox();
+	mesh->setHardwareMappingHint( scene::EHM_STATIC );
+
+	node = smgr->addMeshSceneNode( mesh );
+	mesh->drop();
+
+	return node != NULL;
+}
@@ -0,0 +1,90 @@
+/*------------------------------------------------------------------------------
+; File:          MeshBatcher.hpp
+; Description:   Declaration of the static mesh batcher class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#ifndef MESHBATCHER_H
+#define MESHBATCHER_H
+
+#include <irrlicht.h>
+
+#include "definitions.hpp"
+
+using namespace irr;
+
+// Chunks along the longest side of the batched geometry.
+#define BATCH_GRID          8
+
+// Vertices a 16 bit index buffer can address.
+#define BATCH_MAX_VERTICES  65535
+
+// A mesh buffer waiting to be batched and the index of its material.
+typedef struct BATCH_SOURCE {
+	const scene::IMeshBuffer  *     buffer;
+	u32                             material;
+} batchSource_t;
+
+// A triangle of a source, sorted by chunk and material.
+typedef struct BATCH_TRIANGLE {
+	u32                             key;
+	u32                             source;
+	u32                             first;
+
+	bool operator<( const BATCH_TRIANGLE & other ) const {
+		if ( key != other.key ) {
+			return key < other.key;
+		}
+		if ( source != other.source ) {
+			return source < other.source;
+		}
+		return first < other.first;
+	}
+} batchTriangle_t;
+
+/*------------------------------------------------------------------------------
+; Merges static mesh buffers that share a material into a few large buffers.
+; The geometry is split into a grid of chunks so each chunk can still be
+; culled on its own, and build() adds one mesh node per chunk holding one
+; buffer per material. Buffers are only split further when they would run
+; out of 16 bit indices. Only standard vertices with 16 bit indices can be
+; batched, and the geometry must already be in world space.
+;-----------------------------------------------------------------------------*/
+class mdcMeshBatcher {
+	public:
+		mdcMeshBatcher();
+		~mdcMeshBatcher();
+
+		static bool                         canBatch( const scene::IMeshBuffer * );
+		void                                addBuffer( const scene::IMeshBuffer *, const video::SMaterial & );
+		u32                                 build( scene::ISceneManager * );
+		void                                clear();
+
+	private:
+		core::array< video::SMaterial >     materials;
+		core::array< batchSource_t >        sources;
+
+		mdcMeshBatcher( mdcMeshBatcher const & ) { };
+		mdcMeshBatcher & operator=( mdcMeshBatcher const & ) { return *this; }
+
+		u32                                 getMaterialIndex( const video::SMaterial & );
+		void                                sortTriangles( core::array< batchTriangle_t > & ) const;
+		bool                                addChunk( scene::ISceneManager *, scene::SMesh * )  const;
+};
+
+#endif // MESHBATCHER_H
@@ -0,0 +1,669 @@
+/*------------------------------------------------------------------------------
+; File:          MeshDecoder.cpp
+; Description:   Implementation of the parallel mesh decoder class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+
+#include <iostream>
+
+#include "ThreadPool.hpp"
+#include "MeshDecoder.hpp"
+#include "Trace.hpp"
+
+using std::cerr;
+using std::endl;
+
+// Largest vertex count addressable by the 16 bit index buffers.
+#define MAX_BUFFER_VERTICES 65535
+
+// Corner of a face, as indices into the position, uv and normal lists.
+typedef struct OBJ_CORNER {
+	s32 v;
+	s32 t;
+	s32 n;
+
+	bool operator==( const OBJ_CORNER & o ) const {
+		return v == o.v && t == o.t && n == o.n;
+	}
+
+	bool operator<( const OBJ_CORNER & o ) const {
+		if ( v != o.v ) return v < o.v;
+		if ( t != o.t ) return t < o.t;
+		return n < o.n;
+	}
+} objCorner_t;
+
+// Mesh buffer being filled for one material, with its welding table.
+typedef struct OBJ_GROUP {
+	core::stringc                        material;
+	scene::SMeshBuffer               *   buffer;
+	core::map< objCorner_t, u16 >    *   welds;
+} objGroup_t;
+
+static scene::SMesh *   parseObj( const char *, core::array< core::stringc > &, core::stringc &, bool & );
+static void             parseMtl( const char *, mtlLibrary_t * );
+static void             defaultMaterial( video::SMaterial & );
+static const char *     skipSpace( const char * );
+static const char *     skipLine( const char * );
+static const char *     readWord( const char *, core::stringc & );
+static const char *     readLastWord( const char *, core::stringc & );
+static const char *     readVec3( const char *, core::vector3df & );
+static bool             isKeyword( const char *, const char * );
+
+mdcMeshDecoder::mdcMeshDecoder( IrrlichtDevice * device, mdcThreadPool * pool ) {
+	smgr       = device->getSceneManager();
+	driver     = device->getVideoDriver();
+	fs         = device->getFileSystem();
+	this->pool = pool;
+	cancelled  = false;
+
+	pthread_mutex_init( &lock, NULL );
+	pthread_cond_init( &jobDone, NULL );
+}
+
+/*------------------------------------------------------------------------------
+; mdcMeshDecoder::~mdcMeshDecoder()
+;
+; Jobs that have not started yet return without parsing, the ones already
+; running are waited for. Must be called before the pool is destroyed.
+;-----------------------------------------------------------------------------*/
+mdcMeshDecoder::~mdcMeshDecoder() {
+	pthread_mutex_lock( &lock );
+	cancelled = true;
+	for ( u32 i = 0; i < jobs.size(); i++ ) {
+		while ( !jobs[ i ]->done ) {
+			pthread_cond_wait( &jobDone, &lock );
+		}
+	}
+	pthread_mutex_unlock( &lock );
+
+	for ( u32 i = 0; i < jobs.size(); i++ ) {
+		if ( jobs[ i ]->mesh != NULL )
+			jobs[ i ]->mesh->drop();
+		for ( u32 l = 1; l < LOD_LEVELS; l++ ) {
+			if ( jobs[ i ]->levels[ l ] != NULL )
+				jobs[ i ]->levels[ l ]->drop();
+		}
+		delete jobs[ i ];
+	}
+
+	for ( u32 i = 0; i < libraries.size(); i++ ) {
+		delete libraries[ i ];
+	}
+
+	pthread_cond_destroy( &jobDone );
+	pthread_mutex_destroy( &lock );
+}
+
+/*------------------------------------------------------------------------------
+; mdcMeshDecoder::request()
+;
+; Reads the file and queues it for decoding, and for simplification into its
+; detail levels if levels is true. Returns false if the file is not an OBJ, is
+; already in the mesh cache or queued, or cannot be opened.
+;-----------------------------------------------------------------------------*/
+bool mdcMeshDecoder::request( const io::path & name, bool levels ) {
+	io::IReadFile * file;
+	decodeJob_t   * job;
+
+	if ( !core::hasFileExtension( name, "obj" ) ) {
+		return false;
+	}
+
+	if ( smgr->getMeshCache()->isMeshLoaded( name ) || isPending( name ) ) {
+		return false;
+	}
+
+	file = fs->createAndOpenFile( name );
+	if ( file == NULL ) {
+		return false;
+	}
+
+	job             = new decodeJob_t;
+	job->owner      = this;
+	job->name       = name;
+	job->dir        = fs->getFileDir( file->getFileName() ) + "/";
+	job->size       = file->getSize();
+	job->data       = new char[ job->size + 1 ];
+	job->mesh       = NULL;
+	job->wantLevels = levels;
+	job->hasNormals = false;
+
+	for ( u32 l = 0; l < LOD_LEVELS; l++ ) {
+		job->levels[ l ] = NULL;
+	}
+	job->done       = false;
+
+	job->size = file->read( job->data, job->size );
+	job->data[ job->size ] = '\0';
+	file->drop();
+
+	jobs.push_back( job );
+	pool->submit( decodeMain, job );
+
+	return true;
+}
+
+/*------------------------------------------------------------------------------
+; mdcMeshDecoder::collect()
+;
+; Adds every decoded mesh to the mesh cache. Returns the number of files still
+; being decoded.
+;-----------------------------------------------------------------------------*/
+u32 mdcMeshDecoder::collect() {
+	core::array< decodeJob_t * > finished;
+
+	pthread_mutex_lock( &lock );
+	for ( u32 i = 0; i < jobs.size(); ) {
+		if ( jobs[ i ]->done ) {
+			finished.push_back( jobs[ i ] );
+			jobs.erase( i );
+		} else {
+			i++;
+		}
+	}
+	pthread_mutex_unlock( &lock );
+
+	for ( u32 i = 0; i < finished.size(); i++ ) {
+		publish( finished[ i ] );
+		delete finished[ i ];
+	}
+
+	return jobs.size();
+}
+
+u32 mdcMeshDecoder::getPendingCount() const {
+	return jobs.size();
+}
+
+bool mdcMeshDecoder::isPending( const io::path & name ) const {
+	for ( u32 i = 0; i < jobs.size(); i++ ) {
+		if ( jobs[ i ]->name == name ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void mdcMeshDecoder::decodeMain( void * arg ) {
+	decodeJob_t    * job   = static_cast< decodeJob_t * >( arg );
+	mdcMeshDecoder * owner = job->owner;
+	bool             skip;
+
+	pthread_mutex_lock( &owner->lock );
+	skip = owner->cancelled;
+	pthread_mutex_unlock( &owner->lock );
+
+	if ( !skip ) {
+		TRACE_SCOPE_ARG( "parseObj", job->name.c_str() );
+		job->mesh = parseObj( job->data, job->bufferMaterials, job->mtllib, job->hasNormals );
+	}
+
+	if ( !skip && job->mesh != NULL && job->wantLevels ) {
+		TRACE_SCOPE_ARG( "simplify", job->name.c_str() );
+
+		// Each level is made from the one before it, which is cheaper and
+		// keeps the levels close to each other. Small meshes get fewer.
+		job->levels[ 0 ] = job->mesh;
+		for ( u32 l = 1; l < LOD_LEVELS && mdcMeshSimplifier::canSimplify( job->levels[ l - 1 ] ); l++ ) {
+			job->levels[ l ] = mdcMeshSimplifier::createLevel( job->levels[ l - 1 ], LOD_RATIO );
+		}
+		job->levels[ 0 ] = NULL;
+	}
+
+	delete[] job->data;
+	job->data = NULL;
+
+	pthread_mutex_lock( &owner->lock );
+	job->done = true;
+	pthread_cond_broadcast( &owner->jobDone );
+	pthread_mutex_unlock( &owner->lock );
+}
+
+/*------------------------------------------------------------------------------
+; mdcMeshDecoder::publish()
+;
+; Applies the materials of a decoded mesh and adds it to the mesh cache under
+; the requested name, along with its detail levels. Runs on the main thread
+; since it loads textures.
+;-----------------------------------------------------------------------------*/
+void mdcMeshDecoder::publish( decodeJob_t * job ) {
+	const mtlLibrary_t    *    lib = NULL;
+	scene::SMeshBuffer    *    buffer;
+	scene::SAnimatedMesh  *    animated;
+	video::ITexture       *    texture;
+	io::path                   texPath;
+
+	if ( job->mesh == NULL ) {
+		// getMesh() will try the stock loader.
+		cerr << "mdcMeshDecoder::publish() - Could not decode " << job->name.c_str() << endl;
+		return;
+	}
+
+	if ( !job->mtllib.empty() ) {
+		lib = getLibrary( job->dir + job->mtllib );
+	}
+
+	for ( u32 i = 0; i < job->mesh->getMeshBufferCount(); i++ ) {
+		buffer = static_cast< scene::SMeshBuffer * >( job->mesh->getMeshBuffer( i ) );
+
+		defaultMaterial( buffer->Material );
+
+		if ( lib != NULL ) {
+			for ( u32 j = 0; j < lib->materials.size(); j++ ) {
+				if ( lib->materials[ j ].name == job->bufferMaterials[ i ] ) {
+					buffer->Material = lib->materials[ j ].material;
+
+					if ( !lib->materials[ j ].texture.empty() ) {
+						texPath = resolveTexture( job->dir, lib->materials[ j ].texture );
+						TRACE_SCOPE_ARG( "getTexture", texPath.c_str() );
+
+						texture = driver->getTexture( texPath );
+						buffer->Material.setTexture( 0, texture );
+					}
+					break;
+				}
+			}
+		}
+
+		// Like the stock loader, vertex colors take the diffuse color.
+		for ( u32 v = 0; v < buffer->Vertices.size(); v++ ) {
+			buffer->Vertices[ v ].Color = buffer->Material.DiffuseColor;
+		}
+
+		if ( !job->hasNormals ) {
+			smgr->getMeshManipulator()->recalculateNormals( buffer );
+		}
+	}
+
+	animated = new scene::SAnimatedMesh( job->mesh );
+	animated->recalculateBoundingBox();
+	smgr->getMeshCache()->addMesh( job->name, animated );
+
+	animated->drop();
+
+	for ( u32 l = 1; l < LOD_LEVELS; l++ ) {
+		if ( job->levels[ l ] == NULL ) {
+			continue;
+		}
+
+		// Reduced buffers get the material of the one they come from, the
+		// rest are shared with the full mesh.
+		for ( u32 i = 0; i < job->levels[ l ]->getMeshBufferCount(); i++ ) {
+			if ( job->levels[ l ]->getMeshBuffer( i ) == job->mesh->getMeshBuffer( i ) ) {
+				continue;
+			}
+
+			buffer = static_cast< scene::SMeshBuffer * >( job->levels[ l ]->getMeshBuffer( i ) );
+			buffer->Material = job->mesh->getMeshBuffer( i )->getMaterial();
+
+			for ( u32 v = 0; v < buffer->Vertices.size(); v++ ) {
+				buffer->Vertices[ v ].Color = buffer->Material.DiffuseColor;
+			}
+
+			if ( !job->hasNormals ) {
+				smgr->getMeshManipulator()->recalculateNormals( buffer );
+			}
+		}
+
+		animated = new scene::SAnimatedMesh( job->levels[ l ] );
+		animated->recalculateBoundingBox();
+		smgr->getMeshCache()->addMesh( mdcMeshSimplifier::getLevelName( job->name, l ), animated );
+
+		animated->drop();
+		job->levels[ l ]->drop();
+		job->levels[ l ] = NULL;
+	}
+
+	job->mesh->drop();
+	job->mesh = NULL;
+}
+
+const mtlLibrary_t * mdcMeshDecoder::getLibrary( const io::path & path ) {
+	io::IReadFile * file;
+	mtlLibrary_t  * lib;
+	char          * data;
+	long            size;
+
+	for ( u32 i = 0; i < libraries.size(); i++ ) {
+		if ( libraries[ i ]->path == path ) {
+			return libraries[ i ];
+		}
+	}
+
+	lib       = new mtlLibrary_t;
+	lib->path = path;
+	libraries.push_back( lib );
+
+	file = fs->createAndOpenFile( path );
+	if ( file == NULL ) {
+		cerr << "mdcMeshDecoder::getLibrary() - Could not open " << path.c_str() << endl;
+		return lib;
+	}
+
+	size = file->getSize();
+	data = new char[ size + 1 ];
+	size = file->read( data, size );
+	data[ size ] = '\0';
+	file->drop();
+
+	parseMtl( data, lib );
+
+	delete[] data;
+
+	return lib;
+}
+
+io::path mdcMeshDecoder::resolveTexture( const io::path & dir, const io::path & name ) const {
+	if ( fs->existFile( dir + name ) ) {
+		return dir + name;
+	}
+	return name;
+}
+
+/*------------------------------------------------------------------------------
+; parseObj()
+;
+; Parses the OBJ text into one mesh buffer per material, following the stock
+; Irrlicht loader: X is negated to change handedness, V is flipped, polygons
+; are fanned with reversed winding and equal corners share a vertex. Buffers
+; are split before they outgrow 16 bit indices. Returns NULL if there are no
+; faces. Safe to call from any thread.
+;-----------------------------------------------------------------------------*/
+static scene::SMesh * parseObj( const char * p, core::array< core::stringc > & materials, core::stringc & mtllib, bool & hasNormals ) {
+	core::array< core::vector3df >     positions;
+	core::array< core::vector2df >     uvs;
+	core::array< core::vector3df >     normals;
+	core::array< objGroup_t >          groups;
+	core::array< objCorner_t >         corners;
+	core::array< u16 >                 face;
+	core::stringc                      word;
+	core::vector3df                    vec;
+	objCorner_t                        c;
+	video::S3DVertex                   vertex;
+	scene::SMesh                   *   mesh;
+	objGroup_t                         group;
+	u32                                current;
+	f32                                f;
+
+	// Faces before any usemtl go to the default material.
+	group.buffer = new scene::SMeshBuffer();
+	group.welds  = new core::map< objCorner_t, u16 >();
+	groups.push_back( group );
+	current = 0;
+
+	vertex.Color.set( 255, 255, 255, 255 );
+
+	while ( *p != '\0' ) {
+		p = skipSpace( p );
+
+		if ( p[ 0 ] == 'v' && p[ 1 ] == ' ' ) {
+			p = readVec3( p + 2, vec );
+			vec.X = -vec.X;
+			positions.push_back( vec );
+
+		} else if ( p[ 0 ] == 'v' && p[ 1 ] == 'n' ) {
+			p = readVec3( p + 2, vec );
+			vec.X = -vec.X;
+			normals.push_back( vec );
+
+		} else if ( p[ 0 ] == 'v' && p[ 1 ] == 't' ) {
+			core::vector2df uv;
+			p = skipSpace( p + 2 );
+			p = core::fast_atof_move( p, f );
+			uv.X = f;
+			p = skipSpace( p );
+			p = core::fast_atof_move( p, f );
+			uv.Y = 1.0f - f;
+			uvs.push_back( uv );
+
+		} else if ( p[ 0 ] == 'f' && ( p[ 1 ] == ' ' || p[ 1 ] == '\t' ) ) {
+			corners.set_used( 0 );
+			p = skipSpace( p + 1 );
+
+			while ( *p != '\0' && *p != '\n' && *p != '\r' ) {
+				const char * start = p;
+				s32 idx[ 3 ] = { 0, 0, 0 };
+
+				for ( int k = 0; k < 3; k++ ) {
+					if ( ( *p >= '0' && *p <= '9' ) || *p == '-' || *p == '+' ) {
+						idx[ k ] = core::strtol10( p, &p );
+					}
+					if ( *p != '/' ) break;
+					p++;
+				}
+
+				if ( p == start ) {
+					// Not a number, give up on the rest of the line.
+					break;
+				}
+
+				// OBJ indices start at one, negative ones count from the end.
+				c.v = idx[ 0 ] < 0 ? ( s32 )positions.size() + idx[ 0 ] : idx[ 0 ] - 1;
+				c.t = idx[ 1 ] < 0 ? ( s32 )uvs.size() + idx[ 1 ] : idx[ 1 ] - 1;
+				c.n = idx[ 2 ] < 0 ? ( s32 )normals.size() + idx[ 2 ] : idx[ 2 ] - 1;
+
+				if ( c.v >= 0 && c.v < ( s32 )positions.size() ) {
+					if ( c.t >= ( s32 )uvs.size() ) c.t = -1;
+					if ( c.n >= ( s32 )normals.size() ) c.n = -1;
+					corners.push_back( c );
+				}
+
+				p = skipSpace( p );
+			}
+
+			if ( groups[ current ].buffer->Vertices.size() + corners.size() > MAX_BUFFER_VERTICES ) {
+				// Start a new buffer for this material so the face fits in one.
+				group.material = groups[ current ].material;
+				group.buffer   = new scene::SMeshBuffer();
+				group.welds    = new core::map< objCorner_t, u16 >();
+				groups.push_back( group );
+				current = groups.size() - 1;
+			}
+
+			objGroup_t & g = groups[ current ];
+
+			face.set_used( 0 );
+			for ( u32 i = 0; i < corners.size(); i++ ) {
+				core::map< objCorner_t, u16 >::Node * node = g.welds->find( corners[ i ] );
+
+				if ( node != NULL ) {
+					face.push_back( node->getValue() );
+				} else {
+					c = corners[ i ];
+					vertex.Pos     = positions[ c.v ];
+					vertex.TCoords = c.t >= 0 ? uvs[ c.t ] : core::vector2df( 0, 0 );
+					vertex.Normal  = c.n >= 0 ? normals[ c.n ] : core::vector3df( 0, 0, 0 );
+
+					g.welds->insert( c, ( u16 )g.buffer->Vertices.size() );
+					face.push_back( ( u16 )g.buffer->Vertices.size() );
+					g.buffer->Vertices.push_back( vertex );
+				}
+			}
+
+			for ( u32 i = 1; i + 1 < face.size(); i++ ) {
+				g.buffer->Indices.push_back( face[ i + 1 ] );
+				g.buffer->Indices.push_back( face[ i ] );
+				g.buffer->Indices.push_back( face[ 0 ] );
+			}
+
+		} else if ( isKeyword( p, "usemtl" ) ) {
+			p = readLastWord( p + 6, word );
+
+			current = groups.size();
+			for ( u32 i = 0; i < groups.size(); i++ ) {
+				// The last buffer of a material is the one still being filled.
+				if ( groups[ i ].material == word ) {
+					current = i;
+				}
+			}
+
+			if ( current == groups.size() ) {
+				group.material = word;
+				group.buffer   = new scene::SMeshBuffer();
+				group.welds    = new core::map< objCorner_t, u16 >();
+				groups.push_back( group );
+			}
+
+		} else if ( isKeyword( p, "mtllib" ) ) {
+			p = readLastWord( p + 6, mtllib );
+		}
+
+		p = skipLine( p );
+	}
+
+	hasNormals = normals.size() > 0;
+
+	mesh = new scene::SMesh();
+
+	for ( u32 i = 0; i < groups.size(); i++ ) {
+		if ( groups[ i ].buffer->Indices.size() > 0 ) {
+			groups[ i ].buffer->recalculateBoundingBox();
+			mesh->addMeshBuffer( groups[ i ].buffer );
+			materials.push_back( groups[ i ].material );
+		}
+		groups[ i ].buffer->drop();
+		delete groups[ i ].welds;
+	}
+
+	if ( mesh->getMeshBufferCount() == 0 ) {
+		mesh->drop();
+		return NULL;
+	}
+
+	mesh->recalculateBoundingBox();
+
+	return mesh;
+}
+
+/*------------------------------------------------------------------------------
+; parseMtl()
+;
+; Reads the materials of a .mtl file. Only the colors, shininess, dissolve and
+; diffuse map are used, as the stock loader does for our assets.
+;-----------------------------------------------------------------------------*/
+static void parseMtl( const char * p, mtlLibrary_t * lib ) {
+	objMaterial_t   *    mat = NULL;
+	core::stringc        word;
+	core::vector3df      vec;
+	f32                  f;
+
+	while ( *p != '\0' ) {
+		p = skipSpace( p );
+
+		if ( isKeyword( p, "newmtl" ) ) {
+			objMaterial_t m;
+			p = readLastWord( p + 6, m.name );
+			defaultMaterial( m.material );
+			lib->materials.push_back( m );
+			mat = &lib->materials.getLast();
+
+		} else if ( mat != NULL ) {
+			if ( isKeyword( p, "Kd" ) ) {
+				p = readVec3( p + 2, vec );
+				mat->material.DiffuseColor = video::SColorf( vec.X, vec.Y, vec.Z, mat->material.DiffuseColor.getAlpha() / 255.0f ).toSColor();
+
+			} else if ( isKeyword( p, "Ka" ) ) {
+				p = readVec3( p + 2, vec );
+				mat->material.AmbientColor = video::SColorf( vec.X, vec.Y, vec.Z, 1.0f ).toSColor();
+
+			} else if ( isKeyword( p, "Ks" ) ) {
+				p = readVec3( p + 2, vec );
+				mat->material.SpecularColor = video::SColorf( vec.X, vec.Y, vec.Z, 1.0f ).toSColor();
+
+			} else if ( isKeyword( p, "Ns" ) ) {
+				// Wavefront shininess goes up to 1000, OpenGL's up to 128.
+				p = core::fast_atof_move( skipSpace( p + 2 ), f );
+				mat->material.Shininess = f * 0.128f;
+
+			} else if ( isKeyword( p, "d" ) ) {
+				p = core::fast_atof_move( skipSpace( p + 1 ), f );
+				if ( f < 1.0f ) {
+					mat->material.DiffuseColor.setAlpha( ( u32 )( f * 255.0f ) );
+					mat->material.MaterialType = video::EMT_TRANSPARENT_VERTEX_ALPHA;
+				}
+
+			} else if ( isKeyword( p, "map_Kd" ) ) {
+				// Options may precede the file name, which comes last.
+				p = readLastWord( p + 6, word );
+				mat->texture = word;
+			}
+		}
+
+		p = skipLine( p );
+	}
+}
+
+// Material the stock loader gives to faces without one.
+static void defaultMaterial( video::SMaterial & m ) {
+	m = video::SMaterial();
+	m.Shininess     = 0.0f;
+	m.AmbientColor  = video::SColorf( 0.2f, 0.2f, 0.2f, 1.0f ).toSColor();
+	m.DiffuseColor  = video::SColorf( 0.8f, 0.8f, 0.8f, 1.0f ).toSColor();
+	m.SpecularColor = video::SColorf( 1.0f, 1.0f, 1.0f, 1.0f ).toSColor();
+}
+
+static const char * skipSpace( const char * p ) {
+	while ( *p == ' ' || *p == '\t' ) p++;
+	return p;
+}
+
+static const char * skipLine( const char * p ) {
+	while ( *p != '\0' && *p != '\n' ) p++;
+	if ( *p == '\n' ) p++;
+	return p;
+}
+
+static const char * readWord( const char * p, core::stringc & word ) {
+	const char * start;
+
+	p     = skipSpace( p );
+	start = p;
+	while ( *p != '\0' && *p != ' ' && *p != '\t' && *p != '\n' && *p != '\r' ) p++;
+	word = core::stringc( start, ( u32 )( p - start ) );
+
+	return p;
+}
+
+static const char * readLastWord( const char * p, core::stringc & word ) {
+	core::stringc next;
+
+	word = "";
+	for ( ;; ) {
+		p = readWord( p, next );
+		if ( next.empty() ) break;
+		word = next;
+	}
+
+	return p;
+}
+
+static const char * readVec3( const char * p, core::vector3df & vec ) {
+	p = core::fast_atof_move( skipSpace( p ), vec.X );
+	p = core::fast_atof_move( skipSpace( p ), vec.Y );
+	p = core::fast_atof_move( skipSpace( p ), vec.Z );
+	return p;
+}
+
+static bool isKeyword( const char * p, const char * keyword ) {
+	while ( *keyword != '\0' ) {
+		if ( *p++ != *keyword++ ) return false;
+	}
+	return *p == ' ' || *p == '\t';
+}
@@ -0,0 +1,105 @@
+/*------------------------------------------------------------------------------
+; File:          MeshDecoder.hpp
+; Description:   Declaration of the parallel mesh decoder class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+
+#ifndef MESHDECODER_H
+#define MESHDECODER_H
+
+#include <pthread.h>
+#include <irrlicht.h>
+
+#include "definitions.hpp"
+#include "MeshSimplifier.hpp"
+
+using namespace irr;
+
+// A material read from a .mtl file.
+typedef struct OBJ_MATERIAL {
+	core::stringc                    name;
+	video::SMaterial                 material;
+	io::path                         texture;
+} objMaterial_t;
+
+typedef struct MTL_LIBRARY {
+	io::path                         path;
+	core::array< objMaterial_t >     materials;
+} mtlLibrary_t;
+
+// One file being decoded. The worker fills in the results and sets done.
+typedef struct DECODE_JOB {
+	mdcMeshDecoder               *   owner;
+	io::path                         name;
+	io::path                         dir;
+	char                         *   data;
+	long                             size;
+
+	scene::SMesh                 *   mesh;
+	scene::SMesh                 *   levels[ LOD_LEVELS ];
+	bool                             wantLevels;
+	core::array< core::stringc >     bufferMaterials;
+	core::stringc                    mtllib;
+	bool                             hasNormals;
+	bool                             done;
+} decodeJob_t;
+
+/*------------------------------------------------------------------------------
+; Decodes OBJ files on a thread pool. The main thread reads the file, a worker
+; parses it into a CPU-side SMesh and the main thread then resolves the
+; materials and textures and adds the mesh to the scene manager's mesh cache,
+; so the following getMesh() call for the same name returns it right away.
+; When asked to, the worker also simplifies the mesh into its detail levels,
+; which are cached under the names given by mdcMeshSimplifier::getLevelName().
+; Files in other formats are left for getMesh() to load as usual.
+;-----------------------------------------------------------------------------*/
+class mdcMeshDecoder {
+	public:
+		mdcMeshDecoder( IrrlichtDevice *, mdcThreadPool * );
+		~mdcMeshDecoder();
+
+		bool                                request( const io::path &, bool = false );
+		u32                                 collect();
+		u32                                 getPendingCount()         const;
+		bool                                isPending( const io::path & ) const;
+
+	private:
+		scene::ISceneManager         *      smgr;
+		video::IVideoDriver          *      driver;
+		io::IFileSystem              *      fs;
+		mdcThreadPool                *      pool;
+
+		// Jobs are only added and removed by the main thread, the done flags
+		// and the cancelled flag are guarded by lock.
+		core::array< decodeJob_t * >        jobs;
+		core::array< mtlLibrary_t * >       libraries;
+		pthread_mutex_t                     lock;
+		pthread_cond_t                      jobDone;
+		bool                                cancelled;
+
+		mdcMeshDecoder( mdcMeshDecoder const & ) { };
+		mdcMeshDecoder & operator=( mdcMeshDecoder const & ) { return *this; }
+
+		static void                         decodeMain( void * );
+		void                                publish( decodeJob_t * );
+		const mtlLibrary_t           *      getLibrary( const io::path & );
+		io::path                            resolveTexture( const io::path &, const io::path & ) const;
+};
+
+#endif // MESHDECODER_H
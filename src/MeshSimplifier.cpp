@@ -0,0 +1,554 @@
+/*------------------------------------------------------------------------------
+; File:          MeshSimplifier.cpp
+; Description:   Implementation of the mesh simplifier class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#include <cmath>
+#include <cstring>
+
+#include "MeshSimplifier.hpp"
+
+#define MAX_ITERATIONS    100
+#define UPDATE_INTERVAL   5
+
+// Largest error a collapse may add, relative to the squared size of the
+// buffer. Keeps the last passes from folding the mesh to reach the target.
+#define MAX_ERROR         1e-3
+
+// Collapses that turn a triangle further than this from its normal, or leave
+// it nearly degenerate, are rejected.
+#define MIN_NORMAL_DOT    0.2f
+#define MAX_EDGE_DOT      0.999f
+
+static bool isSimplifiable( const scene::IMeshBuffer * );
+static void addPlane( f64 *, const core::vector3df &, f64 );
+static f64  quadricError( const f64 *, const core::vector3df & );
+
+mdcMeshSimplifier::mdcMeshSimplifier() {
+	numDeleted = 0;
+}
+
+// True if createLevel() would reduce at least one buffer of the mesh.
+bool mdcMeshSimplifier::canSimplify( const scene::IMesh * mesh ) {
+	for ( u32 b = 0; b < mesh->getMeshBufferCount(); b++ ) {
+		if ( isSimplifiable( mesh->getMeshBuffer( b ) ) ) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*------------------------------------------------------------------------------
+; mdcMeshSimplifier::createLevel()
+;
+; Returns a mesh with every simplifiable buffer of the given one reduced to
+; the given fraction of its triangles. Buffers that are too small, or not
+; made of standard vertices with 16 bit indices, are shared as they are, so
+; the level always has the same buffers in the same order.
+;-----------------------------------------------------------------------------*/
+scene::SMesh * mdcMeshSimplifier::createLevel( scene::IMesh * mesh, f32 ratio ) {
+	mdcMeshSimplifier       simplifier;
+	scene::SMesh        *   level = new scene::SMesh();
+	scene::IMeshBuffer  *   buffer;
+	scene::IMeshBuffer  *   reduced;
+
+	for ( u32 b = 0; b < mesh->getMeshBufferCount(); b++ ) {
+		buffer = mesh->getMeshBuffer( b );
+
+		if ( !isSimplifiable( buffer ) ) {
+			level->addMeshBuffer( buffer );
+			continue;
+		}
+
+		reduced = simplifier.simplify( buffer, ( u32 )( buffer->getIndexCount() / 3 * ratio ) );
+		level->addMeshBuffer( reduced );
+		reduced->drop();
+	}
+
+	level->recalculateBoundingBox();
+
+	return level;
+}
+
+// Name a level is kept under in the mesh cache.
+io::path mdcMeshSimplifier::getLevelName( const io::path & name, u32 level ) {
+	io::path levelName = name;
+
+	levelName += "#lod";
+	levelName += level;
+
+	return levelName;
+}
+
+/*------------------------------------------------------------------------------
+; mdcMeshSimplifier::simplify()
+;
+; Returns a new buffer with about the given number of triangles, or more if
+; the buffer cannot be reduced that far without moving its open edges or
+; folding triangles over.
+;-----------------------------------------------------------------------------*/
+scene::IMeshBuffer * mdcMeshSimplifier::simplify( const scene::IMeshBuffer * buffer, u32 target ) {
+	const video::S3DVertex   *   source  = static_cast< const video::S3DVertex * >( buffer->getVertices() );
+	const u16                *   indices = buffer->getIndices();
+	simplifyTriangle_t           triangle;
+	simplifyVertex_t             blank;
+	core::vector3df              extent  = buffer->getBoundingBox().getExtent();
+	core::vector3df              p;
+	f64                          scale   = extent.getLengthSQ() > 0.0f ? extent.getLengthSQ() : 1.0;
+	f64                          threshold;
+	f32                          s;
+	u32                          i0;
+	u32                          i1;
+	u32                          first;
+	u32                          count;
+	bool                         collapsed;
+
+	vertices.set_used( 0 );
+	info.set_used( 0 );
+	triangles.set_used( 0 );
+	refs.set_used( 0 );
+	numDeleted = 0;
+
+	memset( &blank, 0, sizeof( blank ) );
+	for ( u32 v = 0; v < buffer->getVertexCount(); v++ ) {
+		vertices.push_back( source[ v ] );
+		info.push_back( blank );
+	}
+
+	triangle.normal.set( 0.0f, 0.0f, 0.0f );
+	triangle.error[ 0 ] = triangle.error[ 1 ] = triangle.error[ 2 ] = triangle.error[ 3 ] = 0.0;
+	triangle.deleted    = false;
+	triangle.dirty      = false;
+
+	for ( u32 i = 0; i + 2 < buffer->getIndexCount(); i += 3 ) {
+		triangle.v[ 0 ] = indices[ i ];
+		triangle.v[ 1 ] = indices[ i + 1 ];
+		triangle.v[ 2 ] = indices[ i + 2 ];
+
+		if ( triangle.v[ 0 ] != triangle.v[ 1 ] && triangle.v[ 1 ] != triangle.v[ 2 ] && triangle.v[ 2 ] != triangle.v[ 0 ] ) {
+			triangles.push_back( triangle );
+		}
+	}
+
+	for ( u32 iteration = 0; iteration < MAX_ITERATIONS; iteration++ ) {
+		if ( triangles.size() - numDeleted <= target ) {
+			break;
+		}
+
+		if ( iteration % UPDATE_INTERVAL == 0 ) {
+			updateMesh( iteration );
+		}
+
+		for ( u32 i = 0; i < triangles.size(); i++ ) {
+			triangles[ i ].dirty = false;
+		}
+		collapsed = false;
+
+		// Errors are squared distances, so the threshold scales with the squared size.
+		threshold = core::min_( 1e-9 * pow( iteration + 3.0, 7.0 ), MAX_ERROR ) * scale;
+
+		for ( u32 i = 0; i < triangles.size() && triangles.size() - numDeleted > target; i++ ) {
+			simplifyTriangle_t & t = triangles[ i ];
+
+			if ( t.error[ 3 ] > threshold || t.deleted || t.dirty ) {
+				continue;
+			}
+
+			for ( u32 j = 0; j < 3; j++ ) {
+				if ( t.error[ j ] >= threshold ) {
+					continue;
+				}
+
+				i0 = t.v[ j ];
+				i1 = t.v[ ( j + 1 ) % 3 ];
+
+				if ( info[ i0 ].border && info[ i1 ].border ) {
+					continue;
+				}
+
+				getEdgeError( i0, i1, s );
+				p = vertices[ i0 ].Pos + ( vertices[ i1 ].Pos - vertices[ i0 ].Pos ) * s;
+
+				deleted0.set_used( info[ i0 ].numRefs );
+				deleted1.set_used( info[ i1 ].numRefs );
+
+				if ( isFlipped( p, i0, i1, deleted0 ) || isFlipped( p, i1, i0, deleted1 ) ) {
+					continue;
+				}
+
+				// i1 goes away, i0 takes its place on the edge.
+				vertices[ i0 ].Pos     = p;
+				vertices[ i0 ].Normal  = ( vertices[ i0 ].Normal * ( 1.0f - s ) + vertices[ i1 ].Normal * s ).normalize();
+				vertices[ i0 ].TCoords = vertices[ i0 ].TCoords.getInterpolated( vertices[ i1 ].TCoords, 1.0f - s );
+
+				for ( u32 k = 0; k < 10; k++ ) {
+					info[ i0 ].q[ k ] += info[ i1 ].q[ k ];
+				}
+				info[ i0 ].border = info[ i0 ].border || info[ i1 ].border;
+
+				first = refs.size();
+				updateTriangles( i0, i0, deleted0 );
+				updateTriangles( i0, i1, deleted1 );
+				count = refs.size() - first;
+
+				// Reuse the old range when the new one fits in it.
+				if ( count <= info[ i0 ].numRefs ) {
+					for ( u32 k = 0; k < count; k++ ) {
+						refs[ info[ i0 ].firstRef + k ] = refs[ first + k ];
+					}
+					refs.set_used( first );
+				} else {
+					info[ i0 ].firstRef = first;
+				}
+				info[ i0 ].numRefs = count;
+
+				collapsed = true;
+				break;
+			}
+		}
+
+		// Past the largest error a pass that changes nothing will not be followed by one that does.
+		if ( !collapsed && threshold >= MAX_ERROR * scale ) {
+			break;
+		}
+	}
+
+	return createBuffer( buffer->getMaterial() );
+}
+
+/*------------------------------------------------------------------------------
+; mdcMeshSimplifier::updateMesh()
+;
+; Drops the deleted triangles and rebuilds the vertex to triangle references.
+; The first time it also finds the open edges and the quadrics.
+;-----------------------------------------------------------------------------*/
+void mdcMeshSimplifier::updateMesh( u32 iteration ) {
+	u32 kept = 0;
+	u32 first = 0;
+
+	if ( iteration > 0 ) {
+		for ( u32 i = 0; i < triangles.size(); i++ ) {
+			if ( !triangles[ i ].deleted ) {
+				triangles[ kept++ ] = triangles[ i ];
+			}
+		}
+		triangles.set_used( kept );
+		numDeleted = 0;
+	}
+
+	for ( u32 v = 0; v < info.size(); v++ ) {
+		info[ v ].numRefs = 0;
+	}
+
+	for ( u32 i = 0; i < triangles.size(); i++ ) {
+		for ( u32 j = 0; j < 3; j++ ) {
+			info[ triangles[ i ].v[ j ] ].numRefs++;
+		}
+	}
+
+	for ( u32 v = 0; v < info.size(); v++ ) {
+		info[ v ].firstRef = first;
+		first += info[ v ].numRefs;
+		info[ v ].numRefs = 0;
+	}
+
+	refs.set_used( triangles.size() * 3 );
+	for ( u32 i = 0; i < triangles.size(); i++ ) {
+		for ( u32 j = 0; j < 3; j++ ) {
+			simplifyVertex_t & v = info[ triangles[ i ].v[ j ] ];
+
+			refs[ v.firstRef + v.numRefs ].triangle = i;
+			refs[ v.firstRef + v.numRefs ].corner   = j;
+			v.numRefs++;
+		}
+	}
+
+	if ( iteration == 0 ) {
+		findBorders();
+		computeQuadrics();
+	}
+}
+
+// A vertex is on an open edge if it shares only one triangle with a neighbor.
+void mdcMeshSimplifier::findBorders() {
+	core::array< u32 > ids;
+	core::array< u32 > counts;
+	u32                id;
+	u32                k;
+
+	for ( u32 v = 0; v < info.size(); v++ ) {
+		ids.set_used( 0 );
+		counts.set_used( 0 );
+
+		for ( u32 r = 0; r < info[ v ].numRefs; r++ ) {
+			const simplifyTriangle_t & t = triangles[ refs[ info[ v ].firstRef + r ].triangle ];
+
+			for ( u32 j = 0; j < 3; j++ ) {
+				id = t.v[ j ];
+				if ( id == v ) {
+					continue;
+				}
+
+				for ( k = 0; k < ids.size() && ids[ k ] != id; k++ );
+				if ( k == ids.size() ) {
+					ids.push_back( id );
+					counts.push_back( 0 );
+				}
+				counts[ k ]++;
+			}
+		}
+
+		for ( k = 0; k < ids.size(); k++ ) {
+			if ( counts[ k ] == 1 ) {
+				info[ v ].border         = true;
+				info[ ids[ k ] ].border  = true;
+			}
+		}
+	}
+}
+
+void mdcMeshSimplifier::computeQuadrics() {
+	core::vector3df n;
+	f32             length;
+	f32             s;
+
+	for ( u32 i = 0; i < triangles.size(); i++ ) {
+		simplifyTriangle_t & t = triangles[ i ];
+		const core::vector3df & p0 = vertices[ t.v[ 0 ] ].Pos;
+
+		n      = ( vertices[ t.v[ 1 ] ].Pos - p0 ).crossProduct( vertices[ t.v[ 2 ] ].Pos - p0 );
+		length = n.getLength();
+
+		if ( length <= 0.0f ) {
+			t.normal.set( 0.0f, 0.0f, 0.0f );
+			continue;
+		}
+
+		t.normal = n / length;
+
+		for ( u32 j = 0; j < 3; j++ ) {
+			addPlane( info[ t.v[ j ] ].q, t.normal, -t.normal.dotProduct( p0 ) );
+		}
+	}
+
+	for ( u32 i = 0; i < triangles.size(); i++ ) {
+		simplifyTriangle_t & t = triangles[ i ];
+
+		for ( u32 j = 0; j < 3; j++ ) {
+			t.error[ j ] = getEdgeError( t.v[ j ], t.v[ ( j + 1 ) % 3 ], s );
+		}
+		t.error[ 3 ] = core::min_( t.error[ 0 ], t.error[ 1 ], t.error[ 2 ] );
+	}
+}
+
+/*------------------------------------------------------------------------------
+; mdcMeshSimplifier::getEdgeError()
+;
+; Returns the error of collapsing the edge and where along it the vertex
+; goes, 0 at the first end and 1 at the second. A vertex on an open edge
+; stays where it is.
+;-----------------------------------------------------------------------------*/
+f64 mdcMeshSimplifier::getEdgeError( u32 i0, u32 i1, f32 & s ) const {
+	const core::vector3df & p0 = vertices[ i0 ].Pos;
+	const core::vector3df & p1 = vertices[ i1 ].Pos;
+	f64                     q[ 10 ];
+	f64                     e0;
+	f64                     e1;
+	f64                     em;
+
+	for ( u32 k = 0; k < 10; k++ ) {
+		q[ k ] = info[ i0 ].q[ k ] + info[ i1 ].q[ k ];
+	}
+
+	if ( info[ i0 ].border ) {
+		s = 0.0f;
+		return quadricError( q, p0 );
+	}
+
+	if ( info[ i1 ].border ) {
+		s = 1.0f;
+		return quadricError( q, p1 );
+	}
+
+	e0 = quadricError( q, p0 );
+	e1 = quadricError( q, p1 );
+	em = quadricError( q, ( p0 + p1 ) * 0.5f );
+
+	if ( em <= e0 && em <= e1 ) {
+		s = 0.5f;
+		return em;
+	}
+
+	s = e0 <= e1 ? 0.0f : 1.0f;
+	return core::min_( e0, e1 );
+}
+
+/*------------------------------------------------------------------------------
+; mdcMeshSimplifier::isFlipped()
+;
+; Checks the triangles around i0 with i0 moved to p. Those that also use i1
+; will disappear and are flagged in the given array, one entry per reference
+; of i0.
+;-----------------------------------------------------------------------------*/
+bool mdcMeshSimplifier::isFlipped( const core::vector3df & p, u32 i0, u32 i1, core::array< bool > & gone ) const {
+	core::vector3df d1;
+	core::vector3df d2;
+	core::vector3df n;
+	u32             id1;
+	u32             id2;
+
+	for ( u32 k = 0; k < info[ i0 ].numRefs; k++ ) {
+		const simplifyRef_t      & r = refs[ info[ i0 ].firstRef + k ];
+		const simplifyTriangle_t & t = triangles[ r.triangle ];
+
+		if ( t.deleted ) {
+			continue;
+		}
+
+		id1 = t.v[ ( r.corner + 1 ) % 3 ];
+		id2 = t.v[ ( r.corner + 2 ) % 3 ];
+
+		if ( id1 == i1 || id2 == i1 ) {
+			gone[ k ] = true;
+			continue;
+		}
+		gone[ k ] = false;
+
+		d1 = vertices[ id1 ].Pos - p;
+		d2 = vertices[ id2 ].Pos - p;
+		d1.normalize();
+		d2.normalize();
+
+		if ( fabsf( d1.dotProduct( d2 ) ) > MAX_EDGE_DOT ) {
+			return true;
+		}
+
+		n = d1.crossProduct( d2 );
+		n.normalize();
+
+		if ( n.dotProduct( t.normal ) < MIN_NORMAL_DOT ) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*------------------------------------------------------------------------------
+; mdcMeshSimplifier::updateTriangles()
+;
+; Points the triangles of v at i0, deleting the flagged ones, and appends
+; the references of the survivors.
+;-----------------------------------------------------------------------------*/
+void mdcMeshSimplifier::updateTriangles( u32 i0, u32 v, const core::array< bool > & gone ) {
+	simplifyRef_t   r;
+	core::vector3df n;
+	f32             s;
+
+	for ( u32 k = 0; k < info[ v ].numRefs; k++ ) {
+		r = refs[ info[ v ].firstRef + k ];
+		simplifyTriangle_t & t = triangles[ r.triangle ];
+
+		if ( t.deleted ) {
+			continue;
+		}
+
+		if ( gone[ k ] ) {
+			t.deleted = true;
+			numDeleted++;
+			continue;
+		}
+
+		t.v[ r.corner ] = i0;
+		t.dirty         = true;
+
+		n = ( vertices[ t.v[ 1 ] ].Pos - vertices[ t.v[ 0 ] ].Pos ).crossProduct( vertices[ t.v[ 2 ] ].Pos - vertices[ t.v[ 0 ] ].Pos );
+		t.normal = n.normalize();
+
+		for ( u32 j = 0; j < 3; j++ ) {
+			t.error[ j ] = getEdgeError( t.v[ j ], t.v[ ( j + 1 ) % 3 ], s );
+		}
+		t.error[ 3 ] = core::min_( t.error[ 0 ], t.error[ 1 ], t.error[ 2 ] );
+
+		refs.push_back( r );
+	}
+}
+
+// Copies out the surviving triangles and the vertices they use.
+scene::IMeshBuffer * mdcMeshSimplifier::createBuffer( const video::SMaterial & material ) const {
+	scene::SMeshBuffer    *   out = new scene::SMeshBuffer();
+	core::array< s32 >        remap;
+	u32                       v;
+
+	remap.set_used( vertices.size() );
+	for ( u32 i = 0; i < remap.size(); i++ ) {
+		remap[ i ] = -1;
+	}
+
+	for ( u32 i = 0; i < triangles.size(); i++ ) {
+		if ( triangles[ i ].deleted ) {
+			continue;
+		}
+
+		for ( u32 j = 0; j < 3; j++ ) {
+			v = triangles[ i ].v[ j ];
+
+			if ( remap[ v ] < 0 ) {
+				remap[ v ] = out->Vertices.size();
+				out->Vertices.push_back( vertices[ v ] );
+			}
+			out->Indices.push_back( ( u16 )remap[ v ] );
+		}
+	}
+
+	out->Material = material;
+	out->recalculateBoundingBox();
+
+	return out;
+}
+
+// Adds the quadric of the plane n.x + d = 0, upper triangle of the 4x4 matrix.
+static void addPlane( f64 * q, const core::vector3df & n, f64 d ) {
+	q[ 0 ] += n.X * n.X;
+	q[ 1 ] += n.X * n.Y;
+	q[ 2 ] += n.X * n.Z;
+	q[ 3 ] += n.X * d;
+	q[ 4 ] += n.Y * n.Y;
+	q[ 5 ] += n.Y * n.Z;
+	q[ 6 ] += n.Y * d;
+	q[ 7 ] += n.Z * n.Z;
+	q[ 8 ] += n.Z * d;
+	q[ 9 ] += d * d;
+}
+
+static f64 quadricError( const f64 * q, const core::vector3df & p ) {
+	f64 x = p.X;
+	f64 y = p.Y;
+	f64 z = p.Z;
+
+	return q[ 0 ] * x * x + 2 * q[ 1 ] * x * y + 2 * q[ 2 ] * x * z + 2 * q[ 3 ] * x +
+	       q[ 4 ] * y * y + 2 * q[ 5 ] * y * z + 2 * q[ 6 ] * y +
+	       q[ 7 ] * z * z + 2 * q[ 8 ] * z + q[ 9 ];
+}
+
+static bool isSimplifiable( const scene::IMeshBuffer * buffer ) {
+	return buffer->getVertexType() == video::EVT_STANDARD && buffer->getIndexType() == video::EIT_16BIT &&
+	       buffer->getIndexCount() / 3 >= LOD_MIN_TRIANGLES;
+}
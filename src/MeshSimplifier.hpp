@@ -0,0 +1,100 @@
+/*------------------------------------------------------------------------------
+; File:          MeshSimplifier.hpp
+; Description:   Declaration of the mesh simplifier class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#ifndef MESHSIMPLIFIER_H
+#define MESHSIMPLIFIER_H
+
+#include <irrlicht.h>
+
+#include "definitions.hpp"
+
+using namespace irr;
+
+// Detail levels of an exhibit, the full mesh included, and the fraction of
+// the triangles of a level kept by the next one.
+#define LOD_LEVELS          4
+#define LOD_RATIO           0.25f
+
+// Meshes with fewer triangles than this are not simplified.
+#define LOD_MIN_TRIANGLES   256
+
+typedef struct SIMPLIFY_TRIANGLE {
+	u32                v[ 3 ];
+	f64                error[ 4 ];
+	core::vector3df    normal;
+	bool               deleted;
+	bool               dirty;
+} simplifyTriangle_t;
+
+// Where a vertex is used, triangle and corner.
+typedef struct SIMPLIFY_REF {
+	u32                triangle;
+	u32                corner;
+} simplifyRef_t;
+
+typedef struct SIMPLIFY_VERTEX {
+	f64                q[ 10 ];
+	u32                firstRef;
+	u32                numRefs;
+	bool               border;
+} simplifyVertex_t;
+
+/*------------------------------------------------------------------------------
+; Quadric error mesh simplification. Edges are collapsed in order of the
+; error they add, measured as the sum of squared distances to the planes of
+; the original triangles around them, with a threshold that grows each pass
+; instead of a priority queue. Open edges, which include the seams where a
+; decoded mesh splits vertices, never move, so levels have no cracks and
+; keep their texture mapping. A collapsed vertex takes the endpoint or the
+; midpoint of its edge that adds the least error.
+;-----------------------------------------------------------------------------*/
+class mdcMeshSimplifier {
+	public:
+		mdcMeshSimplifier();
+
+		static bool                     canSimplify( const scene::IMesh * );
+		static scene::SMesh *           createLevel( scene::IMesh *, f32 );
+		static io::path                 getLevelName( const io::path &, u32 );
+
+		scene::IMeshBuffer *            simplify( const scene::IMeshBuffer *, u32 );
+
+	private:
+		core::array< video::S3DVertex >       vertices;
+		core::array< simplifyVertex_t >       info;
+		core::array< simplifyTriangle_t >     triangles;
+		core::array< simplifyRef_t >          refs;
+		core::array< bool >                   deleted0;
+		core::array< bool >                   deleted1;
+		u32                                   numDeleted;
+
+		mdcMeshSimplifier( mdcMeshSimplifier const & ) { };
+		mdcMeshSimplifier & operator=( mdcMeshSimplifier const & ) { return *this; }
+
+		void                            updateMesh( u32 );
+		void                            findBorders();
+		void                            computeQuadrics();
+		f64                             getEdgeError( u32, u32, f32 & )                 const;
+		bool                            isFlipped( const core::vector3df &, u32, u32, core::array< bool > & ) const;
+		void                            updateTriangles( u32, u32, const core::array< bool > & );
+		scene::IMeshBuffer *            createBuffer( const video::SMaterial & )        const;
+};
+
+#endif // MESHSIMPLIFIER_H
@@ -0,0 +1,489 @@
+/*------------------------------------------------------------------------------
+; File:          OctreeSelector.cpp
+; Description:   Implementation of the cached octree triangle selector class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+
+#include "OctreeSelector.hpp"
+#include "Trace.hpp"
+
+using std::cerr;
+using std::endl;
+
+// Deep enough for any sane mesh, stops degenerate triangles from splitting
+// the same box forever.
+#define MAX_DEPTH   24
+
+static void buildNode( core::array< octreeNode_t > &, core::array< core::triangle3df > &,
+                       const core::array< core::triangle3df > &, const core::array< u32 > &,
+                       u32, s32, int );
+static void hashBytes( u64 &, const void *, u32 );
+
+mdcOctreeSelector::mdcOctreeSelector( scene::ISceneNode * node ) {
+	this->node = node;
+}
+
+/*------------------------------------------------------------------------------
+; mdcOctreeSelector::create()
+;
+; Creates the selector of a mesh placed by the given node. The tree is read
+; from the cache directory if it holds one for the same mesh and transform,
+; otherwise it is built and written there. An empty directory disables the
+; cache.
+;-----------------------------------------------------------------------------*/
+mdcOctreeSelector * mdcOctreeSelector::create( const scene::IMesh * mesh, scene::ISceneNode * node, s32 minPolys, const char * cacheDir ) {
+	mdcOctreeSelector * selector = new mdcOctreeSelector( node );
+	core::matrix4       transform;
+	core::stringc       path;
+	char                name[ 32 ];
+	u64                 key;
+
+	TRACE_SCOPE( "mdcOctreeSelector::create" );
+
+	if ( node != NULL ) {
+		// New nodes only get their absolute transform on the first animation pass.
+		node->updateAbsolutePosition();
+		transform = node->getAbsoluteTransformation();
+	}
+
+	if ( cacheDir == NULL || cacheDir[ 0 ] == '\0' ) {
+		selector->build( mesh, minPolys );
+		return selector;
+	}
+
+	key = hash( mesh, transform, minPolys );
+	snprintf( name, sizeof( name ), "%08x%08x.oct", ( u32 )( key >> 32 ), ( u32 )key );
+	path  = cacheDir;
+	path += name;
+
+	if ( !selector->load( path.c_str(), key ) ) {
+		selector->build( mesh, minPolys );
+		selector->save( path.c_str(), key );
+	}
+
+	return selector;
+}
+
+s32 mdcOctreeSelector::getTriangleCount() const {
+	return triangles.size();
+}
+
+void mdcOctreeSelector::getTriangles( core::triangle3df * out, s32 arraySize, s32 & outCount, const core::matrix4 * transform ) const {
+	s32 n = core::min_( arraySize, ( s32 )triangles.size() );
+
+	for ( s32 i = 0; i < n; i++ ) {
+		out[ i ] = triangles[ i ];
+		if ( transform != NULL ) {
+			transform->transformVect( out[ i ].pointA );
+			transform->transformVect( out[ i ].pointB );
+			transform->transformVect( out[ i ].pointC );
+		}
+	}
+
+	outCount = n;
+}
+
+/*------------------------------------------------------------------------------
+; mdcOctreeSelector::getTriangles()
+;
+; Returns the triangles of every node whose box touches the given box. The
+; box is in world space, like the triangles.
+;-----------------------------------------------------------------------------*/
+void mdcOctreeSelector::getTriangles( core::triangle3df * out, s32 arraySize, s32 & outCount,
+                                      const core::aabbox3d< f32 > & box, const core::matrix4 * transform ) const {
+	u32 stack[ MAX_DEPTH * 8 + 1 ];
+	u32 top = 0;
+	s32 n   = 0;
+
+	if ( nodes.size() > 0 ) {
+		stack[ top++ ] = 0;
+	}
+
+	while ( top > 0 && n < arraySize ) {
+		const octreeNode_t & cur = nodes[ stack[ --top ] ];
+		core::aabbox3df      nodeBox( cur.box[ 0 ], cur.box[ 1 ], cur.box[ 2 ], cur.box[ 3 ], cur.box[ 4 ], cur.box[ 5 ] );
+
+		if ( !nodeBox.intersectsWithBox( box ) ) {
+			continue;
+		}
+
+		for ( u32 i = 0; i < cur.numTriangles && n < arraySize; i++ ) {
+			out[ n ] = triangles[ cur.firstTriangle + i ];
+			if ( transform != NULL ) {
+				transform->transformVect( out[ n ].pointA );
+				transform->transformVect( out[ n ].pointB );
+				transform->transformVect( out[ n ].pointC );
+			}
+			n++;
+		}
+
+		for ( u32 i = 0; i < cur.numChildren; i++ ) {
+			stack[ top++ ] = cur.firstChild + i;
+		}
+	}
+
+	outCount = n;
+}
+
+/*------------------------------------------------------------------------------
+; mdcOctreeSelector::getTriangles()
+;
+; Returns the triangles of every node whose box is crossed by the line. The
+; stock selector tests against the bounding box of the line instead.
+;-----------------------------------------------------------------------------*/
+void mdcOctreeSelector::getTriangles( core::triangle3df * out, s32 arraySize, s32 & outCount,
+                                      const core::line3d< f32 > & line, const core::matrix4 * transform ) const {
+	u32 stack[ MAX_DEPTH * 8 + 1 ];
+	u32 top = 0;
+	s32 n   = 0;
+
+	if ( nodes.size() > 0 ) {
+		stack[ top++ ] = 0;
+	}
+
+	while ( top > 0 && n < arraySize ) {
+		const octreeNode_t & cur = nodes[ stack[ --top ] ];
+		core::aabbox3df      nodeBox( cur.box[ 0 ], cur.box[ 1 ], cur.box[ 2 ], cur.box[ 3 ], cur.box[ 4 ], cur.box[ 5 ] );
+
+		if ( !nodeBox.intersectsWithLine( line ) ) {
+			continue;
+		}
+
+		for ( u32 i = 0; i < cur.numTriangles && n < arraySize; i++ ) {
+			out[ n ] = triangles[ cur.firstTriangle + i ];
+			if ( transform != NULL ) {
+				transform->transformVect( out[ n ].pointA );
+				transform->transformVect( out[ n ].pointB );
+				transform->transformVect( out[ n ].pointC );
+			}
+			n++;
+		}
+
+		for ( u32 i = 0; i < cur.numChildren; i++ ) {
+			stack[ top++ ] = cur.firstChild + i;
+		}
+	}
+
+	outCount = n;
+}
+
+scene::ISceneNode * mdcOctreeSelector::getSceneNodeForTriangle( u32 ) const {
+	return node;
+}
+
+u32 mdcOctreeSelector::getSelectorCount() const {
+	return 1;
+}
+
+scene::ITriangleSelector * mdcOctreeSelector::getSelector( u32 index ) {
+	return index == 0 ? this : NULL;
+}
+
+const scene::ITriangleSelector * mdcOctreeSelector::getSelector( u32 index ) const {
+	return index == 0 ? this : NULL;
+}
+
+const core::aabbox3df & mdcOctreeSelector::getBoundingBox() const {
+	return bounds;
+}
+
+/*------------------------------------------------------------------------------
+; mdcOctreeSelector::build()
+;
+; Builds the tree like the stock selector does: a node with more than minPolys
+; triangles hands every triangle that fits whole in one of its octants to a
+; child for that octant and keeps the rest.
+;-----------------------------------------------------------------------------*/
+void mdcOctreeSelector::build( const scene::IMesh * mesh, s32 minPolys ) {
+	core::array< core::triangle3df > source;
+	core::array< u32 >               all;
+	core::matrix4                    transform;
+
+	TRACE_SCOPE( "mdcOctreeSelector::build" );
+
+	if ( node != NULL ) {
+		transform = node->getAbsoluteTransformation();
+	}
+
+	for ( u32 b = 0; b < mesh->getMeshBufferCount(); b++ ) {
+		const scene::IMeshBuffer * buffer = mesh->getMeshBuffer( b );
+		const u32                  count  = buffer->getIndexCount();
+
+		for ( u32 i = 0; i + 2 < count; i += 3 ) {
+			core::triangle3df tri;
+
+			if ( buffer->getIndexType() == video::EIT_16BIT ) {
+				const u16 * idx = buffer->getIndices();
+				tri.set( buffer->getPosition( idx[ i ] ), buffer->getPosition( idx[ i + 1 ] ), buffer->getPosition( idx[ i + 2 ] ) );
+			} else {
+				const u32 * idx = ( const u32 * )buffer->getIndices();
+				tri.set( buffer->getPosition( idx[ i ] ), buffer->getPosition( idx[ i + 1 ] ), buffer->getPosition( idx[ i + 2 ] ) );
+			}
+
+			transform.transformVect( tri.pointA );
+			transform.transformVect( tri.pointB );
+			transform.transformVect( tri.pointC );
+
+			all.push_back( source.size() );
+			source.push_back( tri );
+		}
+	}
+
+	nodes.clear();
+	triangles.clear();
+	bounds.reset( 0, 0, 0 );
+
+	if ( source.size() == 0 ) {
+		return;
+	}
+
+	triangles.reallocate( source.size() );
+	nodes.push_back( octreeNode_t() );
+	buildNode( nodes, triangles, source, all, 0, minPolys, 0 );
+
+	bounds.reset( nodes[ 0 ].box[ 0 ], nodes[ 0 ].box[ 1 ], nodes[ 0 ].box[ 2 ] );
+	bounds.addInternalPoint( nodes[ 0 ].box[ 3 ], nodes[ 0 ].box[ 4 ], nodes[ 0 ].box[ 5 ] );
+}
+
+/*------------------------------------------------------------------------------
+; mdcOctreeSelector::load()
+;
+; Reads a cached tree. Files for another mesh, with counts the file cannot
+; hold, links out of range or deeper than MAX_DEPTH, which the fixed query
+; stacks assume, are rejected.
+;-----------------------------------------------------------------------------*/
+bool mdcOctreeSelector::load( const char * path, u64 key ) {
+	octreeHeader_t         header;
+	core::array< u8 >      depths;
+	FILE               *   fp;
+	long                   size;
+	bool                   ok;
+
+	TRACE_SCOPE_ARG( "mdcOctreeSelector::load", path );
+
+	fp = fopen( path, "rb" );
+	if ( fp == NULL ) {
+		return false;
+	}
+
+	ok = fseek( fp, 0, SEEK_END ) == 0 && ( size = ftell( fp ) ) >= ( long )sizeof( header ) &&
+	     fseek( fp, 0, SEEK_SET ) == 0;
+
+	ok = ok && fread( &header, sizeof( header ), 1, fp ) == 1 &&
+	     header.magic == OCTREE_MAGIC && header.version == OCTREE_VERSION &&
+	     header.hashLow == ( u32 )key && header.hashHigh == ( u32 )( key >> 32 ) &&
+	     header.numNodes > 0;
+
+	// Check the counts before allocating, a bad header could ask for gigabytes.
+	if ( ok ) {
+		size -= sizeof( header );
+		ok    = header.numNodes <= ( u32 )( size / sizeof( octreeNode_t ) ) &&
+		        header.numTriangles <= ( u32 )( ( size - header.numNodes * sizeof( octreeNode_t ) ) / sizeof( core::triangle3df ) );
+	}
+
+	if ( ok ) {
+		nodes.set_used( header.numNodes );
+		triangles.set_used( header.numTriangles );
+
+		ok = fread( nodes.pointer(), sizeof( octreeNode_t ), header.numNodes, fp ) == header.numNodes &&
+		     fread( triangles.pointer(), sizeof( core::triangle3df ), header.numTriangles, fp ) == header.numTriangles;
+	}
+
+	fclose( fp );
+
+	// Make sure a damaged file cannot send a query out of bounds.
+	for ( u32 i = 0; ok && i < nodes.size(); i++ ) {
+		ok = nodes[ i ].firstChild <= nodes.size() && nodes[ i ].numChildren <= nodes.size() - nodes[ i ].firstChild &&
+		     nodes[ i ].numChildren <= 8 && ( nodes[ i ].numChildren == 0 || nodes[ i ].firstChild > i ) &&
+		     nodes[ i ].firstTriangle <= triangles.size() &&
+		     nodes[ i ].numTriangles <= triangles.size() - nodes[ i ].firstTriangle;
+	}
+
+	// Children come after their parents, so one pass finds every depth.
+	if ( ok ) {
+		depths.set_used( nodes.size() );
+		memset( depths.pointer(), 0, depths.size() );
+	}
+
+	for ( u32 i = 0; ok && i < nodes.size(); i++ ) {
+		ok = depths[ i ] <= MAX_DEPTH;
+
+		for ( u32 c = 0; ok && c < nodes[ i ].numChildren; c++ ) {
+			depths[ nodes[ i ].firstChild + c ] = core::max_( depths[ nodes[ i ].firstChild + c ], ( u8 )( depths[ i ] + 1 ) );
+		}
+	}
+
+	if ( !ok ) {
+		cerr << "mdcOctreeSelector::load() - Ignoring damaged cache file " << path << endl;
+		nodes.clear();
+		triangles.clear();
+		return false;
+	}
+
+	bounds.reset( nodes[ 0 ].box[ 0 ], nodes[ 0 ].box[ 1 ], nodes[ 0 ].box[ 2 ] );
+	bounds.addInternalPoint( nodes[ 0 ].box[ 3 ], nodes[ 0 ].box[ 4 ], nodes[ 0 ].box[ 5 ] );
+
+	return true;
+}
+
+bool mdcOctreeSelector::save( const char * path, u64 key ) const {
+	octreeHeader_t   header;
+	FILE         *   fp;
+	bool             ok;
+
+	if ( nodes.size() == 0 ) {
+		return false;
+	}
+
+	header.magic        = OCTREE_MAGIC;
+	header.version      = OCTREE_VERSION;
+	header.hashLow      = ( u32 )key;
+	header.hashHigh     = ( u32 )( key >> 32 );
+	header.numNodes     = nodes.size();
+	header.numTriangles = triangles.size();
+
+	fp = fopen( path, "wb" );
+	if ( fp == NULL ) {
+		cerr << "mdcOctreeSelector::save() - Could not create " << path << endl;
+		return false;
+	}
+
+	ok = fwrite( &header, sizeof( header ), 1, fp ) == 1 &&
+	     fwrite( nodes.const_pointer(), sizeof( octreeNode_t ), nodes.size(), fp ) == nodes.size() &&
+	     fwrite( triangles.const_pointer(), sizeof( core::triangle3df ), triangles.size(), fp ) == triangles.size();
+	ok = ( fclose( fp ) == 0 ) && ok;
+
+	if ( !ok ) {
+		// Never leave a truncated tree behind.
+		remove( path );
+	}
+
+	return ok;
+}
+
+// 64 bit FNV-1a of the vertex positions, the indices, the transform and minPolys.
+u64 mdcOctreeSelector::hash( const scene::IMesh * mesh, const core::matrix4 & transform, s32 minPolys ) {
+	u64 h = 14695981039346656037ULL;
+
+	hashBytes( h, &minPolys, sizeof( minPolys ) );
+	hashBytes( h, transform.pointer(), sizeof( f32 ) * 16 );
+
+	for ( u32 b = 0; b < mesh->getMeshBufferCount(); b++ ) {
+		const scene::IMeshBuffer * buffer = mesh->getMeshBuffer( b );
+		u32                        count  = buffer->getVertexCount();
+
+		hashBytes( h, &count, sizeof( count ) );
+		for ( u32 i = 0; i < count; i++ ) {
+			hashBytes( h, &buffer->getPosition( i ), sizeof( core::vector3df ) );
+		}
+
+		count = buffer->getIndexCount();
+		hashBytes( h, &count, sizeof( count ) );
+		hashBytes( h, buffer->getIndices(), count * ( buffer->getIndexType() == video::EIT_16BIT ? sizeof( u16 ) : sizeof( u32 ) ) );
+	}
+
+	return h;
+}
+
+static void buildNode( core::array< octreeNode_t > & nodes, core::array< core::triangle3df > & triangles,
+                       const core::array< core::triangle3df > & source, const core::array< u32 > & tris,
+                       u32 slot, s32 minPolys, int depth ) {
+	core::array< u32 >   children[ 8 ];
+	core::array< u32 >   kept;
+	core::aabbox3df      box( source[ tris[ 0 ] ].pointA );
+	core::aabbox3df      octant;
+	core::vector3df      middle;
+	core::vector3df      edges[ 8 ];
+	u32                  numChildren = 0;
+	u32                  first;
+
+	for ( u32 i = 0; i < tris.size(); i++ ) {
+		box.addInternalPoint( source[ tris[ i ] ].pointA );
+		box.addInternalPoint( source[ tris[ i ] ].pointB );
+		box.addInternalPoint( source[ tris[ i ] ].pointC );
+	}
+
+	if ( ( s32 )tris.size() > minPolys && depth < MAX_DEPTH ) {
+		middle = box.getCenter();
+		box.getEdges( edges );
+
+		for ( u32 i = 0; i < tris.size(); i++ ) {
+			u32 ch;
+
+			for ( ch = 0; ch < 8; ch++ ) {
+				octant.reset( middle );
+				octant.addInternalPoint( edges[ ch ] );
+				if ( source[ tris[ i ] ].isTotalInsideBox( octant ) ) {
+					children[ ch ].push_back( tris[ i ] );
+					break;
+				}
+			}
+
+			if ( ch == 8 ) {
+				kept.push_back( tris[ i ] );
+			}
+		}
+	} else {
+		kept = tris;
+	}
+
+	for ( u32 ch = 0; ch < 8; ch++ ) {
+		if ( children[ ch ].size() > 0 ) numChildren++;
+	}
+
+	nodes[ slot ].box[ 0 ]      = box.MinEdge.X;
+	nodes[ slot ].box[ 1 ]      = box.MinEdge.Y;
+	nodes[ slot ].box[ 2 ]      = box.MinEdge.Z;
+	nodes[ slot ].box[ 3 ]      = box.MaxEdge.X;
+	nodes[ slot ].box[ 4 ]      = box.MaxEdge.Y;
+	nodes[ slot ].box[ 5 ]      = box.MaxEdge.Z;
+	nodes[ slot ].firstTriangle = triangles.size();
+	nodes[ slot ].numTriangles  = kept.size();
+	nodes[ slot ].firstChild    = nodes.size();
+	nodes[ slot ].numChildren   = numChildren;
+
+	for ( u32 i = 0; i < kept.size(); i++ ) {
+		triangles.push_back( source[ kept[ i ] ] );
+	}
+
+	// Reserve the children next to each other before filling any of them.
+	first = nodes.size();
+	for ( u32 ch = 0; ch < numChildren; ch++ ) {
+		nodes.push_back( octreeNode_t() );
+	}
+
+	for ( u32 ch = 0; ch < 8; ch++ ) {
+		if ( children[ ch ].size() > 0 ) {
+			buildNode( nodes, triangles, source, children[ ch ], first++, minPolys, depth + 1 );
+		}
+	}
+}
+
+static void hashBytes( u64 & h, const void * data, u32 size ) {
+	const u8 * p = ( const u8 * )data;
+
+	for ( u32 i = 0; i < size; i++ ) {
+		h ^= p[ i ];
+		h *= 1099511628211ULL;
+	}
+}
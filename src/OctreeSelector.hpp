@@ -0,0 +1,96 @@
+/*------------------------------------------------------------------------------
+; File:          OctreeSelector.hpp
+; Description:   Declaration of the cached octree triangle selector class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+
+#ifndef OCTREESELECTOR_H
+#define OCTREESELECTOR_H
+
+#include <irrlicht.h>
+
+#include "definitions.hpp"
+
+using namespace irr;
+
+// "MDCO" read as a little endian integer.
+#define OCTREE_MAGIC    0x4F43444D
+#define OCTREE_VERSION  1
+
+// Octree node. Children are stored next to each other, the triangles of a
+// node are a contiguous range of the triangle array.
+typedef struct OCTREE_NODE {
+	f32    box[ 6 ];
+	u32    firstChild;
+	u32    numChildren;
+	u32    firstTriangle;
+	u32    numTriangles;
+} octreeNode_t;
+
+typedef struct OCTREE_HEADER {
+	u32    magic;
+	u32    version;
+	u32    hashLow;
+	u32    hashHigh;
+	u32    numNodes;
+	u32    numTriangles;
+} octreeHeader_t;
+
+/*------------------------------------------------------------------------------
+; Octree triangle selector for static geometry. Works like the stock octree
+; selector but keeps its triangles in world space and its nodes in flat
+; arrays, so the whole tree can be written to disk and read back as is. The
+; cached tree is keyed by a hash of the mesh, the node transform and the
+; minimum number of polygons per node.
+;-----------------------------------------------------------------------------*/
+class mdcOctreeSelector : public scene::ITriangleSelector {
+	public:
+		static mdcOctreeSelector *      create( const scene::IMesh *, scene::ISceneNode *, s32, const char * );
+
+		virtual s32                     getTriangleCount()                                              const;
+		virtual void                    getTriangles( core::triangle3df *, s32, s32 &,
+		                                              const core::matrix4 * = 0 )                       const;
+		virtual void                    getTriangles( core::triangle3df *, s32, s32 &,
+		                                              const core::aabbox3d< f32 > &,
+		                                              const core::matrix4 * = 0 )                       const;
+		virtual void                    getTriangles( core::triangle3df *, s32, s32 &,
+		                                              const core::line3d< f32 > &,
+		                                              const core::matrix4 * = 0 )                       const;
+		virtual scene::ISceneNode *     getSceneNodeForTriangle( u32 )                                  const;
+		virtual u32                     getSelectorCount()                                              const;
+		virtual scene::ITriangleSelector * getSelector( u32 );
+		virtual const scene::ITriangleSelector * getSelector( u32 )                                     const;
+
+		const core::aabbox3df &         getBoundingBox()                                                const;
+
+	private:
+		scene::ISceneNode        *      node;
+		core::array< octreeNode_t >     nodes;
+		core::array< core::triangle3df > triangles;
+		core::aabbox3df                 bounds;
+
+		mdcOctreeSelector( scene::ISceneNode * );
+
+		void                            build( const scene::IMesh *, s32 );
+		bool                            load( const char *, u64 );
+		bool                            save( const char *, u64 )                                      const;
+		static u64                      hash( const scene::IMesh *, const core::matrix4 &, s32 );
+};
+
+#endif // OCTREESELECTOR_H
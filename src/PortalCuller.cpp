@@ -0,0 +1,280 @@
+/*------------------------------------------------------------------------------
+; File:          PortalCuller.cpp
+; Description:   Implementation of the portal visibility class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#include <cmath>
+
+#include "PortalCuller.hpp"
+
+// Closer than this to a portal the camera is taken to be standing in it.
+#define PORTAL_EPSILON   1.0f
+
+static f32 component( const core::vector3df &, int );
+static void setComponent( core::vector3df &, int, f32 );
+
+mdcPortalCuller::mdcPortalCuller() { }
+
+void mdcPortalCuller::addRoom( const core::stringw & name, const core::aabbox3df & box ) {
+	portalRoom_t room;
+
+	room.name = name;
+	room.box  = box;
+
+	rooms.push_back( room );
+	visible.push_back( true );
+	seen.push_back( false );
+	onPath.push_back( false );
+}
+
+/*------------------------------------------------------------------------------
+; mdcPortalCuller::addPortal()
+;
+; Adds an opening between the named rooms, which must have been added first.
+; Returns false if either room does not exist.
+;-----------------------------------------------------------------------------*/
+bool mdcPortalCuller::addPortal( const core::stringw & from, const core::stringw & to, const core::aabbox3df & box ) {
+	core::vector3df   extent = box.getExtent();
+	portalPortal_t    portal;
+	s32               a      = findRoom( from );
+	s32               b      = findRoom( to );
+	int               thin;
+	int               u;
+	int               v;
+
+	if ( a < 0 || b < 0 || a == b ) {
+		return false;
+	}
+
+	thin = extent.X < extent.Y ? ( extent.X < extent.Z ? 0 : 2 ) : ( extent.Y < extent.Z ? 1 : 2 );
+	u    = ( thin + 1 ) % 3;
+	v    = ( thin + 2 ) % 3;
+
+	for ( int i = 0; i < 4; i++ ) {
+		setComponent( portal.corners[ i ], thin, component( box.getCenter(), thin ) );
+		setComponent( portal.corners[ i ], u, component( i == 0 || i == 3 ? box.MinEdge : box.MaxEdge, u ) );
+		setComponent( portal.corners[ i ], v, component( i < 2 ? box.MinEdge : box.MaxEdge, v ) );
+	}
+
+	portal.rooms[ 0 ] = a;
+	portal.rooms[ 1 ] = b;
+
+	portals.push_back( portal );
+
+	return true;
+}
+
+u32 mdcPortalCuller::getRoomCount() const {
+	return rooms.size();
+}
+
+// Appends every room the box touches.
+void mdcPortalCuller::getRooms( const core::aabbox3df & box, core::array< u32 > & out ) const {
+	for ( u32 r = 0; r < rooms.size(); r++ ) {
+		if ( rooms[ r ].box.intersectsWithBox( box ) ) {
+			out.push_back( r );
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------
+; mdcPortalCuller::update()
+;
+; Finds the rooms seen through the given frustum. Every room is visible while
+; the camera is outside all of them.
+;-----------------------------------------------------------------------------*/
+bool mdcPortalCuller::update( const scene::SViewFrustum & frustum ) {
+	bool inside  = false;
+	bool changed = false;
+
+	eye = frustum.cameraPosition;
+
+	for ( u32 r = 0; r < rooms.size(); r++ ) {
+		seen[ r ] = false;
+	}
+
+	for ( u32 r = 0; r < rooms.size(); r++ ) {
+		if ( rooms[ r ].box.isPointInside( eye ) ) {
+			inside = true;
+			visit( r, frustum.planes, scene::SViewFrustum::VF_PLANE_COUNT, 0 );
+		}
+	}
+
+	for ( u32 r = 0; r < rooms.size(); r++ ) {
+		if ( !inside ) {
+			seen[ r ] = true;
+		}
+		if ( seen[ r ] != visible[ r ] ) {
+			visible[ r ] = seen[ r ];
+			changed      = true;
+		}
+	}
+
+	return changed;
+}
+
+bool mdcPortalCuller::isRoomVisible( u32 r ) const {
+	return visible[ r ];
+}
+
+s32 mdcPortalCuller::findRoom( const core::stringw & name ) const {
+	for ( u32 r = 0; r < rooms.size(); r++ ) {
+		if ( rooms[ r ].name == name ) {
+			return r;
+		}
+	}
+	return -1;
+}
+
+/*------------------------------------------------------------------------------
+; mdcPortalCuller::visit()
+;
+; Marks a room as seen and walks on through each of its portals that is
+; still inside the frustum, given as planes facing out of it. The frustum
+; behind a portal is the pyramid from the eye through what is left of it.
+; Rooms already on the current path are not entered again.
+;-----------------------------------------------------------------------------*/
+void mdcPortalCuller::visit( u32 room, const core::plane3df * planes, u32 numPlanes, u32 depth ) {
+	core::vector3df   poly[ PORTAL_MAX_VERTICES ];
+	core::vector3df   tmp[ PORTAL_MAX_VERTICES ];
+	core::plane3df    narrowed[ PORTAL_MAX_VERTICES ];
+	core::vector3df   center;
+	u32               numNarrowed;
+	u32               n;
+	u32               next;
+
+	seen[ room ] = true;
+
+	if ( depth >= PORTAL_MAX_DEPTH ) {
+		return;
+	}
+
+	onPath[ room ] = true;
+
+	for ( u32 p = 0; p < portals.size(); p++ ) {
+		if ( portals[ p ].rooms[ 0 ] == room ) {
+			next = portals[ p ].rooms[ 1 ];
+		} else if ( portals[ p ].rooms[ 1 ] == room ) {
+			next = portals[ p ].rooms[ 0 ];
+		} else {
+			continue;
+		}
+
+		if ( onPath[ next ] ) {
+			continue;
+		}
+
+		// Standing in the opening, anything the frustum holds is seen through it.
+		if ( fabsf( core::plane3df( portals[ p ].corners[ 0 ], portals[ p ].corners[ 1 ],
+		                            portals[ p ].corners[ 2 ] ).getDistanceTo( eye ) ) < PORTAL_EPSILON ) {
+			visit( next, planes, numPlanes, depth + 1 );
+			continue;
+		}
+
+		for ( n = 0; n < 4; n++ ) {
+			poly[ n ] = portals[ p ].corners[ n ];
+		}
+
+		for ( u32 i = 0; i < numPlanes && n >= 3; i++ ) {
+			n = clip( poly, n, planes[ i ], tmp );
+			for ( u32 k = 0; k < n; k++ ) {
+				poly[ k ] = tmp[ k ];
+			}
+		}
+
+		if ( n < 3 ) {
+			continue;
+		}
+
+		center.set( 0.0f, 0.0f, 0.0f );
+		for ( u32 k = 0; k < n; k++ ) {
+			center += poly[ k ];
+		}
+		center /= ( f32 )n;
+
+		// One plane through the eye and each edge, facing away from the opening.
+		numNarrowed = 0;
+		for ( u32 k = 0; k < n; k++ ) {
+			core::plane3df side( eye, poly[ k ], poly[ ( k + 1 ) % n ] );
+
+			if ( side.Normal.getLengthSQ() == 0.0f ) {
+				continue;
+			}
+			if ( side.getDistanceTo( center ) > 0.0f ) {
+				side.Normal = -side.Normal;
+				side.D      = -side.D;
+			}
+			narrowed[ numNarrowed++ ] = side;
+		}
+
+		visit( next, narrowed, numNarrowed, depth + 1 );
+	}
+
+	onPath[ room ] = false;
+}
+
+/*------------------------------------------------------------------------------
+; mdcPortalCuller::clip()
+;
+; Keeps the part of a convex polygon behind the plane. If the result would
+; not fit the polygon is returned whole, which can only show more.
+;-----------------------------------------------------------------------------*/
+u32 mdcPortalCuller::clip( const core::vector3df * in, u32 n, const core::plane3df & plane, core::vector3df * out ) const {
+	u32 count = 0;
+	f32 d0;
+	f32 d1;
+
+	for ( u32 i = 0; i < n; i++ ) {
+		const core::vector3df & a = in[ i ];
+		const core::vector3df & b = in[ ( i + 1 ) % n ];
+
+		d0 = plane.getDistanceTo( a );
+		d1 = plane.getDistanceTo( b );
+
+		if ( count + 2 > PORTAL_MAX_VERTICES ) {
+			for ( count = 0; count < n; count++ ) {
+				out[ count ] = in[ count ];
+			}
+			return count;
+		}
+
+		if ( d0 <= 0.0f ) {
+			out[ count++ ] = a;
+		}
+		if ( ( d0 <= 0.0f ) != ( d1 <= 0.0f ) ) {
+			out[ count++ ] = a + ( b - a ) * ( d0 / ( d0 - d1 ) );
+		}
+	}
+
+	return count;
+}
+
+static f32 component( const core::vector3df & v, int axis ) {
+	return axis == 0 ? v.X : ( axis == 1 ? v.Y : v.Z );
+}
+
+static void setComponent( core::vector3df & v, int axis, f32 value ) {
+	if ( axis == 0 ) {
+		v.X = value;
+	} else if ( axis == 1 ) {
+		v.Y = value;
+	} else {
+		v.Z = value;
+	}
+}
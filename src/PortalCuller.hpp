@@ -0,0 +1,85 @@
+/*------------------------------------------------------------------------------
+; File:          PortalCuller.hpp
+; Description:   Declaration of the portal visibility class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#ifndef PORTALCULLER_H
+#define PORTALCULLER_H
+
+#include <irrlicht.h>
+
+#include "definitions.hpp"
+
+using namespace irr;
+
+// Limits of a single walk through the portals.
+#define PORTAL_MAX_DEPTH     8
+#define PORTAL_MAX_VERTICES  16
+
+// A room of scene.xml, an axis aligned box.
+typedef struct PORTAL_ROOM {
+	core::stringw      name;
+	core::aabbox3df    box;
+} portalRoom_t;
+
+// An opening between two rooms. Its box is flattened along its thinnest
+// axis into the four corners of the opening.
+typedef struct PORTAL_PORTAL {
+	u32                rooms[ 2 ];
+	core::vector3df    corners[ 4 ];
+} portalPortal_t;
+
+/*------------------------------------------------------------------------------
+; Room and portal visibility. The rooms seen from the camera are found by
+; walking from the room holding it through every portal that is inside the
+; view frustum, narrowing the frustum to the part of the portal still seen
+; at each step. Rooms can overlap, a point belongs to every room holding it.
+;-----------------------------------------------------------------------------*/
+class mdcPortalCuller {
+	public:
+		mdcPortalCuller();
+
+		// Building.
+		void                            addRoom( const core::stringw &, const core::aabbox3df & );
+		bool                            addPortal( const core::stringw &, const core::stringw &, const core::aabbox3df & );
+		u32                             getRoomCount()                                              const;
+		void                            getRooms( const core::aabbox3df &, core::array< u32 > & )   const;
+
+		// Queries. update() returns true if the set of visible rooms changed.
+		bool                            update( const scene::SViewFrustum & );
+		bool                            isRoomVisible( u32 )                                        const;
+
+	private:
+		core::array< portalRoom_t >     rooms;
+		core::array< portalPortal_t >   portals;
+		core::array< bool >             visible;
+		core::array< bool >             seen;
+		core::array< bool >             onPath;
+		core::vector3df                 eye;
+
+		mdcPortalCuller( mdcPortalCuller const & ) { };
+		mdcPortalCuller & operator=( mdcPortalCuller const & ) { return *this; }
+
+		s32                             findRoom( const core::stringw & )                           const;
+		void                            visit( u32, const core::plane3df *, u32, u32 );
+		u32                             clip( const core::vector3df *, u32, const core::plane3df &,
+		                                      core::vector3df * )                                   const;
+};
+
+#endif // PORTALCULLER_H
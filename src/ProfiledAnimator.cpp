@@ -0,0 +1,148 @@
+/*------------------------------------------------------------------------------
+; File:          ProfiledAnimator.cpp
+; Description:   Implementation of the profiled animator wrapper class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#include "ProfiledAnimator.hpp"
+
+mdcProfiledAnimator::mdcProfiledAnimator( scene::ISceneNodeAnimatorCollisionResponse * a, profileZone_t z ) {
+	animator = a;
+	zone     = z;
+	animator->grab();
+}
+
+mdcProfiledAnimator::~mdcProfiledAnimator() {
+	animator->drop();
+}
+
+void mdcProfiledAnimator::animateNode( scene::ISceneNode * node, u32 timeMs ) {
+	PROFILE_ZONE( zone );
+	animator->animateNode( node, timeMs );
+}
+
+scene::ISceneNodeAnimator * mdcProfiledAnimator::createClone( scene::ISceneNode * node, scene::ISceneManager * newManager ) {
+	scene::ISceneNodeAnimator * clone = animator->createClone( node, newManager );
+	mdcProfiledAnimator       * wrapper;
+
+	if ( clone == NULL ) {
+		return NULL;
+	}
+
+	// Clones keep the type of the original.
+	wrapper = new mdcProfiledAnimator( static_cast< scene::ISceneNodeAnimatorCollisionResponse * >( clone ), zone );
+	clone->drop();
+
+	return wrapper;
+}
+
+bool mdcProfiledAnimator::isEventReceiverEnabled() const {
+	return animator->isEventReceiverEnabled();
+}
+
+bool mdcProfiledAnimator::OnEvent( const SEvent & event ) {
+	return animator->OnEvent( event );
+}
+
+bool mdcProfiledAnimator::hasFinished() const {
+	return animator->hasFinished();
+}
+
+scene::ESCENE_NODE_ANIMATOR_TYPE mdcProfiledAnimator::getType() const {
+	return animator->getType();
+}
+
+bool mdcProfiledAnimator::isFalling() const {
+	return animator->isFalling();
+}
+
+void mdcProfiledAnimator::setEllipsoidRadius( const core::vector3df & radius ) {
+	animator->setEllipsoidRadius( radius );
+}
+
+core::vector3df mdcProfiledAnimator::getEllipsoidRadius() const {
+	return animator->getEllipsoidRadius();
+}
+
+void mdcProfiledAnimator::setGravity( const core::vector3df & gravity ) {
+	animator->setGravity( gravity );
+}
+
+core::vector3df mdcProfiledAnimator::getGravity() const {
+	return animator->getGravity();
+}
+
+void mdcProfiledAnimator::jump( f32 jumpSpeed ) {
+	animator->jump( jumpSpeed );
+}
+
+void mdcProfiledAnimator::setAnimateTarget( bool enable ) {
+	animator->setAnimateTarget( enable );
+}
+
+bool mdcProfiledAnimator::getAnimateTarget() const {
+	return animator->getAnimateTarget();
+}
+
+void mdcProfiledAnimator::setEllipsoidTranslation( const core::vector3df & translation ) {
+	animator->setEllipsoidTranslation( translation );
+}
+
+core::vector3df mdcProfiledAnimator::getEllipsoidTranslation() const {
+	return animator->getEllipsoidTranslation();
+}
+
+void mdcProfiledAnimator::setWorld( scene::ITriangleSelector * newWorld ) {
+	animator->setWorld( newWorld );
+}
+
+scene::ITriangleSelector * mdcProfiledAnimator::getWorld() const {
+	return animator->getWorld();
+}
+
+void mdcProfiledAnimator::setTargetNode( scene::ISceneNode * node ) {
+	animator->setTargetNode( node );
+}
+
+scene::ISceneNode * mdcProfiledAnimator::getTargetNode() const {
+	return animator->getTargetNode();
+}
+
+bool mdcProfiledAnimator::collisionOccurred() const {
+	return animator->collisionOccurred();
+}
+
+const core::vector3df & mdcProfiledAnimator::getCollisionPoint() const {
+	return animator->getCollisionPoint();
+}
+
+const core::triangle3df & mdcProfiledAnimator::getCollisionTriangle() const {
+	return animator->getCollisionTriangle();
+}
+
+const core::vector3df & mdcProfiledAnimator::getCollisionResultPosition() const {
+	return animator->getCollisionResultPosition();
+}
+
+scene::ISceneNode * mdcProfiledAnimator::getCollisionNode() const {
+	return animator->getCollisionNode();
+}
+
+void mdcProfiledAnimator::setCollisionCallback( scene::ICollisionCallback * callback ) {
+	animator->setCollisionCallback( callback );
+}
@@ -0,0 +1,80 @@
+/*------------------------------------------------------------------------------
+; File:          ProfiledAnimator.hpp
+; Description:   Declaration of the profiled animator wrapper class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#ifndef PROFILEDANIMATOR_H
+#define PROFILEDANIMATOR_H
+
+#include <irrlicht.h>
+
+#include "definitions.hpp"
+#include "Profiler.hpp"
+
+using namespace irr;
+
+/*------------------------------------------------------------------------------
+; Runs a collision response animator inside a profiler zone, to time the work
+; Irrlicht does for it inside ISceneManager::drawAll(). It reports the type of
+; the wrapped animator and forwards the whole collision response interface,
+; since the FPS camera animator finds the collider by type to make it jump.
+;-----------------------------------------------------------------------------*/
+class mdcProfiledAnimator : public scene::ISceneNodeAnimatorCollisionResponse {
+	public:
+		mdcProfiledAnimator( scene::ISceneNodeAnimatorCollisionResponse *, profileZone_t );
+		virtual ~mdcProfiledAnimator();
+
+		virtual void                            animateNode( scene::ISceneNode *, u32 );
+		virtual scene::ISceneNodeAnimator *     createClone( scene::ISceneNode *, scene::ISceneManager * = 0 );
+		virtual bool                            isEventReceiverEnabled()                const;
+		virtual bool                            OnEvent( const SEvent & );
+		virtual bool                            hasFinished()                           const;
+		virtual scene::ESCENE_NODE_ANIMATOR_TYPE getType()                              const;
+
+		// Collision response, forwarded as is.
+		virtual bool                            isFalling()                             const;
+		virtual void                            setEllipsoidRadius( const core::vector3df & );
+		virtual core::vector3df                 getEllipsoidRadius()                    const;
+		virtual void                            setGravity( const core::vector3df & );
+		virtual core::vector3df                 getGravity()                            const;
+		virtual void                            jump( f32 );
+		virtual void                            setAnimateTarget( bool );
+		virtual bool                            getAnimateTarget()                      const;
+		virtual void                            setEllipsoidTranslation( const core::vector3df & );
+		virtual core::vector3df                 getEllipsoidTranslation()               const;
+		virtual void                            setWorld( scene::ITriangleSelector * );
+		virtual scene::ITriangleSelector *      getWorld()                              const;
+		virtual void                            setTargetNode( scene::ISceneNode * );
+		virtual scene::ISceneNode *             getTargetNode()                         const;
+		virtual bool                            collisionOccurred()                     const;
+		virtual const core::vector3df &         getCollisionPoint()                     const;
+		virtual const core::triangle3df &       getCollisionTriangle()                  const;
+		virtual const core::vector3df &         getCollisionResultPosition()            const;
+		virtual scene::ISceneNode *             getCollisionNode()                      const;
+		virtual void                            setCollisionCallback( scene::ICollisionCallback * );
+
+	private:
+		scene::ISceneNodeAnimatorCollisionResponse * animator;
+		profileZone_t                           zone;
+
+		mdcProfiledAnimator( mdcProfiledAnimator const & ) { };
+		mdcProfiledAnimator & operator=( mdcProfiledAnimator const & ) { return *this; }
+};
+
+#endif // PROFILEDANIMATOR_H
@@ -0,0 +1,119 @@
+/*------------------------------------------------------------------------------
+; File:          Profiler.cpp
+; Description:   Implementation of the frame profiler class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+
+#include "Profiler.hpp"
+
+u64 mdcProfiler::current[ NUM_ZONES ];
+u32 mdcProfiler::zones[ PROFILER_HISTORY ][ NUM_ZONES ];
+u32 mdcProfiler::frames[ PROFILER_HISTORY ];
+u32 mdcProfiler::head         = 0;
+u32 mdcProfiler::count        = 0;
+u64 mdcProfiler::lastFrameEnd = 0;
+
+static const wchar_t * ZONE_NAMES[ NUM_ZONES ] = {
+	L"device->run",
+	L"loader",
+	L"smgr->drawAll",
+	L"  collision",
+	L"guienv->drawAll",
+	L"endScene",
+	L"pick"
+};
+
+void mdcProfiler::addTime( profileZone_t zone, u64 us ) {
+	current[ zone ] += us;
+}
+
+/*------------------------------------------------------------------------------
+; mdcProfiler::endFrame()
+;
+; Stores the zone times of the frame that just ended and starts a new one.
+; The frame time is the time since the previous call, so it includes the
+; time no zone covers.
+;-----------------------------------------------------------------------------*/
+void mdcProfiler::endFrame() {
+	u64 now = mdcTimer::getMicroseconds();
+
+	for ( int z = 0; z < NUM_ZONES; z++ ) {
+		zones[ head ][ z ] = ( u32 )current[ z ];
+		current[ z ]       = 0;
+	}
+
+	frames[ head ] = lastFrameEnd == 0 ? 0 : ( u32 )( now - lastFrameEnd );
+	lastFrameEnd   = now;
+
+	head = ( head + 1 ) % PROFILER_HISTORY;
+	if ( count < PROFILER_HISTORY ) {
+		count++;
+	}
+}
+
+u32 mdcProfiler::getFrameCount() {
+	return count;
+}
+
+f32 mdcProfiler::getFrameMs( u32 i ) {
+	return frames[ getSlot( i ) ] / 1000.0f;
+}
+
+f32 mdcProfiler::getZoneMs( profileZone_t zone, u32 i ) {
+	return zones[ getSlot( i ) ][ zone ] / 1000.0f;
+}
+
+f32 mdcProfiler::getAverageFrameMs() {
+	u64 total = 0;
+
+	for ( u32 i = 0; i < count; i++ ) {
+		total += frames[ getSlot( i ) ];
+	}
+
+	return count > 0 ? total / ( count * 1000.0f ) : 0.0f;
+}
+
+f32 mdcProfiler::getAverageZoneMs( profileZone_t zone ) {
+	u64 total = 0;
+
+	for ( u32 i = 0; i < count; i++ ) {
+		total += zones[ getSlot( i ) ][ zone ];
+	}
+
+	return count > 0 ? total / ( count * 1000.0f ) : 0.0f;
+}
+
+f32 mdcProfiler::getMaxZoneMs( profileZone_t zone ) {
+	u32 best = 0;
+
+	for ( u32 i = 0; i < count; i++ ) {
+		best = core::max_( best, zones[ getSlot( i ) ][ zone ] );
+	}
+
+	return best / 1000.0f;
+}
+
+const wchar_t * mdcProfiler::getZoneName( profileZone_t zone ) {
+	return ZONE_NAMES[ zone ];
+}
+
+// Ring slot of the i-th oldest frame in the history.
+u32 mdcProfiler::getSlot( u32 i ) {
+	return ( head + PROFILER_HISTORY - count + i ) % PROFILER_HISTORY;
+}
@@ -0,0 +1,103 @@
+/*------------------------------------------------------------------------------
+; File:          Profiler.hpp
+; Description:   Declaration of the frame profiler class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <irrlicht.h>
+
+#include "definitions.hpp"
+#include "Timer.hpp"
+
+using namespace irr;
+
+// Frames kept in the history.
+#define PROFILER_HISTORY 128
+
+typedef enum PROFILE_ZONE {
+	ZONE_DEVICE_RUN = 0,
+	ZONE_LOADER,
+	ZONE_DRAW_SCENE,
+	ZONE_COLLISION,
+	ZONE_DRAW_GUI,
+	ZONE_END_SCENE,
+	ZONE_PICK,
+	NUM_ZONES
+} profileZone_t;
+
+/*------------------------------------------------------------------------------
+; Per frame CPU time of a fixed set of zones. Zone times are added up during
+; the frame and stored in a ring of the last PROFILER_HISTORY frames by
+; endFrame(), together with the whole frame time. Only the main thread may
+; profile.
+;-----------------------------------------------------------------------------*/
+class mdcProfiler {
+	public:
+		static void                     addTime( profileZone_t, u64 );
+		static void                     endFrame();
+
+		// History, index 0 is the oldest frame.
+		static u32                      getFrameCount();
+		static f32                      getFrameMs( u32 );
+		static f32                      getZoneMs( profileZone_t, u32 );
+		static f32                      getAverageFrameMs();
+		static f32                      getAverageZoneMs( profileZone_t );
+		static f32                      getMaxZoneMs( profileZone_t );
+		static const wchar_t      *     getZoneName( profileZone_t );
+
+	private:
+		static u64                      current[ NUM_ZONES ];
+		static u32                      zones[ PROFILER_HISTORY ][ NUM_ZONES ];
+		static u32                      frames[ PROFILER_HISTORY ];
+		static u32                      head;
+		static u32                      count;
+		static u64                      lastFrameEnd;
+
+		mdcProfiler() { };
+		mdcProfiler( mdcProfiler const & ) { };
+		mdcProfiler & operator=( mdcProfiler const & ) { return *this; }
+
+		static u32                      getSlot( u32 );
+};
+
+/*------------------------------------------------------------------------------
+; Adds the time from its construction to its destruction to a zone.
+;-----------------------------------------------------------------------------*/
+class mdcProfileScope {
+	public:
+		mdcProfileScope( profileZone_t z ) : zone( z ), start( mdcTimer::getMicroseconds() ) { }
+		~mdcProfileScope() { mdcProfiler::addTime( zone, mdcTimer::getMicroseconds() - start ); }
+
+	private:
+		profileZone_t                   zone;
+		u64                             start;
+
+		mdcProfileScope( mdcProfileScope const & ) { };
+		mdcProfileScope & operator=( mdcProfileScope const & ) { return *this; }
+};
+
+#define PROFILE_CONCAT_( a, b ) a##b
+#define PROFILE_CONCAT( a, b )  PROFILE_CONCAT_( a, b )
+
+// Profiles the rest of the enclosing block.
+#define PROFILE_ZONE( zone )    mdcProfileScope PROFILE_CONCAT( profileScope, __LINE__ )( zone )
+
+#endif // PROFILER_H
@@ -0,0 +1,366 @@
+/*------------------------------------------------------------------------------
+; File:          Pvs.cpp
+; Description:   Implementation of the potentially visible set class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+
+#include "Pvs.hpp"
+#include "CollisionBvh.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+using std::cerr;
+using std::endl;
+
+typedef struct PVS_JOB {
+	mdcPvs     *   owner;
+	u32            row;
+} pvsJob_t;
+
+static f32 nextRandom( u32 & );
+
+mdcPvs::mdcPvs() {
+	cellSize = 0.0f;
+	dims[ 0 ] = dims[ 1 ] = dims[ 2 ] = 0;
+	rowBytes = 0;
+	world    = NULL;
+	pending  = 0;
+}
+
+/*------------------------------------------------------------------------------
+; mdcPvs::compute()
+;
+; Splits the box into cubes, PVS_GRID of them along its longest side, and
+; finds which cells can see each other through the occluders of the world.
+; Every row of the matrix is a job on its own thread pool, a row only tests
+; the cells after its own and the lower half is mirrored at the end.
+;-----------------------------------------------------------------------------*/
+void mdcPvs::compute( const mdcCollisionBvh * world, const core::aabbox3df & bounds ) {
+	core::vector3df            extent = bounds.getExtent();
+	core::array< pvsJob_t >    jobs;
+	mdcThreadPool          *   pool;
+	f32                        longest;
+	u32                        size[ 3 ];
+	u32                        n;
+
+	TRACE_SCOPE( "mdcPvs::compute" );
+
+	longest = core::max_( extent.X, extent.Y, extent.Z );
+	if ( longest <= 0.0f ) {
+		bits.clear();
+		return;
+	}
+
+	size[ 0 ] = core::clamp( ( u32 )ceilf( extent.X * PVS_GRID / longest ), 1u, ( u32 )PVS_GRID );
+	size[ 1 ] = core::clamp( ( u32 )ceilf( extent.Y * PVS_GRID / longest ), 1u, ( u32 )PVS_GRID );
+	size[ 2 ] = core::clamp( ( u32 )ceilf( extent.Z * PVS_GRID / longest ), 1u, ( u32 )PVS_GRID );
+
+	setGrid( bounds.MinEdge, longest / PVS_GRID, size );
+	n = getCellCount();
+
+	this->world = world;
+	pending     = n;
+
+	pthread_mutex_init( &lock, NULL );
+	pthread_cond_init( &jobDone, NULL );
+
+	jobs.set_used( n );
+	pool = new mdcThreadPool();
+
+	for ( u32 i = 0; i < n; i++ ) {
+		jobs[ i ].owner = this;
+		jobs[ i ].row   = i;
+		pool->submit( rowMain, &jobs[ i ] );
+	}
+
+	pthread_mutex_lock( &lock );
+	while ( pending > 0 ) {
+		pthread_cond_wait( &jobDone, &lock );
+	}
+	pthread_mutex_unlock( &lock );
+
+	delete pool;
+
+	pthread_cond_destroy( &jobDone );
+	pthread_mutex_destroy( &lock );
+
+	this->world = NULL;
+
+	for ( u32 i = 0; i < n; i++ ) {
+		setVisible( i, i );
+		for ( u32 j = i + 1; j < n; j++ ) {
+			if ( isVisible( i, j ) ) {
+				setVisible( j, i );
+			}
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------
+; mdcPvs::load()
+;
+; Reads a set written by save(). Grids larger than the bake makes, or files
+; whose length does not match their grid, are rejected.
+;-----------------------------------------------------------------------------*/
+bool mdcPvs::load( const char * path ) {
+	pvsHeader_t   header;
+	FILE      *   fp;
+	long          size;
+	u32           n;
+	bool          ok;
+
+	TRACE_SCOPE_ARG( "mdcPvs::load", path );
+
+	fp = fopen( path, "rb" );
+	if ( fp == NULL ) {
+		return false;
+	}
+
+	ok = fseek( fp, 0, SEEK_END ) == 0 && ( size = ftell( fp ) ) >= 0 && fseek( fp, 0, SEEK_SET ) == 0;
+
+	ok = ok && fread( &header, sizeof( header ), 1, fp ) == 1 &&
+	     header.magic == PVS_MAGIC && header.version == PVS_VERSION &&
+	     header.cellSize > 0.0f &&
+	     header.dims[ 0 ] > 0 && header.dims[ 0 ] <= PVS_GRID &&
+	     header.dims[ 1 ] > 0 && header.dims[ 1 ] <= PVS_GRID &&
+	     header.dims[ 2 ] > 0 && header.dims[ 2 ] <= PVS_GRID;
+
+	// With every side at most PVS_GRID the matrix size cannot overflow.
+	if ( ok ) {
+		n  = header.dims[ 0 ] * header.dims[ 1 ] * header.dims[ 2 ];
+		ok = ( u32 )size - sizeof( header ) == n * ( ( n + 7 ) / 8 );
+	}
+
+	if ( ok ) {
+		setGrid( core::vector3df( header.origin[ 0 ], header.origin[ 1 ], header.origin[ 2 ] ),
+		         header.cellSize, header.dims );
+		ok = fread( bits.pointer(), 1, bits.size(), fp ) == bits.size();
+	}
+
+	fclose( fp );
+
+	if ( !ok ) {
+		cerr << "mdcPvs::load() - Ignoring damaged file " << path << endl;
+		bits.clear();
+		return false;
+	}
+
+	return true;
+}
+
+bool mdcPvs::save( const char * path ) const {
+	pvsHeader_t   header;
+	FILE      *   fp;
+	bool          ok;
+
+	if ( bits.size() == 0 ) {
+		return false;
+	}
+
+	header.magic       = PVS_MAGIC;
+	header.version     = PVS_VERSION;
+	header.origin[ 0 ] = origin.X;
+	header.origin[ 1 ] = origin.Y;
+	header.origin[ 2 ] = origin.Z;
+	header.cellSize    = cellSize;
+	header.dims[ 0 ]   = dims[ 0 ];
+	header.dims[ 1 ]   = dims[ 1 ];
+	header.dims[ 2 ]   = dims[ 2 ];
+
+	fp = fopen( path, "wb" );
+	if ( fp == NULL ) {
+		cerr << "mdcPvs::save() - Could not create " << path << endl;
+		return false;
+	}
+
+	ok = fwrite( &header, sizeof( header ), 1, fp ) == 1 &&
+	     fwrite( bits.const_pointer(), 1, bits.size(), fp ) == bits.size();
+	ok = ( fclose( fp ) == 0 ) && ok;
+
+	if ( !ok ) {
+		remove( path );
+	}
+
+	return ok;
+}
+
+/*------------------------------------------------------------------------------
+; mdcPvs::getCell()
+;
+; Returns the cell holding the point, -1 if it is outside the grid or there
+; is no set loaded.
+;-----------------------------------------------------------------------------*/
+s32 mdcPvs::getCell( const core::vector3df & point ) const {
+	core::vector3df rel;
+	s32             c[ 3 ];
+
+	if ( bits.size() == 0 ) {
+		return -1;
+	}
+
+	rel    = ( point - origin ) / cellSize;
+	c[ 0 ] = core::floor32( rel.X );
+	c[ 1 ] = core::floor32( rel.Y );
+	c[ 2 ] = core::floor32( rel.Z );
+
+	for ( u32 a = 0; a < 3; a++ ) {
+		if ( c[ a ] < 0 || c[ a ] >= ( s32 )dims[ a ] ) {
+			return -1;
+		}
+	}
+
+	return c[ 0 ] + dims[ 0 ] * ( c[ 1 ] + dims[ 1 ] * c[ 2 ] );
+}
+
+/*------------------------------------------------------------------------------
+; mdcPvs::getCells()
+;
+; Appends every cell the box touches. Parts of the box outside the grid are
+; ignored.
+;-----------------------------------------------------------------------------*/
+void mdcPvs::getCells( const core::aabbox3df & box, core::array< u32 > & cells ) const {
+	core::vector3df lo;
+	core::vector3df hi;
+	s32             from[ 3 ];
+	s32             to[ 3 ];
+
+	if ( bits.size() == 0 ) {
+		return;
+	}
+
+	lo = ( box.MinEdge - origin ) / cellSize;
+	hi = ( box.MaxEdge - origin ) / cellSize;
+
+	from[ 0 ] = core::max_( core::floor32( lo.X ), 0 );
+	from[ 1 ] = core::max_( core::floor32( lo.Y ), 0 );
+	from[ 2 ] = core::max_( core::floor32( lo.Z ), 0 );
+	to[ 0 ]   = core::min_( core::floor32( hi.X ), ( s32 )dims[ 0 ] - 1 );
+	to[ 1 ]   = core::min_( core::floor32( hi.Y ), ( s32 )dims[ 1 ] - 1 );
+	to[ 2 ]   = core::min_( core::floor32( hi.Z ), ( s32 )dims[ 2 ] - 1 );
+
+	for ( s32 z = from[ 2 ]; z <= to[ 2 ]; z++ ) {
+		for ( s32 y = from[ 1 ]; y <= to[ 1 ]; y++ ) {
+			for ( s32 x = from[ 0 ]; x <= to[ 0 ]; x++ ) {
+				cells.push_back( x + dims[ 0 ] * ( y + dims[ 1 ] * z ) );
+			}
+		}
+	}
+}
+
+u32 mdcPvs::getCellCount() const {
+	return bits.size() == 0 ? 0 : dims[ 0 ] * dims[ 1 ] * dims[ 2 ];
+}
+
+bool mdcPvs::isVisible( u32 from, u32 to ) const {
+	return ( bits[ from * rowBytes + ( to >> 3 ) ] & ( 1 << ( to & 7 ) ) ) != 0;
+}
+
+void mdcPvs::setGrid( const core::vector3df & corner, f32 size, const u32 * count ) {
+	u32 n = count[ 0 ] * count[ 1 ] * count[ 2 ];
+
+	origin    = corner;
+	cellSize  = size;
+	dims[ 0 ] = count[ 0 ];
+	dims[ 1 ] = count[ 1 ];
+	dims[ 2 ] = count[ 2 ];
+	rowBytes  = ( n + 7 ) / 8;
+
+	bits.set_used( n * rowBytes );
+	memset( bits.pointer(), 0, bits.size() );
+}
+
+core::aabbox3df mdcPvs::getCellBox( u32 cell ) const {
+	core::vector3df corner;
+
+	corner.X = origin.X + ( cell % dims[ 0 ] ) * cellSize;
+	corner.Y = origin.Y + ( ( cell / dims[ 0 ] ) % dims[ 1 ] ) * cellSize;
+	corner.Z = origin.Z + ( cell / ( dims[ 0 ] * dims[ 1 ] ) ) * cellSize;
+
+	return core::aabbox3df( corner, corner + core::vector3df( cellSize ) );
+}
+
+/*------------------------------------------------------------------------------
+; mdcPvs::castSamples()
+;
+; Casts segments between random points of both cells, the centers first.
+; The points only depend on the pair, so a bake is repeatable.
+;-----------------------------------------------------------------------------*/
+bool mdcPvs::castSamples( u32 a, u32 b ) const {
+	core::aabbox3df   boxA = getCellBox( a );
+	core::aabbox3df   boxB = getCellBox( b );
+	core::vector3df   p;
+	core::vector3df   q;
+	u32               seed = ( a * 2654435761u ) ^ ( b * 40503u + 1 );
+
+	if ( !world->isSegmentOccluded( core::line3d< f32 >( boxA.getCenter(), boxB.getCenter() ) ) ) {
+		return true;
+	}
+
+	for ( u32 i = 1; i < PVS_SAMPLES; i++ ) {
+		p.X = boxA.MinEdge.X + nextRandom( seed ) * cellSize;
+		p.Y = boxA.MinEdge.Y + nextRandom( seed ) * cellSize;
+		p.Z = boxA.MinEdge.Z + nextRandom( seed ) * cellSize;
+		q.X = boxB.MinEdge.X + nextRandom( seed ) * cellSize;
+		q.Y = boxB.MinEdge.Y + nextRandom( seed ) * cellSize;
+		q.Z = boxB.MinEdge.Z + nextRandom( seed ) * cellSize;
+
+		if ( !world->isSegmentOccluded( core::line3d< f32 >( p, q ) ) ) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void mdcPvs::rowMain( void * arg ) {
+	pvsJob_t * job   = static_cast< pvsJob_t * >( arg );
+	mdcPvs   * owner = job->owner;
+
+	owner->computeRow( job->row );
+
+	pthread_mutex_lock( &owner->lock );
+	owner->pending--;
+	pthread_cond_broadcast( &owner->jobDone );
+	pthread_mutex_unlock( &owner->lock );
+}
+
+// Only writes the bytes of its own row, rows never share a byte.
+void mdcPvs::computeRow( u32 row ) {
+	u32 n = getCellCount();
+
+	for ( u32 j = row + 1; j < n; j++ ) {
+		if ( castSamples( row, j ) ) {
+			setVisible( row, j );
+		}
+	}
+}
+
+void mdcPvs::setVisible( u32 from, u32 to ) {
+	bits[ from * rowBytes + ( to >> 3 ) ] |= ( u8 )( 1 << ( to & 7 ) );
+}
+
+// Numerical Recipes LCG, the top 24 bits as a float in [0, 1).
+static f32 nextRandom( u32 & seed ) {
+	seed = seed * 1664525u + 1013904223u;
+	return ( seed >> 8 ) * ( 1.0f / 16777216.0f );
+}
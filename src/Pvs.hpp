@@ -0,0 +1,96 @@
+/*------------------------------------------------------------------------------
+; File:          Pvs.hpp
+; Description:   Declaration of the potentially visible set class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#ifndef PVS_H
+#define PVS_H
+
+#include <pthread.h>
+#include <irrlicht.h>
+
+#include "definitions.hpp"
+
+using namespace irr;
+
+// "MDCP" read as a little endian integer.
+#define PVS_MAGIC       0x5043444D
+#define PVS_VERSION     1
+
+// Cells along the longest side of the scene.
+#define PVS_GRID        16
+
+// Rays cast between two cells before they are taken as hidden from each other.
+#define PVS_SAMPLES     48
+
+typedef struct PVS_HEADER {
+	u32    magic;
+	u32    version;
+	f32    origin[ 3 ];
+	f32    cellSize;
+	u32    dims[ 3 ];
+} pvsHeader_t;
+
+/*------------------------------------------------------------------------------
+; Cell to cell visibility over a regular grid of cubic cells. Two cells see
+; each other if any of a number of random segments between them is not
+; blocked by an occluder of the collision BVH, so the result may miss a view
+; through a very small gap but never hides a cell that is in plain sight.
+; Stored as a bit matrix with one row per cell.
+;-----------------------------------------------------------------------------*/
+class mdcPvs {
+	public:
+		mdcPvs();
+
+		// Baking.
+		void                            compute( const mdcCollisionBvh *, const core::aabbox3df & );
+		bool                            save( const char * )                                        const;
+		bool                            load( const char * );
+
+		// Queries, cells outside the grid are -1.
+		s32                             getCell( const core::vector3df & )                          const;
+		void                            getCells( const core::aabbox3df &, core::array< u32 > & )   const;
+		u32                             getCellCount()                                              const;
+		bool                            isVisible( u32, u32 )                                       const;
+
+	private:
+		core::vector3df                 origin;
+		f32                             cellSize;
+		u32                             dims[ 3 ];
+		u32                             rowBytes;
+		core::array< u8 >               bits;
+
+		// Shared with the bake jobs.
+		const mdcCollisionBvh    *      world;
+		pthread_mutex_t                 lock;
+		pthread_cond_t                  jobDone;
+		u32                             pending;
+
+		mdcPvs( mdcPvs const & ) { };
+		mdcPvs & operator=( mdcPvs const & ) { return *this; }
+
+		void                            setGrid( const core::vector3df &, f32, const u32 * );
+		core::aabbox3df                 getCellBox( u32 )                                           const;
+		bool                            castSamples( u32, u32 )                                     const;
+		static void                     rowMain( void * );
+		void                            computeRow( u32 );
+		void                            setVisible( u32, u32 );
+};
+
+#endif // PVS_H
@@ -0,0 +1,483 @@
+/*------------------------------------------------------------------------------
+; File:          RayKernels.cpp
+; Description:   Implementation of the ray intersection kernels.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#if defined( __GNUC__ ) && ( defined( __i386__ ) || defined( __x86_64__ ) )
+#define KERNELS_X86
+#include <immintrin.h>
+#endif
+
+#include "RayKernels.hpp"
+
+using std::cout;
+using std::endl;
+
+// Triangles seen edge on by the ray are misses.
+#define KERNEL_EPSILON  1e-9f
+
+#define BENCH_RAYS      256
+#define BENCH_LENGTH    300.0f
+
+static u32 trianglesScalar( const triBlock_t &, const kernelRay_t &, f32, f32 * );
+static u32 boxesScalar( const boxBlock_t &, const kernelRay_t &, f32, f32 * );
+#ifdef KERNELS_X86
+static u32 trianglesSse( const triBlock_t &, const kernelRay_t &, f32, f32 * );
+static u32 boxesSse( const boxBlock_t &, const kernelRay_t &, f32, f32 * );
+static u32 trianglesAvx2( const triBlock_t &, const kernelRay_t &, f32, f32 * );
+static u32 boxesAvx2( const boxBlock_t &, const kernelRay_t &, f32, f32 * );
+#endif
+
+kernelPath_t mdcRayKernels::path      = KERNEL_SCALAR;
+triKernel_t  mdcRayKernels::triKernel = trianglesScalar;
+boxKernel_t  mdcRayKernels::boxKernel = boxesScalar;
+
+bool mdcRayKernels::isSupported( kernelPath_t p ) {
+	switch ( p ) {
+		case KERNEL_SCALAR:
+			return true;
+
+#ifdef KERNELS_X86
+		case KERNEL_SSE:
+			__builtin_cpu_init();
+			return __builtin_cpu_supports( "sse2" );
+
+		case KERNEL_AVX2:
+			__builtin_cpu_init();
+			return __builtin_cpu_supports( "avx2" );
+#endif
+
+		default:
+			return false;
+	}
+}
+
+/*------------------------------------------------------------------------------
+; mdcRayKernels::setPath()
+;
+; Forces the given path. Falls back to the scalar one if the CPU does not
+; support it. Not thread safe, must not be called while any thread may be
+; running a kernel.
+;-----------------------------------------------------------------------------*/
+void mdcRayKernels::setPath( kernelPath_t p ) {
+	if ( !isSupported( p ) ) {
+		p = KERNEL_SCALAR;
+	}
+
+	path = p;
+
+	switch ( p ) {
+#ifdef KERNELS_X86
+		case KERNEL_SSE:
+			triKernel = trianglesSse;
+			boxKernel = boxesSse;
+			break;
+
+		case KERNEL_AVX2:
+			triKernel = trianglesAvx2;
+			boxKernel = boxesAvx2;
+			break;
+#endif
+
+		default:
+			triKernel = trianglesScalar;
+			boxKernel = boxesScalar;
+			break;
+	}
+}
+
+kernelPath_t mdcRayKernels::getPath() {
+	return path;
+}
+
+const char * mdcRayKernels::getPathName( kernelPath_t p ) {
+	switch ( p ) {
+		case KERNEL_SCALAR: return "scalar";
+		case KERNEL_SSE:    return "SSE";
+		case KERNEL_AVX2:   return "AVX2";
+		default:            return "unknown";
+	}
+}
+
+void mdcRayKernels::makeRay( kernelRay_t & ray, const core::line3d< f32 > & line ) {
+	core::vector3df dir = line.end - line.start;
+
+	ray.origin[ 0 ] = line.start.X;
+	ray.origin[ 1 ] = line.start.Y;
+	ray.origin[ 2 ] = line.start.Z;
+	ray.dir[ 0 ]    = dir.X;
+	ray.dir[ 1 ]    = dir.Y;
+	ray.dir[ 2 ]    = dir.Z;
+
+	// A zero component gives an infinite inverse, which the slab test handles.
+	ray.invDir[ 0 ] = dir.X != 0.0f ? 1.0f / dir.X : 1e30f;
+	ray.invDir[ 1 ] = dir.Y != 0.0f ? 1.0f / dir.Y : 1e30f;
+	ray.invDir[ 2 ] = dir.Z != 0.0f ? 1.0f / dir.Z : 1e30f;
+}
+
+/*------------------------------------------------------------------------------
+; mdcRayKernels::packTriangle()
+;
+; Stores a triangle as the index-th lane of an array of blocks. The blocks
+; must be zeroed beforehand so unused lanes stay empty.
+;-----------------------------------------------------------------------------*/
+void mdcRayKernels::packTriangle( triBlock_t * blocks, u32 index, const core::triangle3df & tri ) {
+	triBlock_t      & b    = blocks[ index / KERNEL_WIDTH ];
+	u32               lane = index % KERNEL_WIDTH;
+	core::vector3df   e1   = tri.pointB - tri.pointA;
+	core::vector3df   e2   = tri.pointC - tri.pointA;
+
+	b.v0[ 0 ][ lane ] = tri.pointA.X;
+	b.v0[ 1 ][ lane ] = tri.pointA.Y;
+	b.v0[ 2 ][ lane ] = tri.pointA.Z;
+	b.e1[ 0 ][ lane ] = e1.X;
+	b.e1[ 1 ][ lane ] = e1.Y;
+	b.e1[ 2 ][ lane ] = e1.Z;
+	b.e2[ 0 ][ lane ] = e2.X;
+	b.e2[ 1 ][ lane ] = e2.Y;
+	b.e2[ 2 ][ lane ] = e2.Z;
+}
+
+void mdcRayKernels::packBox( boxBlock_t * blocks, u32 index, const core::aabbox3df & box ) {
+	boxBlock_t      & b    = blocks[ index / KERNEL_WIDTH ];
+	u32               lane = index % KERNEL_WIDTH;
+
+	b.min[ 0 ][ lane ] = box.MinEdge.X;
+	b.min[ 1 ][ lane ] = box.MinEdge.Y;
+	b.min[ 2 ][ lane ] = box.MinEdge.Z;
+	b.max[ 0 ][ lane ] = box.MaxEdge.X;
+	b.max[ 1 ][ lane ] = box.MaxEdge.Y;
+	b.max[ 2 ][ lane ] = box.MaxEdge.Z;
+}
+
+/*------------------------------------------------------------------------------
+; mdcRayKernels::getLaneMask()
+;
+; Returns the lanes of the given block that fall in [first, first + count).
+;-----------------------------------------------------------------------------*/
+u32 mdcRayKernels::getLaneMask( u32 block, u32 first, u32 count ) {
+	s32 lo = ( s32 )first - ( s32 )( block * KERNEL_WIDTH );
+	s32 hi = lo + ( s32 )count;
+	u32 mask = 0;
+
+	for ( s32 lane = 0; lane < KERNEL_WIDTH; lane++ ) {
+		if ( lane >= lo && lane < hi ) {
+			mask |= 1u << lane;
+		}
+	}
+
+	return mask;
+}
+
+u32 mdcRayKernels::intersectTriangles( const triBlock_t & b, const kernelRay_t & ray, f32 tMax, f32 * t ) {
+	return triKernel( b, ray, tMax, t );
+}
+
+u32 mdcRayKernels::intersectBoxes( const boxBlock_t & b, const kernelRay_t & ray, f32 tMax, f32 * tNear ) {
+	return boxKernel( b, ray, tMax, tNear );
+}
+
+/*------------------------------------------------------------------------------
+; mdcRayKernels::benchmark()
+;
+; Casts BENCH_RAYS random rays from the given point against every triangle,
+; once per supported path, and prints the time taken and the number of hits,
+; which must be the same for every path. The best path is restored at the
+; end.
+;-----------------------------------------------------------------------------*/
+void mdcRayKernels::benchmark( const triBlock_t * blocks, u32 numBlocks, const core::vector3df & from ) {
+	kernelRay_t   rays[ BENCH_RAYS ];
+	f32           t[ KERNEL_WIDTH ];
+	f32           baseline = 0.0f;
+
+	srand( 1 );
+	for ( u32 i = 0; i < BENCH_RAYS; i++ ) {
+		core::vector3df dir( rand() - RAND_MAX / 2.0f, rand() - RAND_MAX / 2.0f, rand() - RAND_MAX / 2.0f );
+
+		makeRay( rays[ i ], core::line3d< f32 >( from, from + dir.normalize() * BENCH_LENGTH ) );
+	}
+
+	cout << "Ray kernels: " << BENCH_RAYS << " rays against " << numBlocks * KERNEL_WIDTH << " triangles." << endl;
+
+	for ( int p = KERNEL_SCALAR; p < KERNEL_PATHS; p++ ) {
+		clock_t   start;
+		f32       ms;
+		u32       hits = 0;
+
+		if ( !isSupported( ( kernelPath_t )p ) ) {
+			cout << "  " << getPathName( ( kernelPath_t )p ) << ": not supported." << endl;
+			continue;
+		}
+
+		setPath( ( kernelPath_t )p );
+
+		start = clock();
+		for ( u32 r = 0; r < BENCH_RAYS; r++ ) {
+			for ( u32 b = 0; b < numBlocks; b++ ) {
+				u32 mask = intersectTriangles( blocks[ b ], rays[ r ], 1.0f, t );
+
+				while ( mask != 0 ) {
+					hits++;
+					mask &= mask - 1;
+				}
+			}
+		}
+		ms = ( clock() - start ) * 1000.0f / CLOCKS_PER_SEC;
+
+		if ( p == KERNEL_SCALAR ) {
+			baseline = ms;
+		}
+
+		cout << "  " << getPathName( ( kernelPath_t )p ) << ": " << ms << " ms, " << hits << " hits";
+		if ( ms > 0.0f ) {
+			cout << ", " << BENCH_RAYS * ( f32 )numBlocks * KERNEL_WIDTH / ( ms * 1000.0f ) << " Mtests/s, "
+			     << baseline / ms << "x scalar";
+		}
+		cout << endl;
+	}
+
+	setPath( getBestPath() );
+}
+
+kernelPath_t mdcRayKernels::getBestPath() {
+	if ( isSupported( KERNEL_AVX2 ) ) {
+		return KERNEL_AVX2;
+	}
+
+	return isSupported( KERNEL_SSE ) ? KERNEL_SSE : KERNEL_SCALAR;
+}
+
+/*------------------------------------------------------------------------------
+; trianglesScalar()
+;
+; Moller-Trumbore, both sides of the triangle count.
+;-----------------------------------------------------------------------------*/
+static u32 trianglesScalar( const triBlock_t & b, const kernelRay_t & ray, f32 tMax, f32 * t ) {
+	const f32 * o    = ray.origin;
+	const f32 * d    = ray.dir;
+	u32         mask = 0;
+
+	for ( int i = 0; i < KERNEL_WIDTH; i++ ) {
+		f32 px  = d[ 1 ] * b.e2[ 2 ][ i ] - d[ 2 ] * b.e2[ 1 ][ i ];
+		f32 py  = d[ 2 ] * b.e2[ 0 ][ i ] - d[ 0 ] * b.e2[ 2 ][ i ];
+		f32 pz  = d[ 0 ] * b.e2[ 1 ][ i ] - d[ 1 ] * b.e2[ 0 ][ i ];
+		f32 det = b.e1[ 0 ][ i ] * px + b.e1[ 1 ][ i ] * py + b.e1[ 2 ][ i ] * pz;
+		f32 inv, sx, sy, sz, qx, qy, qz, u, v;
+
+		t[ i ] = 0.0f;
+
+		if ( det > -KERNEL_EPSILON && det < KERNEL_EPSILON ) {
+			continue;
+		}
+
+		inv = 1.0f / det;
+		sx  = o[ 0 ] - b.v0[ 0 ][ i ];
+		sy  = o[ 1 ] - b.v0[ 1 ][ i ];
+		sz  = o[ 2 ] - b.v0[ 2 ][ i ];
+		u   = ( sx * px + sy * py + sz * pz ) * inv;
+
+		qx  = sy * b.e1[ 2 ][ i ] - sz * b.e1[ 1 ][ i ];
+		qy  = sz * b.e1[ 0 ][ i ] - sx * b.e1[ 2 ][ i ];
+		qz  = sx * b.e1[ 1 ][ i ] - sy * b.e1[ 0 ][ i ];
+		v   = ( d[ 0 ] * qx + d[ 1 ] * qy + d[ 2 ] * qz ) * inv;
+
+		t[ i ] = ( b.e2[ 0 ][ i ] * qx + b.e2[ 1 ][ i ] * qy + b.e2[ 2 ][ i ] * qz ) * inv;
+
+		if ( u >= 0.0f && v >= 0.0f && u + v <= 1.0f && t[ i ] >= 0.0f && t[ i ] <= tMax ) {
+			mask |= 1u << i;
+		}
+	}
+
+	return mask;
+}
+
+// Slab test, tNear is where the ray enters the box.
+static u32 boxesScalar( const boxBlock_t & b, const kernelRay_t & ray, f32 tMax, f32 * tNear ) {
+	u32 mask = 0;
+
+	for ( int i = 0; i < KERNEL_WIDTH; i++ ) {
+		f32 tmin = 0.0f;
+		f32 tmax = tMax;
+
+		for ( int a = 0; a < 3; a++ ) {
+			f32 t0 = ( b.min[ a ][ i ] - ray.origin[ a ] ) * ray.invDir[ a ];
+			f32 t1 = ( b.max[ a ][ i ] - ray.origin[ a ] ) * ray.invDir[ a ];
+
+			tmin = core::max_( tmin, core::min_( t0, t1 ) );
+			tmax = core::min_( tmax, core::max_( t0, t1 ) );
+		}
+
+		tNear[ i ] = tmin;
+
+		if ( tmin <= tmax ) {
+			mask |= 1u << i;
+		}
+	}
+
+	return mask;
+}
+
+#ifdef KERNELS_X86
+
+// Four lanes of trianglesScalar().
+__attribute__(( target( "sse2" ) ))
+static u32 trianglesSse4( const triBlock_t & b, int l, const kernelRay_t & ray, f32 tMax, f32 * t ) {
+	__m128 dx   = _mm_set1_ps( ray.dir[ 0 ] );
+	__m128 dy   = _mm_set1_ps( ray.dir[ 1 ] );
+	__m128 dz   = _mm_set1_ps( ray.dir[ 2 ] );
+	__m128 e1x  = _mm_loadu_ps( b.e1[ 0 ] + l );
+	__m128 e1y  = _mm_loadu_ps( b.e1[ 1 ] + l );
+	__m128 e1z  = _mm_loadu_ps( b.e1[ 2 ] + l );
+	__m128 e2x  = _mm_loadu_ps( b.e2[ 0 ] + l );
+	__m128 e2y  = _mm_loadu_ps( b.e2[ 1 ] + l );
+	__m128 e2z  = _mm_loadu_ps( b.e2[ 2 ] + l );
+	__m128 zero = _mm_setzero_ps();
+	__m128 one  = _mm_set1_ps( 1.0f );
+
+	__m128 px   = _mm_sub_ps( _mm_mul_ps( dy, e2z ), _mm_mul_ps( dz, e2y ) );
+	__m128 py   = _mm_sub_ps( _mm_mul_ps( dz, e2x ), _mm_mul_ps( dx, e2z ) );
+	__m128 pz   = _mm_sub_ps( _mm_mul_ps( dx, e2y ), _mm_mul_ps( dy, e2x ) );
+	__m128 det  = _mm_add_ps( _mm_add_ps( _mm_mul_ps( e1x, px ), _mm_mul_ps( e1y, py ) ), _mm_mul_ps( e1z, pz ) );
+	__m128 absd = _mm_andnot_ps( _mm_set1_ps( -0.0f ), det );
+	__m128 inv  = _mm_div_ps( one, det );
+
+	__m128 sx   = _mm_sub_ps( _mm_set1_ps( ray.origin[ 0 ] ), _mm_loadu_ps( b.v0[ 0 ] + l ) );
+	__m128 sy   = _mm_sub_ps( _mm_set1_ps( ray.origin[ 1 ] ), _mm_loadu_ps( b.v0[ 1 ] + l ) );
+	__m128 sz   = _mm_sub_ps( _mm_set1_ps( ray.origin[ 2 ] ), _mm_loadu_ps( b.v0[ 2 ] + l ) );
+	__m128 u    = _mm_mul_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( sx, px ), _mm_mul_ps( sy, py ) ), _mm_mul_ps( sz, pz ) ), inv );
+
+	__m128 qx   = _mm_sub_ps( _mm_mul_ps( sy, e1z ), _mm_mul_ps( sz, e1y ) );
+	__m128 qy   = _mm_sub_ps( _mm_mul_ps( sz, e1x ), _mm_mul_ps( sx, e1z ) );
+	__m128 qz   = _mm_sub_ps( _mm_mul_ps( sx, e1y ), _mm_mul_ps( sy, e1x ) );
+	__m128 v    = _mm_mul_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( dx, qx ), _mm_mul_ps( dy, qy ) ), _mm_mul_ps( dz, qz ) ), inv );
+	__m128 tt   = _mm_mul_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( e2x, qx ), _mm_mul_ps( e2y, qy ) ), _mm_mul_ps( e2z, qz ) ), inv );
+
+	__m128 hit  = _mm_cmpge_ps( absd, _mm_set1_ps( KERNEL_EPSILON ) );
+	hit = _mm_and_ps( hit, _mm_cmpge_ps( u, zero ) );
+	hit = _mm_and_ps( hit, _mm_cmpge_ps( v, zero ) );
+	hit = _mm_and_ps( hit, _mm_cmple_ps( _mm_add_ps( u, v ), one ) );
+	hit = _mm_and_ps( hit, _mm_cmpge_ps( tt, zero ) );
+	hit = _mm_and_ps( hit, _mm_cmple_ps( tt, _mm_set1_ps( tMax ) ) );
+
+	_mm_storeu_ps( t + l, tt );
+
+	return _mm_movemask_ps( hit );
+}
+
+__attribute__(( target( "sse2" ) ))
+static u32 trianglesSse( const triBlock_t & b, const kernelRay_t & ray, f32 tMax, f32 * t ) {
+	return trianglesSse4( b, 0, ray, tMax, t ) | ( trianglesSse4( b, 4, ray, tMax, t ) << 4 );
+}
+
+__attribute__(( target( "sse2" ) ))
+static u32 boxesSse4( const boxBlock_t & b, int l, const kernelRay_t & ray, f32 tMax, f32 * tNear ) {
+	__m128 tmin = _mm_setzero_ps();
+	__m128 tmax = _mm_set1_ps( tMax );
+
+	for ( int a = 0; a < 3; a++ ) {
+		__m128 o   = _mm_set1_ps( ray.origin[ a ] );
+		__m128 inv = _mm_set1_ps( ray.invDir[ a ] );
+		__m128 t0  = _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( b.min[ a ] + l ), o ), inv );
+		__m128 t1  = _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( b.max[ a ] + l ), o ), inv );
+
+		tmin = _mm_max_ps( tmin, _mm_min_ps( t0, t1 ) );
+		tmax = _mm_min_ps( tmax, _mm_max_ps( t0, t1 ) );
+	}
+
+	_mm_storeu_ps( tNear + l, tmin );
+
+	return _mm_movemask_ps( _mm_cmple_ps( tmin, tmax ) );
+}
+
+__attribute__(( target( "sse2" ) ))
+static u32 boxesSse( const boxBlock_t & b, const kernelRay_t & ray, f32 tMax, f32 * tNear ) {
+	return boxesSse4( b, 0, ray, tMax, tNear ) | ( boxesSse4( b, 4, ray, tMax, tNear ) << 4 );
+}
+
+// Eight lanes of trianglesScalar().
+__attribute__(( target( "avx2" ) ))
+static u32 trianglesAvx2( const triBlock_t & b, const kernelRay_t & ray, f32 tMax, f32 * t ) {
+	__m256 dx   = _mm256_set1_ps( ray.dir[ 0 ] );
+	__m256 dy   = _mm256_set1_ps( ray.dir[ 1 ] );
+	__m256 dz   = _mm256_set1_ps( ray.dir[ 2 ] );
+	__m256 e1x  = _mm256_loadu_ps( b.e1[ 0 ] );
+	__m256 e1y  = _mm256_loadu_ps( b.e1[ 1 ] );
+	__m256 e1z  = _mm256_loadu_ps( b.e1[ 2 ] );
+	__m256 e2x  = _mm256_loadu_ps( b.e2[ 0 ] );
+	__m256 e2y  = _mm256_loadu_ps( b.e2[ 1 ] );
+	__m256 e2z  = _mm256_loadu_ps( b.e2[ 2 ] );
+	__m256 zero = _mm256_setzero_ps();
+	__m256 one  = _mm256_set1_ps( 1.0f );
+
+	__m256 px   = _mm256_sub_ps( _mm256_mul_ps( dy, e2z ), _mm256_mul_ps( dz, e2y ) );
+	__m256 py   = _mm256_sub_ps( _mm256_mul_ps( dz, e2x ), _mm256_mul_ps( dx, e2z ) );
+	__m256 pz   = _mm256_sub_ps( _mm256_mul_ps( dx, e2y ), _mm256_mul_ps( dy, e2x ) );
+	__m256 det  = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( e1x, px ), _mm256_mul_ps( e1y, py ) ), _mm256_mul_ps( e1z, pz ) );
+	__m256 absd = _mm256_andnot_ps( _mm256_set1_ps( -0.0f ), det );
+	__m256 inv  = _mm256_div_ps( one, det );
+
+	__m256 sx   = _mm256_sub_ps( _mm256_set1_ps( ray.origin[ 0 ] ), _mm256_loadu_ps( b.v0[ 0 ] ) );
+	__m256 sy   = _mm256_sub_ps( _mm256_set1_ps( ray.origin[ 1 ] ), _mm256_loadu_ps( b.v0[ 1 ] ) );
+	__m256 sz   = _mm256_sub_ps( _mm256_set1_ps( ray.origin[ 2 ] ), _mm256_loadu_ps( b.v0[ 2 ] ) );
+	__m256 u    = _mm256_mul_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( sx, px ), _mm256_mul_ps( sy, py ) ), _mm256_mul_ps( sz, pz ) ), inv );
+
+	__m256 qx   = _mm256_sub_ps( _mm256_mul_ps( sy, e1z ), _mm256_mul_ps( sz, e1y ) );
+	__m256 qy   = _mm256_sub_ps( _mm256_mul_ps( sz, e1x ), _mm256_mul_ps( sx, e1z ) );
+	__m256 qz   = _mm256_sub_ps( _mm256_mul_ps( sx, e1y ), _mm256_mul_ps( sy, e1x ) );
+	__m256 v    = _mm256_mul_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( dx, qx ), _mm256_mul_ps( dy, qy ) ), _mm256_mul_ps( dz, qz ) ), inv );
+	__m256 tt   = _mm256_mul_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( e2x, qx ), _mm256_mul_ps( e2y, qy ) ), _mm256_mul_ps( e2z, qz ) ), inv );
+
+	__m256 hit  = _mm256_cmp_ps( absd, _mm256_set1_ps( KERNEL_EPSILON ), _CMP_GE_OQ );
+	hit = _mm256_and_ps( hit, _mm256_cmp_ps( u, zero, _CMP_GE_OQ ) );
+	hit = _mm256_and_ps( hit, _mm256_cmp_ps( v, zero, _CMP_GE_OQ ) );
+	hit = _mm256_and_ps( hit, _mm256_cmp_ps( _mm256_add_ps( u, v ), one, _CMP_LE_OQ ) );
+	hit = _mm256_and_ps( hit, _mm256_cmp_ps( tt, zero, _CMP_GE_OQ ) );
+	hit = _mm256_and_ps( hit, _mm256_cmp_ps( tt, _mm256_set1_ps( tMax ), _CMP_LE_OQ ) );
+
+	_mm256_storeu_ps( t, tt );
+
+	return _mm256_movemask_ps( hit );
+}
+
+__attribute__(( target( "avx2" ) ))
+static u32 boxesAvx2( const boxBlock_t & b, const kernelRay_t & ray, f32 tMax, f32 * tNear ) {
+	__m256 tmin = _mm256_setzero_ps();
+	__m256 tmax = _mm256_set1_ps( tMax );
+
+	for ( int a = 0; a < 3; a++ ) {
+		__m256 o   = _mm256_set1_ps( ray.origin[ a ] );
+		__m256 inv = _mm256_set1_ps( ray.invDir[ a ] );
+		__m256 t0  = _mm256_mul_ps( _mm256_sub_ps( _mm256_loadu_ps( b.min[ a ] ), o ), inv );
+		__m256 t1  = _mm256_mul_ps( _mm256_sub_ps( _mm256_loadu_ps( b.max[ a ] ), o ), inv );
+
+		tmin = _mm256_max_ps( tmin, _mm256_min_ps( t0, t1 ) );
+		tmax = _mm256_min_ps( tmax, _mm256_max_ps( t0, t1 ) );
+	}
+
+	_mm256_storeu_ps( tNear, tmin );
+
+	return _mm256_movemask_ps( _mm256_cmp_ps( tmin, tmax, _CMP_LE_OQ ) );
+}
+
+#endif // KERNELS_X86
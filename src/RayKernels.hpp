@@ -0,0 +1,106 @@
+/*------------------------------------------------------------------------------
+; File:          RayKernels.hpp
+; Description:   Declaration of the ray intersection kernels.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#ifndef RAYKERNELS_H
+#define RAYKERNELS_H
+
+#include <irrlicht.h>
+
+#include "definitions.hpp"
+
+using namespace irr;
+
+// Number of triangles or boxes tested at once.
+#define KERNEL_WIDTH 8
+
+// Eight triangles stored one component per array, lane i of every array
+// belongs to triangle i. Unused lanes are zero, callers must mask the
+// results with getLaneMask() since a zero box contains the origin.
+typedef struct TRI_BLOCK {
+	f32    v0[ 3 ][ KERNEL_WIDTH ];
+	f32    e1[ 3 ][ KERNEL_WIDTH ];
+	f32    e2[ 3 ][ KERNEL_WIDTH ];
+} triBlock_t;
+
+// Eight axis aligned boxes, laid out like triBlock_t.
+typedef struct BOX_BLOCK {
+	f32    min[ 3 ][ KERNEL_WIDTH ];
+	f32    max[ 3 ][ KERNEL_WIDTH ];
+} boxBlock_t;
+
+// The segment origin + t * dir, t in [0, 1].
+typedef struct KERNEL_RAY {
+	f32    origin[ 3 ];
+	f32    dir[ 3 ];
+	f32    invDir[ 3 ];
+} kernelRay_t;
+
+typedef enum KERNEL_PATH {
+	KERNEL_SCALAR = 0,
+	KERNEL_SSE,
+	KERNEL_AVX2,
+	KERNEL_PATHS
+} kernelPath_t;
+
+typedef u32 ( *triKernel_t )( const triBlock_t &, const kernelRay_t &, f32, f32 * );
+typedef u32 ( *boxKernel_t )( const boxBlock_t &, const kernelRay_t &, f32, f32 * );
+
+/*------------------------------------------------------------------------------
+; Ray against triangle and ray against box tests, eight at a time. There is a
+; scalar, an SSE and an AVX2 version of each. The scalar one runs until
+; main() picks the best one the CPU supports, before any thread is started,
+; so kernels only ever read the selection. The kernels return a bit mask
+; of the lanes hit before tMax and write the distances, as fractions of the
+; ray, to the given array of KERNEL_WIDTH floats.
+;-----------------------------------------------------------------------------*/
+class mdcRayKernels {
+	public:
+		// Path selection.
+		static bool                     isSupported( kernelPath_t );
+		static void                     setPath( kernelPath_t );
+		static kernelPath_t             getPath();
+		static const char         *     getPathName( kernelPath_t );
+		static kernelPath_t             getBestPath();
+
+		// Packing.
+		static void                     makeRay( kernelRay_t &, const core::line3d< f32 > & );
+		static void                     packTriangle( triBlock_t *, u32, const core::triangle3df & );
+		static void                     packBox( boxBlock_t *, u32, const core::aabbox3df & );
+		static u32                      getLaneMask( u32, u32, u32 );
+
+		// Kernels.
+		static u32                      intersectTriangles( const triBlock_t &, const kernelRay_t &, f32, f32 * );
+		static u32                      intersectBoxes( const boxBlock_t &, const kernelRay_t &, f32, f32 * );
+
+		// Prints the speed of every supported path against the given triangles.
+		static void                     benchmark( const triBlock_t *, u32, const core::vector3df & );
+
+	private:
+		static kernelPath_t             path;
+		static triKernel_t              triKernel;
+		static boxKernel_t              boxKernel;
+
+		mdcRayKernels() { };
+		mdcRayKernels( mdcRayKernels const & ) { };
+		mdcRayKernels & operator=( mdcRayKernels const & ) { return *this; }
+};
+
+#endif // RAYKERNELS_H
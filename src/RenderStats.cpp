@@ -0,0 +1,126 @@
+/*------------------------------------------------------------------------------
+; File:          RenderStats.cpp
+; Description:   Implementation of the render statistics class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#include "RenderStats.hpp"
+#include "InstancedMeshNode.hpp"
+
+mdcRenderStats::mdcRenderStats() {
+	stats.nodesDrawn      = 0;
+	stats.nodesCulled     = 0;
+	stats.instancesDrawn  = 0;
+	stats.instancesCulled = 0;
+	stats.primitives      = 0;
+	stats.materials       = 0;
+	stats.textures        = 0;
+	stats.textureMemory   = 0;
+}
+
+/*------------------------------------------------------------------------------
+; mdcRenderStats::collect()
+;
+; Counts the frame that was just drawn. Must be called after endScene() and
+; before the camera moves again. The nodes hidden by the visibility pass are
+; given by the caller and counted as culled, the walk cannot tell them from
+; nodes that are never shown.
+;-----------------------------------------------------------------------------*/
+void mdcRenderStats::collect( scene::ISceneManager * smgr, video::IVideoDriver * driver, u32 hidden ) {
+	stats.nodesDrawn      = 0;
+	stats.nodesCulled     = hidden;
+	stats.instancesDrawn  = 0;
+	stats.instancesCulled = 0;
+	stats.materials       = 0;
+	stats.textures        = 0;
+	stats.primitives      = driver->getPrimitiveCountDrawn( 0 );
+
+	bound.set_used( 0 );
+	walk( smgr, smgr->getRootSceneNode() );
+
+	bound.sort();
+	for ( u32 i = 0; i < bound.size(); i++ ) {
+		if ( i == 0 || bound[ i ] != bound[ i - 1 ] ) {
+			stats.textures++;
+		}
+	}
+
+	stats.textureMemory = getTextureMemory( driver );
+}
+
+const renderStats_t & mdcRenderStats::getStats() const {
+	return stats;
+}
+
+// Invisible nodes hide their children, culled ones do not.
+void mdcRenderStats::walk( scene::ISceneManager * smgr, scene::ISceneNode * node ) {
+	core::list< scene::ISceneNode * >::ConstIterator it;
+	mdcInstancedMeshNode                          *  group;
+	u32                                              n;
+
+	if ( !node->isVisible() ) {
+		return;
+	}
+
+	n = node->getMaterialCount();
+	if ( node->getType() == ESNT_INSTANCED_MESH ) {
+		group = static_cast< mdcInstancedMeshNode * >( node );
+
+		stats.instancesDrawn  += group->getDrawnCount();
+		stats.instancesCulled += group->getInstanceCount() - group->getDrawnCount();
+	}
+
+	if ( n > 0 && node->getType() != scene::ESNT_CAMERA ) {
+		if ( smgr->isCulled( node ) ) {
+			stats.nodesCulled++;
+		} else {
+			stats.nodesDrawn++;
+			stats.materials += n;
+
+			for ( u32 i = 0; i < n; i++ ) {
+				if ( node->getMaterial( i ).getTexture( 0 ) != NULL ) {
+					bound.push_back( node->getMaterial( i ).getTexture( 0 ) );
+				}
+			}
+		}
+	}
+
+	for ( it = node->getChildren().begin(); it != node->getChildren().end(); ++it ) {
+		walk( smgr, *it );
+	}
+}
+
+u32 mdcRenderStats::getTextureMemory( video::IVideoDriver * driver ) const {
+	video::ITexture * texture;
+	u32               bytes;
+	u32               total = 0;
+
+	for ( u32 i = 0; i < driver->getTextureCount(); i++ ) {
+		texture = driver->getTextureByIndex( i );
+		bytes   = texture->getPitch() * texture->getSize().Height;
+
+		// A full mip chain adds a third.
+		if ( texture->hasMipMaps() ) {
+			bytes += bytes / 3;
+		}
+
+		total += bytes / 1024;
+	}
+
+	return total;
+}
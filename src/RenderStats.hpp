@@ -0,0 +1,70 @@
+/*------------------------------------------------------------------------------
+; File:          RenderStats.hpp
+; Description:   Declaration of the render statistics class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#ifndef RENDERSTATS_H
+#define RENDERSTATS_H
+
+#include <irrlicht.h>
+
+#include "definitions.hpp"
+
+using namespace irr;
+
+// What one frame drew.
+typedef struct RENDER_STATS {
+	u32                         nodesDrawn;
+	u32                         nodesCulled;
+	u32                         instancesDrawn;
+	u32                         instancesCulled;
+	u32                         primitives;
+	u32                         materials;
+	u32                         textures;
+	u32                         textureMemory;
+} renderStats_t;
+
+/*------------------------------------------------------------------------------
+; Gathers per frame render counters. The node counts come from walking the
+; scene graph with the scene manager's own culling test, as the engine does
+; not report them, plus the nodes the visibility pass hid. Exhibit instances
+; are counted apart, from what their groups drew. Every material of a drawn node is one setMaterial() call,
+; so the material count is an upper bound on the state changes, and the
+; texture count is the number of distinct textures those materials bind.
+; Texture memory is in KiB and includes the mip levels.
+;-----------------------------------------------------------------------------*/
+class mdcRenderStats {
+	public:
+		mdcRenderStats();
+
+		void                                collect( scene::ISceneManager *, video::IVideoDriver *, u32 );
+		const renderStats_t         &       getStats()                      const;
+
+	private:
+		renderStats_t                       stats;
+		core::array< video::ITexture * >    bound;
+
+		mdcRenderStats( mdcRenderStats const & ) { };
+		mdcRenderStats & operator=( mdcRenderStats const & ) { return *this; }
+
+		void                                walk( scene::ISceneManager *, scene::ISceneNode * );
+		u32                                 getTextureMemory( video::IVideoDriver * ) const;
+};
+
+#endif // RENDERSTATS_H
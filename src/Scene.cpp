@@ -20,9 +20,27 @@
 ; along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ;-----------------------------------------------------------------------------*/
 
+#include <iostream>
 #include <cassert>
 
 #include "Scene.hpp"
+#include "SceneBake.hpp"
+#include "SettingsMdl.hpp"
+#include "OctreeSelector.hpp"
+#include "CollisionBvh.hpp"
+#include "ExhibitPicker.hpp"
+#include "MeshBatcher.hpp"
+#include "InstanceShader.hpp"
+#include "InstancedMeshNode.hpp"
+#include "MeshSimplifier.hpp"
+#include "Pvs.hpp"
+#include "PortalCuller.hpp"
+#include "ProfiledAnimator.hpp"
+#include "TexturePack.hpp"
+#include "Trace.hpp"
+
+using std::cerr;
+using std::endl;
 
 #define FAR_UNITS             50000.0f
 #define CAMERA_ROTATE_SPEED   100.0f
@@ -30,7 +48,304 @@
 #define TRIANGLE_LIMIT        1024
 #define MIN_POLYGONS          128
 
-mdcScene::mdcScene( IrrlichtDevice * device ) {
+static const char * SCENE_ARCHIVE = "mdc.zip";
+static const char * BAKE_FILENAME = "mdc.bake";
+static const char * PVS_FILENAME  = "mdc.pvs";
+static const char * TEX_FILENAME  = "mdc.tex";
+
+static video::ITexture * loadTexture( video::IVideoDriver *, const io::path & );
+
+/*------------------------------------------------------------------------------
+; mdcScene::mdcScene()
+;
+; Reads the scene description. The baked scene is used if allowed and not
+; older than the scene archive, scene.xml otherwise.
+;-----------------------------------------------------------------------------*/
+mdcScene::mdcScene( IrrlichtDevice * device, bool useBake ) {
+	TRACE_SCOPE( "mdcScene::mdcScene" );
+
+	smgr     = device->getSceneManager();
+	driver   = device->getVideoDriver();
+	baked    = NULL;
+	pvs      = NULL;
+	pvsCell  = -1;
+	visStale = false;
+	visHidden = 0;
+	portals  = NULL;
+
+	// Collision trees are cached next to the settings.
+	mdcSettingsMdl * settings = mdcSettingsMdl::getInstance();
+	cacheDir = settings->getCacheDirectory().c_str();
+	keepMeshData = settings->isMeshDataKept();
+	mdcSettingsMdl::freeInstance();
+
+	camera       = NULL;
+	animator     = NULL;
+	collider     = NULL;
+	world        = NULL;
+	picker       = new mdcExhibitPicker();
+	batcher      = new mdcMeshBatcher();
+
+	// Without the shader exhibits are still grouped, just drawn one by one.
+	instanceShader = new mdcInstanceShader();
+	if ( !instanceShader->create( driver ) ) {
+		instanceShader->drop();
+		instanceShader = NULL;
+	}
+	nextModel    = 0;
+
+	// Load the scene file into the virtual filesystem.
+	device->getFileSystem()->addFileArchive( SCENE_ARCHIVE );
+
+	// Packed textures come with their mip maps and are uploaded first, so the
+	// model loaders find them by name instead of decoding the images.
+	if ( useBake && mdcMappedFile::isNewer( TEX_FILENAME, SCENE_ARCHIVE ) ) {
+		mdcTexturePack pack;
+
+		if ( pack.open( TEX_FILENAME ) ) {
+			TRACE_SCOPE( "uploadTextures" );
+			pack.upload( driver );
+		}
+	}
+
+	// Disable mipmap generation for the rest until finishLoading().
+	driver->setTextureCreationFlag( video::ETCF_CREATE_MIP_MAPS, false );
+
+	// Create the metaSelector used for collision detection.
+	metaSelector = smgr->createMetaTriangleSelector();
+
+	if ( useBake && mdcMappedFile::isNewer( BAKE_FILENAME, SCENE_ARCHIVE ) ) {
+		baked = new mdcSceneBake();
+		if ( !baked->open( BAKE_FILENAME ) ) {
+			delete baked;
+			baked = NULL;
+		}
+	}
+
+	if ( baked != NULL ) {
+		readBakedScene();
+	} else {
+		readSceneFile( device );
+	}
+
+	// Rooms need no bake, so they win over the visible set.
+	readRooms( device );
+
+	if ( portals == NULL && useBake && mdcMappedFile::isNewer( PVS_FILENAME, SCENE_ARCHIVE ) ) {
+		pvs = new mdcPvs();
+		if ( !pvs->load( PVS_FILENAME ) ) {
+			delete pvs;
+			pvs = NULL;
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------
+; mdcScene::~mdcScene()
+;
+; The baked meshes point into the bake, so it is only released here. The
+; scene must be deleted after the device drops its mesh cache.
+;-----------------------------------------------------------------------------*/
+mdcScene::~mdcScene(){
+	metaSelector->drop();
+	if ( collider != NULL )
+		collider->drop();
+	if ( world != NULL )
+		world->drop();
+	delete picker;
+	delete batcher;
+	if ( instanceShader != NULL )
+		instanceShader->drop();
+	delete baked;
+	delete pvs;
+	delete portals;
+}
+
+/*------------------------------------------------------------------------------
+; mdcScene::bake()
+;
+; Compiles scene.xml and every model it references into the baked scene file,
+; then computes the potentially visible set of the building if scene.xml has
+; no rooms. Runs without a window on the null driver.
+;-----------------------------------------------------------------------------*/
+bool mdcScene::bake() {
+	IrrlichtDevice * device;
+	mdcScene       * scene;
+	bool             ok;
+
+	device = createDevice( video::EDT_NULL );
+	if ( device == NULL ) {
+		cerr << "mdcScene::bake() - Could not create the null device." << endl;
+		return false;
+	}
+
+	scene = new mdcScene( device, false );
+	ok    = scene->writeBakedScene( BAKE_FILENAME );
+	ok    = scene->writeTexturePack( TEX_FILENAME ) && ok;
+	// Rooms and portals are used in place of the set, see the constructor.
+	if ( scene->portals == NULL ) {
+		ok = scene->writePvs( PVS_FILENAME ) && ok;
+	}
+	delete scene;
+
+	device->drop();
+
+	return ok;
+}
+
+/*------------------------------------------------------------------------------
+; mdcScene::benchmarkKernels()
+;
+; Loads the museum building on the null driver and times every supported
+; ray kernel path against its collision triangles, casting from the camera
+; start point.
+;-----------------------------------------------------------------------------*/
+bool mdcScene::benchmarkKernels() {
+	IrrlichtDevice * device;
+	mdcScene       * scene;
+
+	device = createDevice( video::EDT_NULL );
+	if ( device == NULL ) {
+		cerr << "mdcScene::benchmarkKernels() - Could not create the null device." << endl;
+		return false;
+	}
+
+	scene = new mdcScene( device );
+	while ( scene->loadNextModel() );
+	scene->finishLoading();
+	scene->buildCollisionWorld();
+
+	mdcRayKernels::benchmark( scene->world->getTriangleBlocks(), scene->world->getTriangleBlockCount(), scene->camStart );
+
+	// Baked meshes point into the scene, see the destructor.
+	device->drop();
+	delete scene;
+
+	return true;
+}
+
+bool mdcScene::isBaked() const {
+	return baked != NULL;
+}
+
+void mdcScene::readBakedScene() {
+	sceneModel_t model;
+
+	for ( u32 i = 0; i < baked->getModelCount(); i++ ) {
+		baked->getModel( i, model );
+		models.push_back( model );
+	}
+
+	topTex    = baked->getSkyTexture( SKY_TOP );
+	bottomTex = baked->getSkyTexture( SKY_BOTTOM );
+	leftTex   = baked->getSkyTexture( SKY_LEFT );
+	rightTex  = baked->getSkyTexture( SKY_RIGHT );
+	frontTex  = baked->getSkyTexture( SKY_FRONT );
+	backTex   = baked->getSkyTexture( SKY_BACK );
+
+	camStart  = baked->getCameraStart();
+	camLookAt = baked->getCameraLookAt();
+}
+
+bool mdcScene::writeBakedScene( const char * path ) {
+	core::array< scene::IMesh * >    meshes;
+	scene::IAnimatedMesh         *   mesh;
+	io::path                         sky[ SKY_SIDES ];
+
+	for ( u32 i = 0; i < models.size(); i++ ) {
+		mesh = smgr->getMesh( models[ i ].name );
+		if ( mesh == NULL ) {
+			cerr << "mdcScene::writeBakedScene() - Could not load " << models[ i ].name.c_str() << endl;
+		}
+		meshes.push_back( mesh != NULL ? mesh->getMesh( 0 ) : NULL );
+	}
+
+	sky[ SKY_TOP ]    = topTex;
+	sky[ SKY_BOTTOM ] = bottomTex;
+	sky[ SKY_LEFT ]   = leftTex;
+	sky[ SKY_RIGHT ]  = rightTex;
+	sky[ SKY_FRONT ]  = frontTex;
+	sky[ SKY_BACK ]   = backTex;
+
+	return mdcSceneBake::write( path, models, meshes, sky, camStart, camLookAt );
+}
+
+/*------------------------------------------------------------------------------
+; mdcScene::writeTexturePack()
+;
+; Packs every texture the loaded models use and the skybox textures. Must be
+; called after writeBakedScene(), which loads the models.
+;-----------------------------------------------------------------------------*/
+bool mdcScene::writeTexturePack( const char * path ) {
+	core::array< io::path >    names;
+	io::path                   sky[ SKY_SIDES ];
+
+	for ( u32 i = 0; i < driver->getTextureCount(); i++ ) {
+		names.push_back( driver->getTextureByIndex( i )->getName().getPath() );
+	}
+
+	sky[ SKY_TOP ]    = topTex;
+	sky[ SKY_BOTTOM ] = bottomTex;
+	sky[ SKY_LEFT ]   = leftTex;
+	sky[ SKY_RIGHT ]  = rightTex;
+	sky[ SKY_FRONT ]  = frontTex;
+	sky[ SKY_BACK ]   = backTex;
+
+	for ( int s = 0; s < SKY_SIDES; s++ ) {
+		if ( !sky[ s ].empty() && names.linear_search( sky[ s ] ) < 0 ) {
+			names.push_back( sky[ s ] );
+		}
+	}
+
+	return mdcTexturePack::write( path, driver, names );
+}
+
+/*------------------------------------------------------------------------------
+; mdcScene::writePvs()
+;
+; Loads every model, builds the collision world from the solid ones and
+; computes the potentially visible set over the box of the visible ones.
+;-----------------------------------------------------------------------------*/
+bool mdcScene::writePvs( const char * path ) {
+	scene::IAnimatedMesh *   mesh;
+	core::aabbox3df          bounds;
+	bool                     empty = true;
+	mdcPvs                   set;
+
+	while ( loadNextModel() );
+	buildCollisionWorld();
+
+	for ( u32 i = 0; i < models.size(); i++ ) {
+		mesh = models[ i ].visible ? smgr->getMeshCache()->getMeshByName( models[ i ].name ) : NULL;
+		if ( mesh == NULL ) {
+			continue;
+		}
+
+		if ( empty ) {
+			bounds = mesh->getBoundingBox();
+			empty  = false;
+		} else {
+			bounds.addInternalBox( mesh->getBoundingBox() );
+		}
+	}
+
+	if ( empty ) {
+		cerr << "mdcScene::writePvs() - The scene has no visible models." << endl;
+		return false;
+	}
+
+	set.compute( world, bounds );
+
+	return set.save( path );
+}
+
+/*------------------------------------------------------------------------------
+; mdcScene::readSceneFile()
+;
+; Reads the model list, the skybox textures and the camera vectors from
+; scene.xml. Nothing is loaded here.
+;-----------------------------------------------------------------------------*/
+void mdcScene::readSceneFile( IrrlichtDevice * device ) {
 	// Section names
 	const stringw sceneTag         ( L"scene" );
 	const stringw skyTag           ( L"skybox" );
@@ -48,64 +363,19 @@ mdcScene::mdcScene( IrrlichtDevice * device ) {
 	const stringw left             ( L"left" );
 	const stringw right            ( L"right" );
 	// Camera data
-	const stringw camStart         ( L"start" );
+	const stringw camStartName     ( L"start" );
 	const stringw lookAt           ( L"look_at" );
 
-	// Scene model and collision data.
-	SKeyMap                                   keyMap[4];
-	core::list< scene::ISceneNodeAnimator * > camAnimators;
-	scene::IAnimatedMesh *                    mesh;
-	scene::ISceneNode *                       node;
-	scene::ITriangleSelector *                mapSelector;
+	sceneModel_t model;
 
-	// Camera positions.
-	float sx, sy, sz, lx, ly, lz;
-
-	// Possible scene object flags.
-	bool solid;
-	bool alpha;
-	bool visible;
+	TRACE_SCOPE( "mdcScene::readSceneFile" );
 
 	// XML reading helper strings.
 	stringw currentSection;
 	stringw key;
-	stringw topTex;
-	stringw bottomTex;
-	stringw frontTex;
-	stringw backTex;
-	stringw leftTex;
-	stringw rightTex;
-
-	// Pointers to the relevant irrLicht managers.
-	video::IVideoDriver *     driver = device->getVideoDriver();
-	io::IXMLReader      *     xml    = device->getFileSystem()->createXMLReader("scene.xml");
-	smgr = device->getSceneManager();
-
-	// Setup the keyboard controls.
-	keyMap[0].Action = EKA_MOVE_FORWARD;
-	keyMap[0].KeyCode = KEY_KEY_W;
-
-	keyMap[1].Action = EKA_MOVE_BACKWARD;
-	keyMap[1].KeyCode = KEY_KEY_S;
-
-	keyMap[2].Action = EKA_STRAFE_LEFT;
-	keyMap[2].KeyCode = KEY_KEY_A;
-
-	keyMap[3].Action = EKA_STRAFE_RIGHT;
-	keyMap[3].KeyCode = KEY_KEY_D;
-
-
-	// Load the scene file into the virtual filesystem.
-	device->getFileSystem()->addFileArchive( "mdc.zip" );
 
 	// Get the XML reader.
-	xml = device->getFileSystem()->createXMLReader( "scene.xml" );
-
-	// Disable mipmap generation.
-	driver->setTextureCreationFlag( video::ETCF_CREATE_MIP_MAPS, false );
-
-	// Create the metaSelector used for collision detection.
-	metaSelector = smgr->createMetaTriangleSelector();
+	io::IXMLReader * xml = device->getFileSystem()->createXMLReader( "scene.xml" );
 
 	// Read the scene file.
 	while( xml->read() ) {
@@ -125,54 +395,23 @@ mdcScene::mdcScene( IrrlichtDevice * device ) {
 					}
 
 				} else if ( currentSection.equals_ignore_case( sceneTag ) && modelTag.equals_ignore_case( xml->getNodeName() ) ) {
-					// If we are in the scene section the load the corresponding model and
-					// add it to the scene manager.
+					// If we are in the scene section then queue the model for loading.
 
 					key = xml->getAttributeValueSafe( L"name" );
 
 					if ( !key.empty() ) {
-
 						// Read the model attributes.
-						solid   = sTrue.equals_ignore_case( xml->getAttributeValueSafe( L"solid" ) );
-						visible = sTrue.equals_ignore_case( xml->getAttributeValueSafe( L"visible" ) );
-						alpha   = sTrue.equals_ignore_case( xml->getAttributeValueSafe( L"alpha" ) );
-
-						// Read the mesh and add it to the scene graph.
-						mesh = smgr->getMesh( key );
-						node = smgr->addOctreeSceneNode( mesh->getMesh( 0 ), NULL, -1, TRIANGLE_LIMIT );
-
-						if( node != NULL ){
-							// All models ignore lighting and normalize normals for future shader use.
-							node->setMaterialFlag( video::EMF_LIGHTING, false );
-							node->setMaterialFlag( video::EMF_NORMALIZE_NORMALS, true );
-
-							// If the model uses a texture with alpha channel the load it
-							if ( alpha ){
-								node->setMaterialType( video::EMT_TRANSPARENT_ALPHA_CHANNEL );
-								node->setMaterialFlag( video::EMF_BACK_FACE_CULLING, false );
-							}else{
-								// Else ignore the alpha channel.
-								node->setMaterialType( video::EMT_SOLID );
-								node->setMaterialFlag( video::EMF_BACK_FACE_CULLING, true );
-							}
-
-							// Just set the visibility.
-							if ( !visible )
-								node->setVisible(false);
-
-							// If the model is solid then add it to the collision selectors.
-							if ( solid ) {
-								mapSelector = smgr->createOctreeTriangleSelector( mesh->getMesh(0), node, MIN_POLYGONS );
-								metaSelector->addTriangleSelector( mapSelector );
-								mapSelector->drop();
-							}
-						}
+						model.name    = key;
+						model.solid   = sTrue.equals_ignore_case( xml->getAttributeValueSafe( L"solid" ) );
+						model.visible = sTrue.equals_ignore_case( xml->getAttributeValueSafe( L"visible" ) );
+						model.alpha   = sTrue.equals_ignore_case( xml->getAttributeValueSafe( L"alpha" ) );
 
+						models.push_back( model );
 					}
 
 				} else if ( currentSection.equals_ignore_case( skyTag ) && sideTag.equals_ignore_case( xml->getNodeName() ) ) {
 
-					// If we are in the skybox section then load all skybox textures.
+					// If we are in the skybox section then read all skybox textures.
 					key = xml->getAttributeValueSafe( L"name" );
 
 					if ( !key.empty() ) {
@@ -200,23 +439,23 @@ mdcScene::mdcScene( IrrlichtDevice * device ) {
 					key = xml->getAttributeValueSafe( L"name" );
 
 					if ( !key.empty() ) {
-						if ( key.equals_ignore_case( camStart ) ) {
+						if ( key.equals_ignore_case( camStartName ) ) {
 							core::stringc x = xml->getAttributeValueSafe( L"x" );
 							core::stringc y = xml->getAttributeValueSafe( L"y" );
 							core::stringc z = xml->getAttributeValueSafe( L"z" );
 
-							sx = core::fast_atof( x.c_str() );
-							sy = core::fast_atof( y.c_str() );
-							sz = core::fast_atof( z.c_str() );
+							camStart.X = core::fast_atof( x.c_str() );
+							camStart.Y = core::fast_atof( y.c_str() );
+							camStart.Z = core::fast_atof( z.c_str() );
 
 						} else if ( key.equals_ignore_case( lookAt ) ){
 							core::stringc x = xml->getAttributeValueSafe( L"x" );
 							core::stringc y = xml->getAttributeValueSafe( L"y" );
 							core::stringc z = xml->getAttributeValueSafe( L"z" );
 
-							lx = core::fast_atof( x.c_str() );
-							ly = core::fast_atof( y.c_str() );
-							lz = core::fast_atof( z.c_str() );
+							camLookAt.X = core::fast_atof( x.c_str() );
+							camLookAt.Y = core::fast_atof( y.c_str() );
+							camLookAt.Z = core::fast_atof( z.c_str() );
 						}
 					}
 				}
@@ -233,18 +472,286 @@ mdcScene::mdcScene( IrrlichtDevice * device ) {
 		}
 	}
 
+	xml->drop();
+}
+
+/*------------------------------------------------------------------------------
+; mdcScene::readRooms()
+;
+; Reads the rooms and portals section of scene.xml. It is not part of the
+; baked scene, so layouts can change without baking again. Leaves portals
+; NULL if there are no rooms.
+;-----------------------------------------------------------------------------*/
+void mdcScene::readRooms( IrrlichtDevice * device ) {
+	const stringw roomsTag         ( L"rooms" );
+	const stringw roomTag          ( L"room" );
+	const stringw portalTag        ( L"portal" );
+
+	core::aabbox3df box;
+	bool            inRooms = false;
+
+	io::IXMLReader * xml = device->getFileSystem()->createXMLReader( "scene.xml" );
+	if ( xml == NULL ) {
+		return;
+	}
+
+	portals = new mdcPortalCuller();
+
+	while( xml->read() ) {
+		switch( xml->getNodeType() ) {
+			case irr::io::EXN_ELEMENT:
+				if ( roomsTag.equals_ignore_case( xml->getNodeName() ) ) {
+					inRooms = true;
+					break;
+				}
+
+				if ( !inRooms ) {
+					break;
+				}
+
+				box.MinEdge.X = xml->getAttributeValueAsFloat( L"x0" );
+				box.MinEdge.Y = xml->getAttributeValueAsFloat( L"y0" );
+				box.MinEdge.Z = xml->getAttributeValueAsFloat( L"z0" );
+				box.MaxEdge.X = xml->getAttributeValueAsFloat( L"x1" );
+				box.MaxEdge.Y = xml->getAttributeValueAsFloat( L"y1" );
+				box.MaxEdge.Z = xml->getAttributeValueAsFloat( L"z1" );
+				box.repair();
+
+				if ( roomTag.equals_ignore_case( xml->getNodeName() ) ) {
+					portals->addRoom( xml->getAttributeValueSafe( L"name" ), box );
+
+				} else if ( portalTag.equals_ignore_case( xml->getNodeName() ) ) {
+					if ( !portals->addPortal( xml->getAttributeValueSafe( L"from" ), xml->getAttributeValueSafe( L"to" ), box ) ) {
+						cerr << "mdcScene::readRooms() - Ignoring a portal between unknown rooms." << endl;
+					}
+				}
+				break;
+
+			case irr::io::EXN_ELEMENT_END:
+				if ( roomsTag.equals_ignore_case( xml->getNodeName() ) ) {
+					inRooms = false;
+				}
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	xml->drop();
+
+	if ( portals->getRoomCount() == 0 ) {
+		delete portals;
+		portals = NULL;
+	}
+}
+
+/*------------------------------------------------------------------------------
+; mdcScene::loadNextModel()
+;
+; Loads the next model listed in scene.xml. Returns false once every model has
+; been loaded.
+;-----------------------------------------------------------------------------*/
+bool mdcScene::loadNextModel() {
+	scene::SMesh         * mesh;
+	scene::SAnimatedMesh * animated;
+
+	if ( nextModel >= models.size() ) {
+		return false;
+	}
+
+	if ( baked != NULL && !smgr->getMeshCache()->isMeshLoaded( models[ nextModel ].name ) ) {
+		TRACE_SCOPE_ARG( "mdcSceneBake::createMesh", models[ nextModel ].name.c_str() );
+
+		// Put the baked mesh in the cache so getMesh() finds it.
+		mesh     = baked->createMesh( nextModel, driver );
+		animated = new scene::SAnimatedMesh( mesh );
+		animated->recalculateBoundingBox();
+		smgr->getMeshCache()->addMesh( models[ nextModel ].name, animated );
+		animated->drop();
+		mesh->drop();
+	}
+
+	loadModel( models[ nextModel++ ] );
+
+	return true;
+}
+
+u32 mdcScene::getModelCount() const {
+	return models.size();
+}
+
+u32 mdcScene::getLoadedModelCount() const {
+	return nextModel;
+}
+
+const io::path & mdcScene::getModelName( u32 i ) const {
+	return models[ i ].name;
+}
+
+void mdcScene::loadModel( const sceneModel_t & model ) {
+	scene::IAnimatedMesh *                    mesh;
+	scene::ISceneNode *                       node;
+	scene::ITriangleSelector *                mapSelector;
+
+	TRACE_SCOPE_ARG( "mdcScene::loadModel", model.name.c_str() );
+
+	// Read the mesh and add it to the scene graph.
+	{
+		TRACE_SCOPE_ARG( "getMesh", model.name.c_str() );
+		mesh = smgr->getMesh( model.name );
+	}
+	if ( mesh == NULL ) {
+		return;
+	}
+
+	// Opaque room geometry is drawn by the chunk nodes of the batcher.
+	if ( model.visible && !model.alpha && batchModel( mesh->getMesh( 0 ) ) ) {
+		batchedMeshes.push_back( mesh );
+
+		if ( model.solid ) {
+			mapSelector = mdcOctreeSelector::create( mesh->getMesh( 0 ), NULL, MIN_POLYGONS, cacheDir.c_str() );
+			metaSelector->addTriangleSelector( mapSelector );
+			mapSelector->drop();
+		}
+		return;
+	}
+
+	node = smgr->addOctreeSceneNode( mesh->getMesh( 0 ), NULL, -1, TRIANGLE_LIMIT );
+
+	if( node != NULL ){
+		// All models ignore lighting and normalize normals for future shader use.
+		node->setMaterialFlag( video::EMF_LIGHTING, false );
+		node->setMaterialFlag( video::EMF_NORMALIZE_NORMALS, true );
+
+		// If the model uses a texture with alpha channel the load it
+		if ( model.alpha ){
+			node->setMaterialType( video::EMT_TRANSPARENT_ALPHA_CHANNEL );
+			node->setMaterialFlag( video::EMF_BACK_FACE_CULLING, false );
+		}else{
+			// Else ignore the alpha channel.
+			node->setMaterialType( video::EMT_SOLID );
+			node->setMaterialFlag( video::EMF_BACK_FACE_CULLING, true );
+		}
+
+		// Just set the visibility.
+		if ( !model.visible )
+			node->setVisible(false);
+
+		useStaticBuffers( mesh->getMesh( 0 ), node );
+
+		// If the model is solid then add it to the collision selectors.
+		if ( model.solid ) {
+			mapSelector = mdcOctreeSelector::create( mesh->getMesh( 0 ), node, MIN_POLYGONS, cacheDir.c_str() );
+			metaSelector->addTriangleSelector( mapSelector );
+			mapSelector->drop();
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------
+; mdcScene::useStaticBuffers()
+;
+; Marks the buffers of a mesh that never changes as static, so the driver
+; keeps them in hardware buffers. Octree nodes only draw from hardware
+; buffers when told to through their attributes, which must be done after
+; the node is placed. They then draw whole buffers, as culling their octree
+; would upload new indices every frame.
+;-----------------------------------------------------------------------------*/
+void mdcScene::useStaticBuffers( scene::IMesh * mesh, scene::ISceneNode * node ) {
+	io::IAttributes * attributes;
+
+	mesh->setHardwareMappingHint( scene::EHM_STATIC );
+
+	if ( node == NULL || node->getType() != scene::ESNT_OCTREE ) {
+		return;
+	}
+
+	attributes = node->getSceneManager()->getFileSystem()->createEmptyAttributes();
+	node->serializeAttributes( attributes );
+	attributes->setAttribute( "UseVBO", true );
+	attributes->setAttribute( "UseVisibilityAndVBO", false );
+	node->deserializeAttributes( attributes );
+	attributes->drop();
+}
+
+/*------------------------------------------------------------------------------
+; mdcScene::batchModel()
+;
+; Queues an opaque model in the batcher with the material setup loadModel()
+; gives opaque nodes. Returns false, queueing nothing, if any of its buffers
+; can not be batched.
+;-----------------------------------------------------------------------------*/
+bool mdcScene::batchModel( const scene::IMesh * mesh ) {
+	video::SMaterial material;
+
+	for ( u32 i = 0; i < mesh->getMeshBufferCount(); i++ ) {
+		if ( !mdcMeshBatcher::canBatch( mesh->getMeshBuffer( i ) ) ) {
+			return false;
+		}
+	}
+
+	for ( u32 i = 0; i < mesh->getMeshBufferCount(); i++ ) {
+		material                  = mesh->getMeshBuffer( i )->getMaterial();
+		material.Lighting         = false;
+		material.NormalizeNormals = true;
+		material.MaterialType     = video::EMT_SOLID;
+		material.BackfaceCulling  = true;
+
+		batcher->addBuffer( mesh->getMeshBuffer( i ), material );
+	}
+
+	return true;
+}
+
+/*------------------------------------------------------------------------------
+; mdcScene::finishLoading()
+;
+; Builds the batched geometry and creates the skybox and the camera once
+; every model has been loaded.
+;-----------------------------------------------------------------------------*/
+void mdcScene::finishLoading() {
+	SKeyMap                                   keyMap[4];
+	core::list< scene::ISceneNodeAnimator * > camAnimators;
+
+	// Setup the keyboard controls.
+	keyMap[0].Action = EKA_MOVE_FORWARD;
+	keyMap[0].KeyCode = KEY_KEY_W;
+
+	keyMap[1].Action = EKA_MOVE_BACKWARD;
+	keyMap[1].KeyCode = KEY_KEY_S;
+
+	keyMap[2].Action = EKA_STRAFE_LEFT;
+	keyMap[2].KeyCode = KEY_KEY_A;
+
+	keyMap[3].Action = EKA_STRAFE_RIGHT;
+	keyMap[3].KeyCode = KEY_KEY_D;
+
+	{
+		TRACE_SCOPE( "mdcMeshBatcher::build" );
+		batcher->build( smgr );
+	}
+
+	// The chunks and the collision selectors hold copies of the batched meshes.
+	if ( !keepMeshData ) {
+		for ( u32 i = 0; i < batchedMeshes.size(); i++ ) {
+			smgr->getMeshCache()->removeMesh( batchedMeshes[ i ] );
+		}
+	}
+	batchedMeshes.clear();
+
 	// Create the skybox.
-	smgr->addSkyBoxSceneNode( driver->getTexture( topTex ),
-							  driver->getTexture( bottomTex ),
-							  driver->getTexture( leftTex ),
-							  driver->getTexture( rightTex ),
-							  driver->getTexture( frontTex ),
-							  driver->getTexture( backTex ) );
+	smgr->addSkyBoxSceneNode( loadTexture( driver, topTex ),
+							  loadTexture( driver, bottomTex ),
+							  loadTexture( driver, leftTex ),
+							  loadTexture( driver, rightTex ),
+							  loadTexture( driver, frontTex ),
+							  loadTexture( driver, backTex ) );
 
 	// Create the camera.
 	camera = smgr->addCameraSceneNodeFPS( NULL, CAMERA_ROTATE_SPEED, MOVEMENT_SPEED, -1, keyMap, 4 );
-	camera->setPosition( core::vector3df( sx, sy, sz ) );
-	camera->setTarget( core::vector3df( lx, ly, lz ) );
+	camera->setPosition( camStart );
+	camera->setTarget( camLookAt );
 	camera->setFarValue( FAR_UNITS );
 
 	// Get the camera animator to disable vertical movement.
@@ -265,24 +772,184 @@ mdcScene::mdcScene( IrrlichtDevice * device ) {
 													  core::vector3df( 0, -20.f, 0 ),
 													  core::vector3df( 0, 60, 0 ),
 													  0.05f );
-	camera->addAnimator( collider );
 
-
-	xml->drop();
+	// Collision runs inside drawAll(), the wrapper times it on its own.
+	scene::ISceneNodeAnimator * profiled = new mdcProfiledAnimator( collider, ZONE_COLLISION );
+	camera->addAnimator( profiled );
+	profiled->drop();
 
 	// Reenable mipmap creation.
 	driver->setTextureCreationFlag( video::ETCF_CREATE_MIP_MAPS, true );
 }
 
-mdcScene::~mdcScene(){
-	metaSelector->drop();
-	collider->drop();
+/*------------------------------------------------------------------------------
+; mdcScene::buildCollisionWorld()
+;
+; Merges every collision selector into one BVH and makes it the camera's
+; collision world in place of the meta selector, then builds the exhibit
+; picking index. The BVH keeps its own copy of the triangles, so the
+; selectors are taken out of the meta selector, which frees the room ones.
+; Exhibit selectors live on in their nodes for picking. Meshes added for
+; collision detection afterwards only count once this is called again, they
+; are then added to the same BVH. Only the room geometry hides exhibits.
+;-----------------------------------------------------------------------------*/
+void mdcScene::buildCollisionWorld() {
+	const scene::ITriangleSelector * selector;
+	scene::ISceneNode              * node;
+
+	TRACE_SCOPE( "mdcScene::buildCollisionWorld" );
+
+	if ( world == NULL )
+		world = new mdcCollisionBvh();
+
+	for ( u32 i = 0; i < metaSelector->getSelectorCount(); i++ ) {
+		selector = metaSelector->getSelector( i );
+		node     = selector->getSceneNodeForTriangle( 0 );
+
+		world->addSelector( selector, node == NULL || node->getID() <= 0 );
+	}
+	world->build();
+
+	metaSelector->removeAllTriangleSelectors();
+
+	picker->build();
+
+	if ( collider != NULL )
+		collider->setWorld( world );
+
+	buildVisibility();
+}
+
+/*------------------------------------------------------------------------------
+; mdcScene::buildVisibility()
+;
+; Finds the rooms or cells of every visible mesh node under the root and of
+; every exhibit instance. Items hidden by the last update are shown again
+; first, so this can run more than once.
+;-----------------------------------------------------------------------------*/
+void mdcScene::buildVisibility() {
+	core::map< scene::IMesh *, mdcInstancedMeshNode * >::Iterator   group;
+	core::list< scene::ISceneNode * >::ConstIterator                child;
+	scene::ESCENE_NODE_TYPE                                         type;
+
+	if ( pvs == NULL && portals == NULL ) {
+		return;
+	}
+
+	for ( u32 i = 0; i < visItems.size(); i++ ) {
+		if ( visItems[ i ].group != NULL ) {
+			visItems[ i ].group->setInstanceVisible( visItems[ i ].instance, true );
+		} else {
+			visItems[ i ].node->setVisible( true );
+		}
+	}
+
+	visItems.clear();
+	visCells.clear();
+	visStale  = true;
+	visHidden = 0;
+
+	// Batched chunks are mesh nodes, the models left out of the batch octrees.
+	child = smgr->getRootSceneNode()->getChildren().begin();
+	for ( ; child != smgr->getRootSceneNode()->getChildren().end(); child++ ) {
+		type = ( *child )->getType();
+		if ( ( *child )->isVisible() && ( type == scene::ESNT_MESH || type == scene::ESNT_OCTREE ) ) {
+			addVisItem( *child, NULL, 0, ( *child )->getTransformedBoundingBox() );
+		}
+	}
+
+	for ( group = instanceGroups.getIterator(); !group.atEnd(); group++ ) {
+		for ( u32 i = 0; i < group->getValue()->getInstanceCount(); i++ ) {
+			addVisItem( NULL, group->getValue(), i, group->getValue()->getInstanceBox( i ) );
+		}
+	}
+}
+
+void mdcScene::addVisItem( scene::ISceneNode * node, mdcInstancedMeshNode * group, u32 instance,
+                           const core::aabbox3df & box ) {
+	visItem_t item;
+
+	item.node      = node;
+	item.group     = group;
+	item.instance  = instance;
+	item.firstCell = visCells.size();
+
+	if ( portals != NULL ) {
+		portals->getRooms( box, visCells );
+	} else {
+		pvs->getCells( box, visCells );
+	}
+
+	item.numCells  = visCells.size() - item.firstCell;
+
+	visItems.push_back( item );
+}
+
+/*------------------------------------------------------------------------------
+; mdcScene::updateVisibility()
+;
+; Shows what the camera can see and hides the rest. With rooms these are the
+; rooms seen through the portals, otherwise what the cell of the camera sees
+; in the baked set. Only does any work when that changes. Items in no room
+; or cell are always shown.
+;-----------------------------------------------------------------------------*/
+void mdcScene::updateVisibility( const scene::ICameraSceneNode * camera ) {
+	s32  cell = 0;
+	bool show;
+
+	if ( portals != NULL ) {
+		if ( !portals->update( *camera->getViewFrustum() ) && !visStale ) {
+			return;
+		}
+	} else if ( pvs != NULL ) {
+		cell = pvs->getCell( camera->getAbsolutePosition() );
+		if ( cell == pvsCell && !visStale ) {
+			return;
+		}
+		pvsCell = cell;
+	} else {
+		return;
+	}
+	visStale  = false;
+	visHidden = 0;
+
+	for ( u32 i = 0; i < visItems.size(); i++ ) {
+		show = cell < 0 || visItems[ i ].numCells == 0;
+
+		for ( u32 c = 0; c < visItems[ i ].numCells && !show; c++ ) {
+			if ( portals != NULL ) {
+				show = portals->isRoomVisible( visCells[ visItems[ i ].firstCell + c ] );
+			} else {
+				show = pvs->isVisible( cell, visCells[ visItems[ i ].firstCell + c ] );
+			}
+		}
+
+		if ( visItems[ i ].group != NULL ) {
+			visItems[ i ].group->setInstanceVisible( visItems[ i ].instance, show );
+		} else {
+			visItems[ i ].node->setVisible( show );
+
+			if ( !show ) {
+				visHidden++;
+			}
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------
+; mdcScene::getHiddenNodeCount()
+;
+; Nodes hidden by the last visibility update. Hidden instances are not
+; counted, their groups report what they drew.
+;-----------------------------------------------------------------------------*/
+u32 mdcScene::getHiddenNodeCount() const {
+	return visHidden;
 }
 
 void mdcScene::addMeshToCollisionDetection( scene::IAnimatedMesh * mesh, scene::ISceneNode * node ) const {
 	scene::ITriangleSelector * mapSelector;
 
-	mapSelector = smgr->createOctreeTriangleSelector( mesh->getMesh(0), node, MIN_POLYGONS );
+	mapSelector = mdcOctreeSelector::create( mesh->getMesh( 0 ), node, MIN_POLYGONS, cacheDir.c_str() );
 	metaSelector->addTriangleSelector( mapSelector );
 
 	node->setTriangleSelector( mapSelector );
@@ -290,6 +957,92 @@ void mdcScene::addMeshToCollisionDetection( scene::IAnimatedMesh * mesh, scene::
 	mapSelector->drop();
 }
 
+/*------------------------------------------------------------------------------
+; mdcScene::addExhibit()
+;
+; Adds an exhibit to the collision detection, the picking index and the
+; instanced group of its mesh, which draws it. The node only places the
+; exhibit and carries its database id, it should be hidden.
+;-----------------------------------------------------------------------------*/
+void mdcScene::addExhibit( scene::IAnimatedMesh * mesh, scene::ISceneNode * node ) {
+	core::aabbox3df box = mesh->getBoundingBox();
+
+	node->updateAbsolutePosition();
+	node->getAbsoluteTransformation().transformBoxEx( box );
+
+	addMeshToCollisionDetection( mesh, node );
+	picker->addExhibit( node->getID(), box, node->getTriangleSelector() );
+
+	getInstanceGroup( mesh->getMesh( 0 ) )->addInstance( node->getAbsoluteTransformation() );
+}
+
+/*------------------------------------------------------------------------------
+; mdcScene::getInstanceGroup()
+;
+; Returns the node that draws every exhibit using the given mesh, creating it
+; with the exhibit material setup and the detail levels of the mesh the first
+; time. Levels the decoder did not make are simplified here.
+;-----------------------------------------------------------------------------*/
+mdcInstancedMeshNode * mdcScene::getInstanceGroup( scene::IMesh * mesh ) {
+	core::map< scene::IMesh *, mdcInstancedMeshNode * >::Node * found = instanceGroups.find( mesh );
+	scene::IMeshCache                                          * cache = smgr->getMeshCache();
+	mdcInstancedMeshNode                                       * group;
+	scene::IAnimatedMesh                                       * cached;
+	scene::SAnimatedMesh                                       * animated;
+	scene::SMesh                                               * simplified;
+	scene::IMesh                                               * level = mesh;
+	io::path                                                     name;
+
+	if ( found != NULL ) {
+		return found->getValue();
+	}
+
+	group = new mdcInstancedMeshNode( mesh, instanceShader, smgr->getRootSceneNode(), smgr );
+
+	name = cache->getMeshName( mesh );
+	for ( u32 l = 1; l < LOD_LEVELS && !name.empty(); l++ ) {
+		cached = cache->getMeshByName( mdcMeshSimplifier::getLevelName( name, l ) );
+
+		if ( cached != NULL ) {
+			level = cached->getMesh( 0 );
+		} else if ( !mdcMeshSimplifier::canSimplify( level ) ) {
+			break;
+		} else {
+			TRACE_SCOPE_ARG( "simplify", name.c_str() );
+
+			simplified = mdcMeshSimplifier::createLevel( level, LOD_RATIO );
+			animated   = new scene::SAnimatedMesh( simplified );
+			animated->recalculateBoundingBox();
+			cache->addMesh( mdcMeshSimplifier::getLevelName( name, l ), animated );
+
+			level = simplified;
+			animated->drop();
+			simplified->drop();
+		}
+
+		group->addLevel( level );
+	}
+
+	group->setMaterialFlag( video::EMF_LIGHTING, false );
+	group->setMaterialFlag( video::EMF_NORMALIZE_NORMALS, true );
+	group->setMaterialType( video::EMT_SOLID );
+	group->drop();
+
+	instanceGroups.insert( mesh, group );
+
+	return group;
+}
+
+/*------------------------------------------------------------------------------
+; mdcScene::pickExhibit()
+;
+; Returns the id of the visible exhibit hit by the ray and the hit point, or
+; zero if there is none. Only valid after buildCollisionWorld().
+;-----------------------------------------------------------------------------*/
+s32 mdcScene::pickExhibit( const core::line3d< f32 > & ray, core::vector3df & hit ) {
+	return picker->pick( ray, world, hit );
+}
+
 scene::ICameraSceneNode * mdcScene::getCamera() {
 	return camera;
 }
@@ -311,3 +1064,9 @@ void mdcScene::changeCameraKeyMaps( SKeyMap forward, SKeyMap backward, SKeyMap s
 
 	animator->setKeyMap(keyMap, 4);
 }
+
+static video::ITexture * loadTexture( video::IVideoDriver * driver, const io::path & path ) {
+	TRACE_SCOPE_ARG( "getTexture", path.c_str() );
+
+	return driver->getTexture( path );
+}
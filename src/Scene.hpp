@@ -30,21 +30,112 @@
 using namespace irr;
 using core::stringw;
 
+// A model entry read from scene.xml.
+typedef struct SCENE_MODEL {
+	io::path    name;
+	bool        solid;
+	bool        alpha;
+	bool        visible;
+} sceneModel_t;
+
+// Something hidden by the visibility pass, a node or one instance of an
+// instanced group, and its range of cells in mdcScene::visCells. The cells
+// are rooms when scene.xml has them, cells of the baked set otherwise.
+typedef struct VIS_ITEM {
+	scene::ISceneNode       *    node;
+	mdcInstancedMeshNode    *    group;
+	u32                          instance;
+	u32                          firstCell;
+	u32                          numCells;
+} visItem_t;
+
+/*------------------------------------------------------------------------------
+; The museum building. The constructor only reads scene.xml, or the baked
+; scene when it is up to date, the models are loaded one at a time by
+; loadNextModel() so the caller can keep the window responsive, and
+; finishLoading() creates the skybox and the camera. Opaque visible models
+; are not given nodes of their own but batched by material in
+; finishLoading(). The rooms and portals of scene.xml, or the baked
+; potentially visible set when there are none, hide the geometry the camera
+; cannot see.
+;-----------------------------------------------------------------------------*/
 class mdcScene {
 	public:
-		mdcScene( IrrlichtDevice * );
+		mdcScene( IrrlichtDevice *, bool = true );
 		~mdcScene();
 
+		// Baking.
+		static bool bake();
+		static bool benchmarkKernels();
+
+		static void useStaticBuffers( scene::IMesh *, scene::ISceneNode * );
+		bool isBaked()                                                                 const;
+
+		// Incremental loading.
+		bool loadNextModel();
+		void finishLoading();
+		void buildCollisionWorld();
+		u32  getModelCount()                                                           const;
+		u32  getLoadedModelCount()                                                     const;
+		const io::path & getModelName( u32 )                                           const;
+
 		void changeCameraKeyMaps( SKeyMap, SKeyMap, SKeyMap, SKeyMap )                 const;
 		void addMeshToCollisionDetection( scene::IAnimatedMesh *, scene::ISceneNode *) const;
+		void addExhibit( scene::IAnimatedMesh *, scene::ISceneNode * );
+		s32  pickExhibit( const core::line3d< f32 > &, core::vector3df & );
 		scene::ICameraSceneNode * getCamera();
 
+		// Visibility.
+		void updateVisibility( const scene::ICameraSceneNode * );
+		u32  getHiddenNodeCount()                                                      const;
+
 	private:
 		scene::ICameraSceneNode                    *     camera;
 		scene::ISceneNodeAnimatorCameraFPS         *     animator;
 		scene::IMetaTriangleSelector               *     metaSelector;
 		scene::ISceneNodeAnimatorCollisionResponse *     collider;
+		mdcCollisionBvh                            *     world;
+		mdcExhibitPicker                           *     picker;
+		mdcMeshBatcher                             *     batcher;
+		mdcInstanceShader                          *     instanceShader;
+		core::map< scene::IMesh *, mdcInstancedMeshNode * > instanceGroups;
 		scene::ISceneManager                       *     smgr;
+		video::IVideoDriver                        *     driver;
+		mdcSceneBake                               *     baked;
+		mdcPvs                                     *     pvs;
+		mdcPortalCuller                            *     portals;
+		s32                                              pvsCell;
+		bool                                             visStale;
+		u32                                              visHidden;
+		core::array< visItem_t >                         visItems;
+		core::array< u32 >                               visCells;
+		core::stringc                                    cacheDir;
+		bool                                             keepMeshData;
+
+		// Data read from scene.xml.
+		core::array< sceneModel_t >                      models;
+		u32                                              nextModel;
+		core::array< scene::IAnimatedMesh * >            batchedMeshes;
+		io::path                                         topTex;
+		io::path                                         bottomTex;
+		io::path                                         frontTex;
+		io::path                                         backTex;
+		io::path                                         leftTex;
+		io::path                                         rightTex;
+		core::vector3df                                  camStart;
+		core::vector3df                                  camLookAt;
+
+		void readSceneFile( IrrlichtDevice * );
+		void readBakedScene();
+		void readRooms( IrrlichtDevice * );
+		bool writeBakedScene( const char * );
+		bool writeTexturePack( const char * );
+		bool writePvs( const char * );
+		void buildVisibility();
+		void addVisItem( scene::ISceneNode *, mdcInstancedMeshNode *, u32, const core::aabbox3df & );
+		void loadModel( const sceneModel_t & );
+		bool batchModel( const scene::IMesh * );
+		mdcInstancedMeshNode * getInstanceGroup( scene::IMesh * );
 };
 
 #endif // SCENE_H
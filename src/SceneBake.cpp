@@ -0,0 +1,352 @@
+/*------------------------------------------------------------------------------
+; File:          SceneBake.cpp
+; Description:   Implementation of the baked scene file class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+
+#include "SceneBake.hpp"
+#include "Trace.hpp"
+
+using std::cerr;
+using std::endl;
+
+static u32  addString( core::array< char > &, const char * );
+static bool fits( size_t, u32, u32, size_t );
+
+mdcSceneBake::mdcSceneBake() {
+	header   = NULL;
+	models   = NULL;
+	buffers  = NULL;
+	vertices = NULL;
+	indices  = NULL;
+	strings  = NULL;
+}
+
+mdcSceneBake::~mdcSceneBake() { }
+
+/*------------------------------------------------------------------------------
+; mdcSceneBake::open()
+;
+; Maps the baked file and checks that every offset and range in it is sane.
+; Returns false if the file is missing, from another version or damaged.
+;-----------------------------------------------------------------------------*/
+bool mdcSceneBake::open( const char * path ) {
+	char * data;
+
+	if ( !file.open( path ) ) {
+		return false;
+	}
+
+	data   = file.getData();
+	header = ( const bakeHeader_t * )data;
+
+	if ( file.getSize() < sizeof( bakeHeader_t ) || header->magic != BAKE_MAGIC ) {
+		cerr << "mdcSceneBake::open() - " << path << " is not a baked scene." << endl;
+		file.close();
+		return false;
+	}
+
+	if ( header->version != BAKE_VERSION || header->vertexSize != sizeof( video::S3DVertex ) ) {
+		cerr << "mdcSceneBake::open() - " << path << " was baked by another version." << endl;
+		file.close();
+		return false;
+	}
+
+	if ( !fits( file.getSize(), header->modelsOffset, header->numModels, sizeof( bakeModel_t ) ) ||
+	     !fits( file.getSize(), header->buffersOffset, header->numBuffers, sizeof( bakeBuffer_t ) ) ||
+	     !fits( file.getSize(), header->verticesOffset, header->numVertices, sizeof( video::S3DVertex ) ) ||
+	     !fits( file.getSize(), header->indicesOffset, header->numIndices, sizeof( u16 ) ) ||
+	     !fits( file.getSize(), header->stringsOffset, header->stringsSize, 1 ) ) {
+		cerr << "mdcSceneBake::open() - " << path << " is truncated." << endl;
+		file.close();
+		return false;
+	}
+
+	models   = ( const bakeModel_t * )( data + header->modelsOffset );
+	buffers  = ( const bakeBuffer_t * )( data + header->buffersOffset );
+	vertices = ( video::S3DVertex * )( data + header->verticesOffset );
+	indices  = ( u16 * )( data + header->indicesOffset );
+	strings  = data + header->stringsOffset;
+
+	if ( !validate() ) {
+		cerr << "mdcSceneBake::open() - " << path << " is damaged." << endl;
+		file.close();
+		return false;
+	}
+
+	return true;
+}
+
+u32 mdcSceneBake::getModelCount() const {
+	return header->numModels;
+}
+
+void mdcSceneBake::getModel( u32 i, sceneModel_t & model ) const {
+	model.name    = strings + models[ i ].name;
+	model.solid   = ( models[ i ].flags & BAKE_SOLID ) != 0;
+	model.alpha   = ( models[ i ].flags & BAKE_ALPHA ) != 0;
+	model.visible = ( models[ i ].flags & BAKE_VISIBLE ) != 0;
+}
+
+const char * mdcSceneBake::getSkyTexture( skySide_t side ) const {
+	return header->sky[ side ] == BAKE_NO_STRING ? "" : strings + header->sky[ side ];
+}
+
+core::vector3df mdcSceneBake::getCameraStart() const {
+	return core::vector3df( header->camStart[ 0 ], header->camStart[ 1 ], header->camStart[ 2 ] );
+}
+
+core::vector3df mdcSceneBake::getCameraLookAt() const {
+	return core::vector3df( header->camLookAt[ 0 ], header->camLookAt[ 1 ], header->camLookAt[ 2 ] );
+}
+
+/*------------------------------------------------------------------------------
+; mdcSceneBake::createMesh()
+;
+; Builds the mesh of a model. The buffers point into the mapping, only the
+; textures are loaded here.
+;-----------------------------------------------------------------------------*/
+scene::SMesh * mdcSceneBake::createMesh( u32 i, video::IVideoDriver * driver ) const {
+	scene::SMesh        * mesh = new scene::SMesh();
+	scene::SMeshBuffer  * buffer;
+
+	for ( u32 b = 0; b < models[ i ].numBuffers; b++ ) {
+		const bakeBuffer_t & src = buffers[ models[ i ].firstBuffer + b ];
+
+		buffer = new scene::SMeshBuffer();
+		buffer->Vertices.set_pointer( vertices + src.firstVertex, src.numVertices, false, false );
+		buffer->Indices.set_pointer( indices + src.firstIndex, src.numIndices, false, false );
+
+		buffer->Material.MaterialType  = ( video::E_MATERIAL_TYPE )src.materialType;
+		buffer->Material.AmbientColor  = video::SColor( src.ambient );
+		buffer->Material.DiffuseColor  = video::SColor( src.diffuse );
+		buffer->Material.SpecularColor = video::SColor( src.specular );
+		buffer->Material.EmissiveColor = video::SColor( src.emissive );
+		buffer->Material.Shininess     = src.shininess;
+
+		if ( src.texture != BAKE_NO_STRING ) {
+			TRACE_SCOPE_ARG( "getTexture", strings + src.texture );
+			buffer->Material.setTexture( 0, driver->getTexture( strings + src.texture ) );
+		}
+
+		buffer->BoundingBox = core::aabbox3df( src.box[ 0 ], src.box[ 1 ], src.box[ 2 ],
+		                                       src.box[ 3 ], src.box[ 4 ], src.box[ 5 ] );
+
+		mesh->addMeshBuffer( buffer );
+		buffer->drop();
+	}
+
+	mesh->recalculateBoundingBox();
+
+	return mesh;
+}
+
+/*------------------------------------------------------------------------------
+; mdcSceneBake::write()
+;
+; Bakes the given models and meshes, one mesh per model, into a file. Mesh
+; buffers with 32 bit indices or other vertex types are left out.
+;-----------------------------------------------------------------------------*/
+bool mdcSceneBake::write( const char * path,
+                          const core::array< sceneModel_t > & sceneModels,
+                          const core::array< scene::IMesh * > & meshes,
+                          const io::path * sky,
+                          const core::vector3df & camStart,
+                          const core::vector3df & camLookAt ) {
+	bakeHeader_t                      head;
+	core::array< bakeModel_t >        outModels;
+	core::array< bakeBuffer_t >       outBuffers;
+	core::array< video::S3DVertex >   outVertices;
+	core::array< u16 >                outIndices;
+	core::array< char >               outStrings;
+	FILE                         *    fp;
+	bool                              ok;
+
+	for ( u32 i = 0; i < sceneModels.size(); i++ ) {
+		bakeModel_t model;
+
+		model.name        = addString( outStrings, sceneModels[ i ].name.c_str() );
+		model.flags       = ( sceneModels[ i ].solid ? BAKE_SOLID : 0 ) |
+		                    ( sceneModels[ i ].alpha ? BAKE_ALPHA : 0 ) |
+		                    ( sceneModels[ i ].visible ? BAKE_VISIBLE : 0 );
+		model.firstBuffer = outBuffers.size();
+
+		for ( u32 b = 0; meshes[ i ] != NULL && b < meshes[ i ]->getMeshBufferCount(); b++ ) {
+			const scene::IMeshBuffer * mb  = meshes[ i ]->getMeshBuffer( b );
+			const video::SMaterial   & mat = mb->getMaterial();
+			const core::aabbox3df    & box = mb->getBoundingBox();
+			bakeBuffer_t               buffer;
+
+			if ( mb->getVertexType() != video::EVT_STANDARD || mb->getIndexType() != video::EIT_16BIT ) {
+				cerr << "mdcSceneBake::write() - Skipping a buffer of " << sceneModels[ i ].name.c_str() << endl;
+				continue;
+			}
+
+			buffer.texture      = mat.getTexture( 0 ) == NULL ? BAKE_NO_STRING :
+			                      addString( outStrings, mat.getTexture( 0 )->getName().getPath().c_str() );
+			buffer.materialType = mat.MaterialType;
+			buffer.ambient      = mat.AmbientColor.color;
+			buffer.diffuse      = mat.DiffuseColor.color;
+			buffer.specular     = mat.SpecularColor.color;
+			buffer.emissive     = mat.EmissiveColor.color;
+			buffer.shininess    = mat.Shininess;
+			buffer.firstVertex  = outVertices.size();
+			buffer.numVertices  = mb->getVertexCount();
+			buffer.firstIndex   = outIndices.size();
+			buffer.numIndices   = mb->getIndexCount();
+			buffer.box[ 0 ]     = box.MinEdge.X;
+			buffer.box[ 1 ]     = box.MinEdge.Y;
+			buffer.box[ 2 ]     = box.MinEdge.Z;
+			buffer.box[ 3 ]     = box.MaxEdge.X;
+			buffer.box[ 4 ]     = box.MaxEdge.Y;
+			buffer.box[ 5 ]     = box.MaxEdge.Z;
+
+			const video::S3DVertex * v = ( const video::S3DVertex * )mb->getVertices();
+			for ( u32 k = 0; k < buffer.numVertices; k++ ) {
+				outVertices.push_back( v[ k ] );
+			}
+
+			const u16 * idx = mb->getIndices();
+			for ( u32 k = 0; k < buffer.numIndices; k++ ) {
+				outIndices.push_back( idx[ k ] );
+			}
+
+			outBuffers.push_back( buffer );
+		}
+
+		model.numBuffers = outBuffers.size() - model.firstBuffer;
+		outModels.push_back( model );
+	}
+
+	memset( &head, 0, sizeof( head ) );
+	head.magic          = BAKE_MAGIC;
+	head.version        = BAKE_VERSION;
+	head.vertexSize     = sizeof( video::S3DVertex );
+	head.numModels      = outModels.size();
+	head.numBuffers     = outBuffers.size();
+	head.numVertices    = outVertices.size();
+	head.numIndices     = outIndices.size();
+	head.stringsSize    = outStrings.size();
+
+	// Every record is a multiple of four bytes, the strings go last.
+	head.modelsOffset   = sizeof( bakeHeader_t );
+	head.buffersOffset  = head.modelsOffset + head.numModels * sizeof( bakeModel_t );
+	head.verticesOffset = head.buffersOffset + head.numBuffers * sizeof( bakeBuffer_t );
+	head.indicesOffset  = head.verticesOffset + head.numVertices * sizeof( video::S3DVertex );
+	head.stringsOffset  = head.indicesOffset + head.numIndices * sizeof( u16 );
+
+	for ( int s = 0; s < SKY_SIDES; s++ ) {
+		head.sky[ s ] = sky[ s ].empty() ? BAKE_NO_STRING : addString( outStrings, sky[ s ].c_str() );
+	}
+	head.stringsSize    = outStrings.size();
+
+	head.camStart[ 0 ]  = camStart.X;
+	head.camStart[ 1 ]  = camStart.Y;
+	head.camStart[ 2 ]  = camStart.Z;
+	head.camLookAt[ 0 ] = camLookAt.X;
+	head.camLookAt[ 1 ] = camLookAt.Y;
+	head.camLookAt[ 2 ] = camLookAt.Z;
+
+	fp = fopen( path, "wb" );
+	if ( fp == NULL ) {
+		cerr << "mdcSceneBake::write() - Could not create " << path << endl;
+		return false;
+	}
+
+	ok = fwrite( &head, sizeof( head ), 1, fp ) == 1;
+	ok = ok && fwrite( outModels.const_pointer(), sizeof( bakeModel_t ), outModels.size(), fp ) == outModels.size();
+	ok = ok && fwrite( outBuffers.const_pointer(), sizeof( bakeBuffer_t ), outBuffers.size(), fp ) == outBuffers.size();
+	ok = ok && fwrite( outVertices.const_pointer(), sizeof( video::S3DVertex ), outVertices.size(), fp ) == outVertices.size();
+	ok = ok && fwrite( outIndices.const_pointer(), sizeof( u16 ), outIndices.size(), fp ) == outIndices.size();
+	ok = ok && fwrite( outStrings.const_pointer(), 1, outStrings.size(), fp ) == outStrings.size();
+	ok = ( fclose( fp ) == 0 ) && ok;
+
+	if ( !ok ) {
+		cerr << "mdcSceneBake::write() - Could not write " << path << endl;
+		remove( path );
+	}
+
+	return ok;
+}
+
+bool mdcSceneBake::validate() const {
+	if ( header->stringsSize > 0 && strings[ header->stringsSize - 1 ] != '\0' ) {
+		return false;
+	}
+
+	for ( int s = 0; s < SKY_SIDES; s++ ) {
+		if ( !isString( header->sky[ s ], true ) ) return false;
+	}
+
+	for ( u32 i = 0; i < header->numModels; i++ ) {
+		if ( !isString( models[ i ].name, false ) ||
+		     models[ i ].firstBuffer > header->numBuffers ||
+		     models[ i ].numBuffers > header->numBuffers - models[ i ].firstBuffer ) {
+			return false;
+		}
+	}
+
+	for ( u32 i = 0; i < header->numBuffers; i++ ) {
+		if ( !isString( buffers[ i ].texture, true ) ||
+		     buffers[ i ].firstVertex > header->numVertices ||
+		     buffers[ i ].numVertices > header->numVertices - buffers[ i ].firstVertex ||
+		     buffers[ i ].firstIndex > header->numIndices ||
+		     buffers[ i ].numIndices > header->numIndices - buffers[ i ].firstIndex ) {
+			return false;
+		}
+
+		// The indices are drawn in place, so each must name a vertex of its buffer.
+		for ( u32 k = 0; k < buffers[ i ].numIndices; k++ ) {
+			if ( indices[ buffers[ i ].firstIndex + k ] >= buffers[ i ].numVertices ) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool mdcSceneBake::isString( u32 offset, bool optional ) const {
+	if ( offset == BAKE_NO_STRING ) {
+		return optional;
+	}
+	return offset < header->stringsSize;
+}
+
+static u32 addString( core::array< char > & pool, const char * str ) {
+	u32 offset = pool.size();
+
+	do {
+		pool.push_back( *str );
+	} while ( *str++ != '\0' );
+
+	return offset;
+}
+
+// True if count elements of the given size starting at offset are in the file.
+static bool fits( size_t fileSize, u32 offset, u32 count, size_t elemSize ) {
+	if ( offset > fileSize || ( offset % 4 != 0 && elemSize > 2 ) ) {
+		return false;
+	}
+	return count <= ( fileSize - offset ) / elemSize;
+}
@@ -0,0 +1,142 @@
+/*------------------------------------------------------------------------------
+; File:          SceneBake.hpp
+; Description:   Declaration of the baked scene file class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+
+#ifndef SCENEBAKE_H
+#define SCENEBAKE_H
+
+#include <irrlicht.h>
+
+#include "definitions.hpp"
+#include "Scene.hpp"
+#include "MappedFile.hpp"
+
+using namespace irr;
+
+// "MDCB" read as a little endian integer.
+#define BAKE_MAGIC      0x4243444D
+#define BAKE_VERSION    1
+#define BAKE_NO_STRING  0xFFFFFFFF
+
+// Model flags.
+#define BAKE_SOLID      0x1
+#define BAKE_ALPHA      0x2
+#define BAKE_VISIBLE    0x4
+
+// Skybox sides in the order addSkyBoxSceneNode() takes them.
+typedef enum SKY_SIDE {
+	SKY_TOP = 0,
+	SKY_BOTTOM,
+	SKY_LEFT,
+	SKY_RIGHT,
+	SKY_FRONT,
+	SKY_BACK,
+	SKY_SIDES
+} skySide_t;
+
+// File layout. Offsets are in bytes from the start of the file, strings are
+// offsets into the string pool. Vertices are stored as video::S3DVertex and
+// indices as u16, ready to be used in place.
+typedef struct BAKE_HEADER {
+	u32    magic;
+	u32    version;
+	u32    vertexSize;
+	u32    numModels;
+	u32    modelsOffset;
+	u32    numBuffers;
+	u32    buffersOffset;
+	u32    numVertices;
+	u32    verticesOffset;
+	u32    numIndices;
+	u32    indicesOffset;
+	u32    stringsSize;
+	u32    stringsOffset;
+	u32    sky[ SKY_SIDES ];
+	f32    camStart[ 3 ];
+	f32    camLookAt[ 3 ];
+} bakeHeader_t;
+
+typedef struct BAKE_MODEL {
+	u32    name;
+	u32    flags;
+	u32    firstBuffer;
+	u32    numBuffers;
+} bakeModel_t;
+
+typedef struct BAKE_BUFFER {
+	u32    texture;
+	u32    materialType;
+	u32    ambient;
+	u32    diffuse;
+	u32    specular;
+	u32    emissive;
+	f32    shininess;
+	u32    firstVertex;
+	u32    numVertices;
+	u32    firstIndex;
+	u32    numIndices;
+	f32    box[ 6 ];
+} bakeBuffer_t;
+
+/*------------------------------------------------------------------------------
+; scene.xml and every mesh it references compiled into a single file, which is
+; mapped whole instead of parsed. The mesh buffers created by createMesh() use
+; the mapping directly, so they must not be resized and the bake must outlive
+; them.
+;-----------------------------------------------------------------------------*/
+class mdcSceneBake {
+	public:
+		mdcSceneBake();
+		~mdcSceneBake();
+
+		bool                            open( const char * );
+
+		u32                             getModelCount()                         const;
+		void                            getModel( u32, sceneModel_t & )         const;
+		const char               *      getSkyTexture( skySide_t )              const;
+		core::vector3df                 getCameraStart()                        const;
+		core::vector3df                 getCameraLookAt()                       const;
+		scene::SMesh             *      createMesh( u32, video::IVideoDriver * ) const;
+
+		static bool                     write( const char *,
+		                                       const core::array< sceneModel_t > &,
+		                                       const core::array< scene::IMesh * > &,
+		                                       const io::path *,
+		                                       const core::vector3df &,
+		                                       const core::vector3df & );
+
+	private:
+		mdcMappedFile                   file;
+		const bakeHeader_t       *      header;
+		const bakeModel_t        *      models;
+		const bakeBuffer_t       *      buffers;
+		video::S3DVertex         *      vertices;
+		u16                      *      indices;
+		const char               *      strings;
+
+		mdcSceneBake( mdcSceneBake const & ) { };
+		mdcSceneBake & operator=( mdcSceneBake const & ) { return *this; }
+
+		bool                            validate()                              const;
+		bool                            isString( u32, bool )                   const;
+};
+
+#endif // SCENEBAKE_H
@@ -0,0 +1,327 @@
+/*------------------------------------------------------------------------------
+; File:          SceneLoader.cpp
+; Description:   Implementation of the incremental scene loader class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+
+#include <iostream>
+#include <cstdlib>
+
+#include "Scene.hpp"
+#include "ThreadPool.hpp"
+#include "MeshDecoder.hpp"
+#include "SceneLoader.hpp"
+#include "Trace.hpp"
+
+using std::cerr;
+using std::endl;
+
+#define SLICE_MS           30
+#define DECODE_WEIGHT      0.4f
+#define MODELS_WEIGHT      0.3f
+#define EXHIBITS_WEIGHT    0.3f
+
+static const char * DB_FILENAME = "exhibits/mdc.db";
+static const int    EXHIBIT_PAGE_SIZE = 256;
+
+/*------------------------------------------------------------------------------
+; mdcSceneLoader::mdcSceneLoader()
+;
+; Starts the database thread and the decoding pool. The scene models are
+; loaded by update().
+;-----------------------------------------------------------------------------*/
+mdcSceneLoader::mdcSceneLoader( IrrlichtDevice * device, mdcScene * scene ) {
+	this->device = device;
+	this->scene  = scene;
+	smgr         = device->getSceneManager();
+	exhibits     = mdcExhibitMdl::getInstance();
+	// Baked meshes need no decoding.
+	phase        = scene->isBaked() ? PHASE_MODELS : PHASE_DECODE;
+	pool         = new mdcThreadPool();
+	decoder      = new mdcMeshDecoder( device, pool );
+	nextRequest  = 0;
+
+	page.records = NULL;
+	page.count   = 0;
+	nextRecord   = 0;
+	placed       = 0;
+	knownTotal   = -1;
+
+	total        = -1;
+	workerDone   = false;
+	cancelled    = false;
+
+	device->getFileSystem()->addFileArchive( "exhibits/exhibits.zip" );
+
+	pthread_mutex_init( &lock, NULL );
+
+	workerStarted = pthread_create( &worker, NULL, workerMain, this ) == 0;
+	if ( !workerStarted ) {
+		// Read everything now, update() will still place it in slices.
+		cerr << "mdcSceneLoader::mdcSceneLoader() - Could not start the database thread." << endl;
+		readExhibits();
+	}
+}
+
+mdcSceneLoader::~mdcSceneLoader() {
+	if ( workerStarted ) {
+		pthread_mutex_lock( &lock );
+		cancelled = true;
+		pthread_mutex_unlock( &lock );
+
+		pthread_join( worker, NULL );
+	}
+
+	// The decoder waits for its running jobs, so it goes before the pool.
+	delete decoder;
+	delete pool;
+
+	free( page.records );
+	for ( u32 i = 0; i < queue.size(); i++ ) {
+		free( queue[ i ].records );
+	}
+
+	pthread_mutex_destroy( &lock );
+
+	mdcExhibitMdl::freeInstance();
+}
+
+/*------------------------------------------------------------------------------
+; mdcSceneLoader::update()
+;
+; Does about SLICE_MS milliseconds of loading work. Returns true once the
+; whole scene has been loaded.
+;-----------------------------------------------------------------------------*/
+bool mdcSceneLoader::update() {
+	ITimer * timer = device->getTimer();
+	u32      start = timer->getRealTime();
+
+	while ( phase != PHASE_DONE && timer->getRealTime() - start < SLICE_MS ) {
+		switch ( phase ) {
+			case PHASE_DECODE:
+				if ( nextRequest < scene->getModelCount() ) {
+					// Reading the file is all the main thread does here.
+					decoder->request( scene->getModelName( nextRequest++ ) );
+				} else if ( decoder->collect() == 0 ) {
+					phase = PHASE_MODELS;
+				} else {
+					// Every file is queued, wait for the pool.
+					return false;
+				}
+				break;
+
+			case PHASE_MODELS:
+				if ( !scene->loadNextModel() ) {
+					phase = PHASE_FINISH;
+				}
+				break;
+
+			case PHASE_FINISH:
+				scene->finishLoading();
+				phase = PHASE_EXHIBITS;
+				break;
+
+			case PHASE_EXHIBITS:
+				if ( nextRecord == page.count ) {
+					if ( !nextPage() ) {
+						if ( phase == PHASE_EXHIBITS ) {
+							// Nothing queued yet, try again next frame.
+							return false;
+						}
+						break;
+					}
+				}
+				if ( decoder->collect() > 0 ) {
+					// The meshes of this page are still being decoded.
+					return false;
+				}
+				placeExhibit( page.records[ nextRecord++ ] );
+				break;
+
+			case PHASE_WORLD:
+				// Every static triangle is in place now.
+				scene->buildCollisionWorld();
+				phase = PHASE_DONE;
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	return phase == PHASE_DONE;
+}
+
+f32 mdcSceneLoader::getProgress() const {
+	f32 done;
+	u32 count;
+
+	if ( phase == PHASE_DONE ) {
+		return 1.0f;
+	}
+
+	count = scene->getModelCount();
+
+	if ( phase == PHASE_DECODE ) {
+		done = count == 0 ? 1.0f : ( f32 )( nextRequest - decoder->getPendingCount() ) / count;
+		return DECODE_WEIGHT * done;
+	}
+
+	if ( phase == PHASE_MODELS ) {
+		done = count == 0 ? 1.0f : ( f32 )scene->getLoadedModelCount() / count;
+		return DECODE_WEIGHT + MODELS_WEIGHT * done;
+	}
+
+	if ( knownTotal <= 0 ) {
+		return DECODE_WEIGHT + MODELS_WEIGHT;
+	}
+
+	return DECODE_WEIGHT + MODELS_WEIGHT + EXHIBITS_WEIGHT * ( f32 )placed / knownTotal;
+}
+
+/*------------------------------------------------------------------------------
+; mdcSceneLoader::nextPage()
+;
+; Takes the next page of records from the queue. Returns false if the queue is
+; empty, moving to PHASE_WORLD when the database thread has nothing left.
+;-----------------------------------------------------------------------------*/
+bool mdcSceneLoader::nextPage() {
+	io::path path;
+	bool     got = false;
+
+	free( page.records );
+	page.records = NULL;
+	page.count   = 0;
+	nextRecord   = 0;
+
+	pthread_mutex_lock( &lock );
+
+	knownTotal = total;
+
+	if ( queue.size() > 0 ) {
+		page = queue[ 0 ];
+		queue.erase( 0 );
+		got = true;
+	} else if ( workerDone ) {
+		phase = PHASE_WORLD;
+	}
+
+	pthread_mutex_unlock( &lock );
+
+	// Start decoding every mesh of the page before placing any of them.
+	for ( int i = 0; i < page.count; i++ ) {
+		if ( page.records[ i ].modelPath != NULL ) {
+			path = "exhibits/";
+			path += page.records[ i ].modelPath;
+			decoder->request( path, true );
+		}
+	}
+
+	return got;
+}
+
+void mdcSceneLoader::placeExhibit( const exhibitRecord_t & rec ) {
+	core::stringc             path;
+	scene::IAnimatedMesh *    mesh;
+	scene::ISceneNode    *    node;
+
+	placed++;
+
+	if ( rec.modelPath == NULL ) {
+		return;
+	}
+
+	path = "exhibits/";
+	path += rec.modelPath;
+
+	{
+		TRACE_SCOPE_ARG( "getMesh", path.c_str() );
+		mesh = smgr->getMesh( path.c_str() );
+	}
+	if ( mesh == NULL ) {
+		cerr << "mdcSceneLoader::placeExhibit() - Could not load " << path.c_str() << endl;
+		return;
+	}
+
+	// The exhibit is drawn by the instanced group of its mesh, the node only
+	// places it for collisions and picking.
+	node = smgr->addEmptySceneNode( NULL, rec.id );
+	if ( node != NULL ) {
+		node->setVisible( false );
+		node->setRotation( core::vector3df( 0, rec.rotation.y * rec.rotationAmount, 0 ) );
+		node->setScale( core::vector3df( rec.scaling.x, rec.scaling.y, rec.scaling.z ) );
+		node->setPosition( core::vector3df( rec.translation.x, rec.translation.y, rec.translation.z ) );
+
+		scene->addExhibit( mesh, node );
+	}
+}
+
+void * mdcSceneLoader::workerMain( void * arg ) {
+	static_cast< mdcSceneLoader * >( arg )->readExhibits();
+	return NULL;
+}
+
+/*------------------------------------------------------------------------------
+; mdcSceneLoader::readExhibits()
+;
+; Runs on the database thread. Opens the database, preloads the catalog and
+; queues the exhibit records a page at a time. The main thread does not touch
+; the exhibit model until workerDone is set.
+;-----------------------------------------------------------------------------*/
+void mdcSceneLoader::readExhibits() {
+	exhibitPage_t      p;
+	exhibitCursor_t    cursor;
+	int                n = 0;
+
+	if ( !exhibits->setDatabaseFile( DB_FILENAME ) ) {
+		cerr << "The exhibits database could not be opened." << endl;
+	} else {
+		if ( !exhibits->preloadCatalog() ) {
+			// Not fatal, the exhibit getters fall back to querying the database.
+			cerr << "The exhibits catalog could not be preloaded." << endl;
+		}
+		n = exhibits->getNumOfExhibits();
+	}
+
+	pthread_mutex_lock( &lock );
+	total = n;
+	pthread_mutex_unlock( &lock );
+
+	exhibits->openExhibitCursor( cursor );
+
+	while ( !isCancelled() && ( p.count = exhibits->getNextExhibitRecords( cursor, &p.records, EXHIBIT_PAGE_SIZE ) ) > 0 ) {
+		pthread_mutex_lock( &lock );
+		queue.push_back( p );
+		pthread_mutex_unlock( &lock );
+	}
+
+	pthread_mutex_lock( &lock );
+	workerDone = true;
+	pthread_mutex_unlock( &lock );
+}
+
+bool mdcSceneLoader::isCancelled() {
+	bool c;
+
+	pthread_mutex_lock( &lock );
+	c = cancelled;
+	pthread_mutex_unlock( &lock );
+
+	return c;
+}
@@ -0,0 +1,100 @@
+/*------------------------------------------------------------------------------
+; File:          SceneLoader.hpp
+; Description:   Declaration of the incremental scene loader class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+
+#ifndef SCENELOADER_H
+#define SCENELOADER_H
+
+#include <pthread.h>
+#include <irrlicht.h>
+
+#include "definitions.hpp"
+#include "ExhibitMdl.hpp"
+
+using namespace irr;
+
+// A page of exhibit records produced by the database thread.
+typedef struct EXHIBIT_PAGE {
+	exhibitRecord_t *    records;
+	int                  count;
+} exhibitPage_t;
+
+typedef enum LOAD_PHASE {
+	PHASE_DECODE = 0,
+	PHASE_MODELS,
+	PHASE_FINISH,
+	PHASE_EXHIBITS,
+	PHASE_WORLD,
+	PHASE_DONE
+} loadPhase_t;
+
+/*------------------------------------------------------------------------------
+; Loads the scene a slice at a time so the render loop keeps running. The
+; exhibits database is read by a worker thread that hands pages of records to
+; the main thread, which creates the scene nodes in update(). Meshes are
+; decoded on a thread pool before their nodes are created.
+;-----------------------------------------------------------------------------*/
+class mdcSceneLoader {
+	public:
+		mdcSceneLoader( IrrlichtDevice *, mdcScene * );
+		~mdcSceneLoader();
+
+		bool                            update();
+		f32                             getProgress()           const;
+
+	private:
+		IrrlichtDevice           *      device;
+		scene::ISceneManager     *      smgr;
+		mdcScene                 *      scene;
+		mdcExhibitMdl            *      exhibits;
+		loadPhase_t                     phase;
+
+		// Mesh decoding.
+		mdcThreadPool            *      pool;
+		mdcMeshDecoder           *      decoder;
+		u32                             nextRequest;
+
+		// Page currently being placed by the main thread.
+		exhibitPage_t                   page;
+		int                             nextRecord;
+		int                             placed;
+		int                             knownTotal;
+
+		// Shared with the database thread, guarded by lock.
+		pthread_t                       worker;
+		bool                            workerStarted;
+		pthread_mutex_t                 lock;
+		core::array< exhibitPage_t >    queue;
+		int                             total;
+		bool                            workerDone;
+		bool                            cancelled;
+
+		mdcSceneLoader( mdcSceneLoader const & ) { };
+		mdcSceneLoader & operator=( mdcSceneLoader const & ) { return *this; }
+
+		static void              *      workerMain( void * );
+		void                            readExhibits();
+		bool                            isCancelled();
+		bool                            nextPage();
+		void                            placeExhibit( const exhibitRecord_t & );
+};
+
+#endif // SCENELOADER_H
@@ -24,6 +24,7 @@
 #include <cassert>
 #include <cstring>
 #include <cctype>
+#include <cerrno>
 #include <iostream>
 #include <fstream>
 #include <sys/types.h>
@@ -42,6 +43,8 @@ using std::cerr;
 using std::endl;
 using core::stringw;
 
+#define DEF_PICK_RATE 20
+
 static const string DEF_SETTINGS = "<?xml version=\"1.0\"?>\n"
 								   "<!-- DO NOT EDIT THIS FILE BY HAND -->\n"
                             	   "<mdcvis>\n"
@@ -51,6 +54,8 @@ static const string DEF_SETTINGS = "<?xml version=\"1.0\"?>\n"
                             	   "    <setting name=\"antialiasing\"  value=\"2\">\n"
                             	   "    <setting name=\"vsync\"         value=\"0\">\n"
                             	   "    <setting name=\"resolution\"    value=\"800x600\">\n"
+                            	   "    <setting name=\"pick_rate\"     value=\"20\">\n"
+                            	   "    <setting name=\"keep_mesh_data\" value=\"0\">\n"
                             	   "  </video>\n"
                             	   "  <controls>\n"
                             	   "    <key name = \"forward\"  value=\"w\">\n"
@@ -96,6 +101,8 @@ mdcSettingsMdl::mdcSettingsMdl(): refs( 0 ), changed(false) {
 	screenDimensions->Height = 600;
 	vSync = false;
 	driver = video::EDT_OPENGL;
+	pickRate = DEF_PICK_RATE;
+	keepMeshData = false;
 	forward.Action = EKA_MOVE_FORWARD;
 	backward.Action = EKA_MOVE_BACKWARD;
 	s_left.Action = EKA_STRAFE_LEFT;
@@ -157,6 +164,8 @@ mdcSettingsMdl::mdcSettingsMdl(): refs( 0 ), changed(false) {
 		}
 
 		loadSettingsFile();
+
+		createCacheDir();
 	}
 }
 
@@ -189,6 +198,8 @@ void mdcSettingsMdl::loadSettingsFile() {
     const stringw antialiasingName   ( L"antialiasing" );
     const stringw vSyncName          ( L"vsync" );
     const stringw resolutionName     ( L"resolution" );
+    const stringw pickRateName       ( L"pick_rate" );
+    const stringw keepMeshDataName   ( L"keep_mesh_data" );
 	// Controls tags
 	const stringw forwardName        ( L"forward" );
 	const stringw backwardName       ( L"backward" );
@@ -226,6 +237,8 @@ void mdcSettingsMdl::loadSettingsFile() {
 			screenDimensions->Height = 600;
 			vSync = false;
 			driver = video::EDT_OPENGL;
+			pickRate = DEF_PICK_RATE;
+			keepMeshData = false;
 			forward.Action = EKA_MOVE_FORWARD;
 			backward.Action = EKA_MOVE_BACKWARD;
 			s_left.Action = EKA_STRAFE_LEFT;
@@ -250,6 +263,8 @@ void mdcSettingsMdl::loadSettingsFile() {
 			screenDimensions->Height = 600;
 			vSync = false;
 			driver = video::EDT_OPENGL;
+			pickRate = DEF_PICK_RATE;
+			keepMeshData = false;
 			forward.Action = EKA_MOVE_FORWARD;
 			backward.Action = EKA_MOVE_BACKWARD;
 			s_left.Action = EKA_STRAFE_LEFT;
@@ -327,6 +342,12 @@ void mdcSettingsMdl::loadSettingsFile() {
         						}
 
         						screenDimensions->Height = core::strtol10( & ( s.c_str()[ i ] ) );
+
+							}else if ( key.equals_ignore_case( pickRateName ) ) {
+        						core::stringc s = xml->getAttributeValueSafe( L"value" );
+        						pickRate = core::strtoul10( s.c_str() );
+							}else if ( key.equals_ignore_case( keepMeshDataName ) ) {
+								keepMeshData = sTrue.equals_ignore_case( xml->getAttributeValueSafe( L"value" ) );
 							}
 						}
 
@@ -423,6 +444,8 @@ void mdcSettingsMdl::saveSettings() const {
 		ofs << "    <setting name=\"vsync\"         value=\"" << ( vSync ? 1 : 0 ) << "\">\n";
 		ofs << "    <setting name=\"resolution\"    value=\"" << screenDimensions->Width << "x"
 			<< screenDimensions->Height << "\">\n";
+		ofs << "    <setting name=\"pick_rate\"     value=\"" << pickRate << "\">\n";
+		ofs << "    <setting name=\"keep_mesh_data\" value=\"" << ( keepMeshData ? 1 : 0 ) << "\">\n";
 
 		ofs << "  </video>\n  <controls>\n";
 
@@ -468,6 +491,34 @@ bool mdcSettingsMdl::settingsDirExists() const {
 #endif
 }
 
+/*------------------------------------------------------------------------------
+; mdcSettingsMdl::createCacheDir()
+;
+; Creates the directory for files derived from the scene, like the collision
+; trees. The cache stays disabled, with an empty path, if it cannot be made.
+;-----------------------------------------------------------------------------*/
+void mdcSettingsMdl::createCacheDir() {
+	if ( !canUseSettings ) {
+		return;
+	}
+
+#if defined( _WIN32 ) || defined( __MINGW32__ )
+	cachePath = settingsPath + "cache\\";
+
+	if ( !CreateDirectoryA( cachePath.c_str(), NULL ) && GetLastError() != ERROR_ALREADY_EXISTS ) {
+		cachePath = "";
+	}
+#elif defined( __linux__ )
+	cachePath = settingsPath + "cache/";
+
+	if ( mkdir( cachePath.c_str(), 0755 ) != 0 && errno != EEXIST ) {
+		cachePath = "";
+	}
+#else
+#error "Not a GNU/Linux or Windows platform."
+#endif
+}
+
 bool mdcSettingsMdl::settingsFileExists() const {
 	string settingsFile = settingsPath + "settings.xml";
 	ifstream ifs( settingsFile.c_str() );
@@ -625,6 +676,28 @@ const SKeyMap * mdcSettingsMdl::getStrafeRightKey() const {
 	return &s_right;
 }
 
+/*------------------------------------------------------------------------------
+; mdcSettingsMdl::getPickRate()
+;
+; Maximum number of exhibit picks per second, zero means once per frame.
+;-----------------------------------------------------------------------------*/
+u32 mdcSettingsMdl::getPickRate() const {
+	return pickRate;
+}
+
+/*------------------------------------------------------------------------------
+; mdcSettingsMdl::isMeshDataKept()
+;
+; Whether meshes whose geometry was copied elsewhere stay in the mesh cache.
+;-----------------------------------------------------------------------------*/
+bool mdcSettingsMdl::isMeshDataKept() const {
+	return keepMeshData;
+}
+
+const string & mdcSettingsMdl::getCacheDirectory() const {
+	return cachePath;
+}
+
 
 /* Setters */
 void mdcSettingsMdl::setFullScreen( bool isFullScreen) {
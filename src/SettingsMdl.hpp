@@ -52,6 +52,9 @@ class mdcSettingsMdl{
 		const SKeyMap                *   getBackwardKey()        const;
 		const SKeyMap                *   getStrafeLeftKey()      const;
 		const SKeyMap                *   getStrafeRightKey()     const;
+		u32                              getPickRate()           const;
+		bool                             isMeshDataKept()        const;
+		const string                 &   getCacheDirectory()     const;
 
 		// Setters
 		void                             setFullScreen( bool );
@@ -70,6 +73,7 @@ class mdcSettingsMdl{
 		int                              refs;
 
 		string                           settingsPath;
+		string                           cachePath;
 		bool                             canUseSettings;
 		bool                             changed;
 
@@ -79,6 +83,8 @@ class mdcSettingsMdl{
 		unsigned int                     antialiasing;
 		video::E_DRIVER_TYPE             driver;
 		core::dimension2d<u32> *         screenDimensions;
+		u32                              pickRate;
+		bool                             keepMeshData;
 
 		// Key mappings
 		SKeyMap                          forward;
@@ -98,6 +104,7 @@ class mdcSettingsMdl{
 		void                             loadSettingsFile();
 		bool                             settingsDirExists()             const;
 		bool                             settingsFileExists()            const;
+		void                             createCacheDir();
 		void                             setKeyMapKey( char, SKeyMap & ) const;
 		char                             getKeyMapKey( const SKeyMap & )       const;
 };
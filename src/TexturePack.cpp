@@ -0,0 +1,351 @@
+/*------------------------------------------------------------------------------
+; File:          TexturePack.cpp
+; Description:   Implementation of the precomputed texture pack class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+
+#include "TexturePack.hpp"
+#include "Trace.hpp"
+
+using std::cerr;
+using std::endl;
+
+static u32                 addString( core::array< char > &, const char * );
+static u32                 getChainSize( video::ECOLOR_FORMAT, u32, u32 );
+static video::IImage *     halveImage( video::IVideoDriver *, video::IImage * );
+static void                appendLevel( core::array< u8 > &, video::IImage * );
+
+mdcTexturePack::mdcTexturePack() {
+	header   = NULL;
+	textures = NULL;
+	strings  = NULL;
+}
+
+mdcTexturePack::~mdcTexturePack() { }
+
+/*------------------------------------------------------------------------------
+; mdcTexturePack::open()
+;
+; Maps the pack and checks every texture in it. Returns false if the file is
+; missing, from another version or damaged.
+;-----------------------------------------------------------------------------*/
+bool mdcTexturePack::open( const char * path ) {
+	char * data;
+
+	if ( !file.open( path ) ) {
+		return false;
+	}
+
+	data   = file.getData();
+	header = ( const texPackHeader_t * )data;
+
+	if ( file.getSize() < sizeof( texPackHeader_t ) || header->magic != TEXPACK_MAGIC ) {
+		cerr << "mdcTexturePack::open() - " << path << " is not a texture pack." << endl;
+		file.close();
+		return false;
+	}
+
+	if ( header->version != TEXPACK_VERSION ) {
+		cerr << "mdcTexturePack::open() - " << path << " was written by another version." << endl;
+		file.close();
+		return false;
+	}
+
+	if ( header->texturesOffset % 4 != 0 || header->texturesOffset > file.getSize() ||
+	     header->numTextures > ( file.getSize() - header->texturesOffset ) / sizeof( texPackTexture_t ) ||
+	     header->stringsOffset > file.getSize() || header->stringsSize > file.getSize() - header->stringsOffset ) {
+		cerr << "mdcTexturePack::open() - " << path << " is truncated." << endl;
+		file.close();
+		return false;
+	}
+
+	textures = ( const texPackTexture_t * )( data + header->texturesOffset );
+	strings  = data + header->stringsOffset;
+
+	if ( !validate() ) {
+		cerr << "mdcTexturePack::open() - " << path << " is damaged." << endl;
+		file.close();
+		return false;
+	}
+
+	return true;
+}
+
+u32 mdcTexturePack::getTextureCount() const {
+	return file.isOpen() ? header->numTextures : 0;
+}
+
+/*------------------------------------------------------------------------------
+; mdcTexturePack::upload()
+;
+; Adds every texture the driver does not have yet, with its stored mip maps.
+; The creation flags are left as they are. When they ask for no mip maps or
+; for 16 bit textures, which the stored levels do not match, the driver makes
+; its own levels from the first one. Returns the number of textures added.
+;-----------------------------------------------------------------------------*/
+u32 mdcTexturePack::upload( video::IVideoDriver * driver ) const {
+	video::IImage   *   image;
+	u8              *   data;
+	u32                 levelSize;
+	u32                 count = 0;
+	bool                useLevels;
+
+	useLevels = driver->getTextureCreationFlag( video::ETCF_CREATE_MIP_MAPS ) &&
+	            !driver->getTextureCreationFlag( video::ETCF_ALWAYS_16_BIT ) &&
+	            !driver->getTextureCreationFlag( video::ETCF_OPTIMIZED_FOR_SPEED );
+
+	for ( u32 i = 0; i < getTextureCount(); i++ ) {
+		const texPackTexture_t & tex  = textures[ i ];
+		const char             * name = strings + tex.name;
+
+		if ( driver->findTexture( name ) != NULL ) {
+			continue;
+		}
+
+		TRACE_SCOPE_ARG( "uploadTexture", name );
+
+		data      = ( u8 * )file.getData() + tex.dataOffset;
+		levelSize = tex.width * tex.height * video::IImage::getBitsPerPixelFromFormat( ( video::ECOLOR_FORMAT )tex.format ) / 8;
+
+		image = driver->createImageFromData( ( video::ECOLOR_FORMAT )tex.format, core::dimension2du( tex.width, tex.height ), data );
+		if ( driver->addTexture( name, image, useLevels ? data + levelSize : NULL ) != NULL ) {
+			count++;
+		}
+		image->drop();
+	}
+
+	return count;
+}
+
+/*------------------------------------------------------------------------------
+; mdcTexturePack::write()
+;
+; Decodes the named images and writes them with their mip maps to a new pack.
+; Images that cannot be loaded are left out. Returns false if nothing could
+; be written.
+;-----------------------------------------------------------------------------*/
+bool mdcTexturePack::write( const char * path, video::IVideoDriver * driver, const core::array< io::path > & names ) {
+	texPackHeader_t                    head;
+	core::array< texPackTexture_t >    outTextures;
+	core::array< char >                outStrings;
+	core::array< u8 >                  outData;
+	video::IImage                  *   source;
+	video::IImage                  *   level;
+	video::IImage                  *   next;
+	core::dimension2du                 size;
+	u32                                dataStart;
+	FILE                           *   fp;
+	bool                               ok;
+
+	for ( u32 i = 0; i < names.size(); i++ ) {
+		texPackTexture_t tex;
+
+		source = driver->createImageFromFile( names[ i ] );
+		if ( source == NULL ) {
+			cerr << "mdcTexturePack::write() - Could not load " << names[ i ].c_str() << endl;
+			continue;
+		}
+
+		// The same rounding up the drivers do for textures that are not a
+		// power of two, so the stored levels are what they would upload.
+		size  = source->getDimension().getOptimalSize( true, false, true, TEXPACK_MAX_SIZE );
+		level = driver->createImage( video::ECF_A8R8G8B8, size );
+		source->copyToScaling( level );
+		source->drop();
+
+		tex.name       = addString( outStrings, names[ i ].c_str() );
+		tex.format     = video::ECF_A8R8G8B8;
+		tex.width      = size.Width;
+		tex.height     = size.Height;
+		tex.dataOffset = outData.size();
+
+		for ( ;; ) {
+			appendLevel( outData, level );
+
+			if ( level->getDimension().Width == 1 && level->getDimension().Height == 1 ) {
+				break;
+			}
+
+			next = halveImage( driver, level );
+			level->drop();
+			level = next;
+		}
+		level->drop();
+
+		tex.dataSize = outData.size() - tex.dataOffset;
+		while ( outData.size() % 4 != 0 ) {
+			outData.push_back( 0 );
+		}
+
+		outTextures.push_back( tex );
+	}
+
+	if ( outTextures.empty() ) {
+		cerr << "mdcTexturePack::write() - There are no textures to write." << endl;
+		return false;
+	}
+
+	memset( &head, 0, sizeof( head ) );
+	head.magic          = TEXPACK_MAGIC;
+	head.version        = TEXPACK_VERSION;
+	head.numTextures    = outTextures.size();
+	head.stringsSize    = outStrings.size();
+
+	// The pixels go last, starting on a four byte boundary.
+	head.texturesOffset = sizeof( texPackHeader_t );
+	head.stringsOffset  = head.texturesOffset + head.numTextures * sizeof( texPackTexture_t );
+	dataStart           = ( head.stringsOffset + head.stringsSize + 3 ) & ~3u;
+
+	for ( u32 i = 0; i < outTextures.size(); i++ ) {
+		outTextures[ i ].dataOffset += dataStart;
+	}
+
+	while ( ( head.stringsOffset + outStrings.size() ) % 4 != 0 ) {
+		outStrings.push_back( '\0' );
+	}
+
+	fp = fopen( path, "wb" );
+	if ( fp == NULL ) {
+		cerr << "mdcTexturePack::write() - Could not create " << path << endl;
+		return false;
+	}
+
+	ok = fwrite( &head, sizeof( head ), 1, fp ) == 1;
+	ok = ok && fwrite( outTextures.const_pointer(), sizeof( texPackTexture_t ), outTextures.size(), fp ) == outTextures.size();
+	ok = ok && fwrite( outStrings.const_pointer(), 1, outStrings.size(), fp ) == outStrings.size();
+	ok = ok && fwrite( outData.const_pointer(), 1, outData.size(), fp ) == outData.size();
+	ok = ( fclose( fp ) == 0 ) && ok;
+
+	if ( !ok ) {
+		cerr << "mdcTexturePack::write() - Could not write " << path << endl;
+		remove( path );
+	}
+
+	return ok;
+}
+
+bool mdcTexturePack::validate() const {
+	for ( u32 i = 0; i < header->numTextures; i++ ) {
+		const texPackTexture_t & tex = textures[ i ];
+
+		if ( tex.name >= header->stringsSize || memchr( strings + tex.name, '\0', header->stringsSize - tex.name ) == NULL ) {
+			return false;
+		}
+
+		if ( tex.format != video::ECF_A8R8G8B8 ) {
+			return false;
+		}
+
+		if ( tex.width == 0 || tex.width > TEXPACK_MAX_SIZE || ( tex.width & ( tex.width - 1 ) ) != 0 ||
+		     tex.height == 0 || tex.height > TEXPACK_MAX_SIZE || ( tex.height & ( tex.height - 1 ) ) != 0 ) {
+			return false;
+		}
+
+		if ( tex.dataSize != getChainSize( ( video::ECOLOR_FORMAT )tex.format, tex.width, tex.height ) ||
+		     tex.dataOffset % 4 != 0 || tex.dataOffset > file.getSize() || tex.dataSize > file.getSize() - tex.dataOffset ) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static u32 addString( core::array< char > & pool, const char * str ) {
+	u32 offset = pool.size();
+
+	do {
+		pool.push_back( *str );
+	} while ( *str++ != '\0' );
+
+	return offset;
+}
+
+// Bytes taken by every level of a texture down to 1x1.
+static u32 getChainSize( video::ECOLOR_FORMAT format, u32 width, u32 height ) {
+	u32 bytes = video::IImage::getBitsPerPixelFromFormat( format ) / 8;
+	u32 size  = 0;
+
+	for ( ;; ) {
+		size += width * height * bytes;
+
+		if ( width == 1 && height == 1 ) {
+			return size;
+		}
+
+		width  = core::max_( width / 2, 1u );
+		height = core::max_( height / 2, 1u );
+	}
+}
+
+// Next mip level of an A8R8G8B8 image, each pixel the average of four.
+static video::IImage * halveImage( video::IVideoDriver * driver, video::IImage * image ) {
+	core::dimension2du     size( core::max_( image->getDimension().Width / 2, 1u ),
+	                             core::max_( image->getDimension().Height / 2, 1u ) );
+	video::IImage      *   out    = driver->createImage( video::ECF_A8R8G8B8, size );
+	const u8           *   src    = ( const u8 * )image->lock();
+	u8                 *   dst    = ( u8 * )out->lock();
+	u32                    maxX   = image->getDimension().Width - 1;
+	u32                    maxY   = image->getDimension().Height - 1;
+	u32                    sum;
+
+	for ( u32 y = 0; y < size.Height; y++ ) {
+		const u32 * row0 = ( const u32 * )( src + core::min_( y * 2, maxY ) * image->getPitch() );
+		const u32 * row1 = ( const u32 * )( src + core::min_( y * 2 + 1, maxY ) * image->getPitch() );
+		u32       * to   = ( u32 * )( dst + y * out->getPitch() );
+
+		for ( u32 x = 0; x < size.Width; x++ ) {
+			u32 x0 = core::min_( x * 2, maxX );
+			u32 x1 = core::min_( x * 2 + 1, maxX );
+
+			to[ x ] = 0;
+			for ( u32 shift = 0; shift < 32; shift += 8 ) {
+				sum = ( ( row0[ x0 ] >> shift ) & 0xFF ) + ( ( row0[ x1 ] >> shift ) & 0xFF ) +
+				      ( ( row1[ x0 ] >> shift ) & 0xFF ) + ( ( row1[ x1 ] >> shift ) & 0xFF );
+				to[ x ] |= ( ( sum + 2 ) / 4 ) << shift;
+			}
+		}
+	}
+
+	out->unlock();
+	image->unlock();
+
+	return out;
+}
+
+// Appends the pixels of a level, rows packed.
+static void appendLevel( core::array< u8 > & data, video::IImage * image ) {
+	const u8   * src    = ( const u8 * )image->lock();
+	u32          width  = image->getDimension().Width;
+	u32          height = image->getDimension().Height;
+
+	for ( u32 y = 0; y < height; y++ ) {
+		const u32 * pixel = ( const u32 * )( src + y * image->getPitch() );
+
+		for ( u32 x = 0; x < width; x++ ) {
+			for ( u32 b = 0; b < 4; b++ ) {
+				data.push_back( ( u8 )( pixel[ x ] >> ( b * 8 ) ) );
+			}
+		}
+	}
+
+	image->unlock();
+}
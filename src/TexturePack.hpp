@@ -0,0 +1,90 @@
+/*------------------------------------------------------------------------------
+; File:          TexturePack.hpp
+; Description:   Declaration of the precomputed texture pack class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#ifndef TEXTUREPACK_H
+#define TEXTUREPACK_H
+
+#include <irrlicht.h>
+
+#include "definitions.hpp"
+#include "MappedFile.hpp"
+
+using namespace irr;
+
+// "MDCT" read as a little endian integer.
+#define TEXPACK_MAGIC      0x5443444D
+#define TEXPACK_VERSION    2
+
+// Largest side a texture is stored at, larger ones are scaled down.
+#define TEXPACK_MAX_SIZE   2048
+
+// File layout. Offsets are in bytes from the start of the file, names are
+// offsets into the string pool. The pixels of a texture are its levels one
+// after the other down to 1x1, in the layout regenerateMipMapLevels() takes.
+typedef struct TEXPACK_HEADER {
+	u32    magic;
+	u32    version;
+	u32    numTextures;
+	u32    texturesOffset;
+	u32    stringsSize;
+	u32    stringsOffset;
+} texPackHeader_t;
+
+typedef struct TEXPACK_TEXTURE {
+	u32    name;
+	u32    format;
+	u32    width;
+	u32    height;
+	u32    dataOffset;
+	u32    dataSize;
+} texPackTexture_t;
+
+/*------------------------------------------------------------------------------
+; Scene textures decoded, scaled to power of two sizes and filtered down into
+; their mip maps ahead of time, stored uncompressed as A8R8G8B8. upload()
+; hands the levels straight to the driver under the name of the source image,
+; so the mesh loaders that ask for it later get the uploaded texture instead
+; of decoding the file.
+;-----------------------------------------------------------------------------*/
+class mdcTexturePack {
+	public:
+		mdcTexturePack();
+		~mdcTexturePack();
+
+		bool                            open( const char * );
+		u32                             getTextureCount()                       const;
+		u32                             upload( video::IVideoDriver * )         const;
+
+		static bool                     write( const char *, video::IVideoDriver *, const core::array< io::path > & );
+
+	private:
+		mdcMappedFile                   file;
+		const texPackHeader_t    *      header;
+		const texPackTexture_t   *      textures;
+		const char               *      strings;
+
+		mdcTexturePack( mdcTexturePack const & ) { };
+		mdcTexturePack & operator=( mdcTexturePack const & ) { return *this; }
+
+		bool                            validate()                              const;
+};
+
+#endif // TEXTUREPACK_H
@@ -0,0 +1,145 @@
+/*------------------------------------------------------------------------------
+; File:          ThreadPool.cpp
+; Description:   Implementation of the worker thread pool class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+
+#include <iostream>
+
+#if defined( _WIN32 ) || defined( __MINGW32__ )
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "ThreadPool.hpp"
+
+using std::cerr;
+using std::endl;
+
+static int getNumCores();
+
+/*------------------------------------------------------------------------------
+; mdcThreadPool::mdcThreadPool()
+;
+; Starts the given number of threads. With zero it starts one less than the
+; number of cores, leaving one for the main thread.
+;-----------------------------------------------------------------------------*/
+mdcThreadPool::mdcThreadPool( int n ) {
+	if ( n <= 0 ) {
+		n = getNumCores() - 1;
+		if ( n < 1 ) n = 1;
+	}
+
+	quit       = false;
+	numThreads = 0;
+	threads    = new pthread_t[ n ];
+
+	pthread_mutex_init( &lock, NULL );
+	pthread_cond_init( &wake, NULL );
+
+	for ( int i = 0; i < n; i++ ) {
+		if ( pthread_create( &threads[ numThreads ], NULL, threadMain, this ) == 0 ) {
+			numThreads++;
+		} else {
+			cerr << "mdcThreadPool::mdcThreadPool() - Could not start a worker thread." << endl;
+		}
+	}
+}
+
+mdcThreadPool::~mdcThreadPool() {
+	pthread_mutex_lock( &lock );
+	quit = true;
+	pthread_cond_broadcast( &wake );
+	pthread_mutex_unlock( &lock );
+
+	for ( int i = 0; i < numThreads; i++ ) {
+		pthread_join( threads[ i ], NULL );
+	}
+
+	pthread_cond_destroy( &wake );
+	pthread_mutex_destroy( &lock );
+
+	delete[] threads;
+}
+
+/*------------------------------------------------------------------------------
+; mdcThreadPool::submit()
+;
+; Queues a job. If no worker could be started the job runs right away on the
+; calling thread.
+;-----------------------------------------------------------------------------*/
+void mdcThreadPool::submit( jobFunc_t func, void * data ) {
+	poolJob_t job;
+
+	if ( numThreads == 0 ) {
+		func( data );
+		return;
+	}
+
+	job.func = func;
+	job.data = data;
+
+	pthread_mutex_lock( &lock );
+	jobs.push_back( job );
+	pthread_cond_signal( &wake );
+	pthread_mutex_unlock( &lock );
+}
+
+int mdcThreadPool::getNumThreads() const {
+	return numThreads;
+}
+
+void * mdcThreadPool::threadMain( void * arg ) {
+	static_cast< mdcThreadPool * >( arg )->runJobs();
+	return NULL;
+}
+
+void mdcThreadPool::runJobs() {
+	poolJob_t                         job;
+	core::list< poolJob_t >::Iterator it;
+
+	for ( ;; ) {
+		pthread_mutex_lock( &lock );
+		while ( !quit && jobs.empty() ) {
+			pthread_cond_wait( &wake, &lock );
+		}
+		if ( quit ) {
+			pthread_mutex_unlock( &lock );
+			return;
+		}
+		it  = jobs.begin();
+		job = *it;
+		jobs.erase( it );
+		pthread_mutex_unlock( &lock );
+
+		job.func( job.data );
+	}
+}
+
+static int getNumCores() {
+#if defined( _WIN32 ) || defined( __MINGW32__ )
+	SYSTEM_INFO info;
+	GetSystemInfo( &info );
+	return ( int )info.dwNumberOfProcessors;
+#else
+	long n = sysconf( _SC_NPROCESSORS_ONLN );
+	return n > 0 ? ( int )n : 1;
+#endif
+}
@@ -0,0 +1,69 @@
+/*------------------------------------------------------------------------------
+; File:          ThreadPool.hpp
+; Description:   Declaration of the worker thread pool class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <pthread.h>
+#include <irrlicht.h>
+
+#include "definitions.hpp"
+
+using namespace irr;
+
+typedef void ( * jobFunc_t )( void * );
+
+typedef struct POOL_JOB {
+	jobFunc_t    func;
+	void     *   data;
+} poolJob_t;
+
+/*------------------------------------------------------------------------------
+; A fixed set of worker threads running jobs in submission order. Jobs report
+; their own completion, the pool only runs them. Jobs still queued when the
+; pool is destroyed are dropped without running.
+;-----------------------------------------------------------------------------*/
+class mdcThreadPool {
+	public:
+		mdcThreadPool( int = 0 );
+		~mdcThreadPool();
+
+		void                            submit( jobFunc_t, void * );
+		int                             getNumThreads()         const;
+
+	private:
+		pthread_t                *      threads;
+		int                             numThreads;
+
+		pthread_mutex_t                 lock;
+		pthread_cond_t                  wake;
+		core::list< poolJob_t >         jobs;
+		bool                            quit;
+
+		mdcThreadPool( mdcThreadPool const & ) { };
+		mdcThreadPool & operator=( mdcThreadPool const & ) { return *this; }
+
+		static void              *      threadMain( void * );
+		void                            runJobs();
+};
+
+#endif // THREADPOOL_H
@@ -0,0 +1,71 @@
+/*------------------------------------------------------------------------------
+; File:          Timer.cpp
+; Description:   Implementation of the high resolution timer class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#if defined( _WIN32 ) || defined( __MINGW32__ )
+#include <windows.h>
+#elif defined( __linux__ )
+#include <time.h>
+#else
+#error "Not a GNU/Linux or Windows platform."
+#endif
+
+#include "Timer.hpp"
+
+mdcTimer::mdcTimer() {
+	start();
+}
+
+void mdcTimer::start() {
+	startTime = getMicroseconds();
+}
+
+u64 mdcTimer::getElapsed() const {
+	return getMicroseconds() - startTime;
+}
+
+f32 mdcTimer::getElapsedMs() const {
+	return getElapsed() / 1000.0f;
+}
+
+u64 mdcTimer::getMicroseconds() {
+#if defined( _WIN32 ) || defined( __MINGW32__ )
+	static LARGE_INTEGER frequency = { { 0, 0 } };
+	LARGE_INTEGER        counter;
+
+	if ( frequency.QuadPart == 0 ) {
+		QueryPerformanceFrequency( &frequency );
+	}
+
+	QueryPerformanceCounter( &counter );
+
+	// Split the division so the multiplication does not overflow.
+	return ( counter.QuadPart / frequency.QuadPart ) * 1000000 +
+	       ( counter.QuadPart % frequency.QuadPart ) * 1000000 / frequency.QuadPart;
+#elif defined( __linux__ )
+	struct timespec ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+
+	return ( u64 )ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#else
+#error "Not a GNU/Linux or Windows platform."
+#endif
+}
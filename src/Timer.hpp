@@ -0,0 +1,49 @@
+/*------------------------------------------------------------------------------
+; File:          Timer.hpp
+; Description:   Declaration of the high resolution timer class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <irrlicht.h>
+
+#include "definitions.hpp"
+
+using namespace irr;
+
+/*------------------------------------------------------------------------------
+; A monotonic microsecond clock for measuring frame and query times, which the
+; millisecond Irrlicht timer is too coarse for. Construction starts it.
+;-----------------------------------------------------------------------------*/
+class mdcTimer {
+	public:
+		mdcTimer();
+
+		void                      start();
+		u64                       getElapsed()            const;
+		f32                       getElapsedMs()          const;
+
+		static u64                getMicroseconds();
+
+	private:
+		u64                       startTime;
+};
+
+#endif // TIMER_H
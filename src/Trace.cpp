@@ -0,0 +1,175 @@
+/*------------------------------------------------------------------------------
+; File:          Trace.cpp
+; Description:   Implementation of the event trace class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#if defined( _WIN32 ) || defined( __MINGW32__ )
+#include <windows.h>
+#elif defined( __linux__ )
+#include <unistd.h>
+#include <sys/syscall.h>
+#else
+#error "Not a GNU/Linux or Windows platform."
+#endif
+
+#include <cstdio>
+#include <iostream>
+
+#include "Trace.hpp"
+
+using std::cerr;
+using std::endl;
+
+bool                         mdcTrace::enabled = false;
+core::stringc                mdcTrace::file;
+u64                          mdcTrace::origin  = 0;
+bool                         mdcTrace::full    = false;
+pthread_mutex_t              mdcTrace::lock    = PTHREAD_MUTEX_INITIALIZER;
+core::array< traceEvent_t >  mdcTrace::events;
+
+/*------------------------------------------------------------------------------
+; mdcTrace::start()
+;
+; Starts recording events, they will be written to the given file by
+; finish(). Must be called before any other thread is started.
+;-----------------------------------------------------------------------------*/
+bool mdcTrace::start( const char * path ) {
+	if ( path == NULL || path[ 0 ] == '\0' ) {
+		cerr << "mdcTrace::start() - No trace file given." << endl;
+		return false;
+	}
+
+	file    = path;
+	origin  = mdcTimer::getMicroseconds();
+	full    = false;
+	enabled = true;
+
+	events.clear();
+	events.reallocate( 4096 );
+
+	return true;
+}
+
+bool mdcTrace::isEnabled() {
+	return enabled;
+}
+
+u64 mdcTrace::getTime() {
+	return mdcTimer::getMicroseconds() - origin;
+}
+
+void mdcTrace::addEvent( const char * name, const char * detail, u64 start, u64 duration ) {
+	traceEvent_t event;
+
+	event.name     = name;
+	event.detail   = detail != NULL ? detail : "";
+	event.start    = start;
+	event.duration = duration;
+	event.thread   = getThreadId();
+
+	pthread_mutex_lock( &lock );
+	if ( events.size() < TRACE_MAX_EVENTS ) {
+		events.push_back( event );
+	} else {
+		full = true;
+	}
+	pthread_mutex_unlock( &lock );
+}
+
+/*------------------------------------------------------------------------------
+; mdcTrace::finish()
+;
+; Stops recording and writes every event as a complete ("X") event of the
+; Chrome trace format. Must be called after the other threads are gone.
+;-----------------------------------------------------------------------------*/
+void mdcTrace::finish() {
+	FILE * out;
+
+	if ( !enabled ) {
+		return;
+	}
+
+	pthread_mutex_lock( &lock );
+	enabled = false;
+	pthread_mutex_unlock( &lock );
+
+	if ( full ) {
+		cerr << "mdcTrace::finish() - The trace is full, only the first " << TRACE_MAX_EVENTS << " events were kept." << endl;
+	}
+
+	out = fopen( file.c_str(), "w" );
+	if ( out == NULL ) {
+		cerr << "mdcTrace::finish() - Could not open " << file.c_str() << " for writing." << endl;
+		events.clear();
+		return;
+	}
+
+	fprintf( out, "{\"traceEvents\":[\n" );
+
+	for ( u32 i = 0; i < events.size(); i++ ) {
+		fprintf( out, "{\"name\":" );
+		writeString( out, events[ i ].name );
+		fprintf( out, ",\"cat\":\"mdcvis\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%llu,\"pid\":1,\"tid\":%u",
+		         ( unsigned long long )events[ i ].start, ( unsigned long long )events[ i ].duration,
+		         events[ i ].thread );
+
+		if ( events[ i ].detail.size() > 0 ) {
+			fprintf( out, ",\"args\":{\"detail\":" );
+			writeString( out, events[ i ].detail );
+			fprintf( out, "}" );
+		}
+
+		fprintf( out, i + 1 < events.size() ? "},\n" : "}\n" );
+	}
+
+	fprintf( out, "],\"displayTimeUnit\":\"ms\"}\n" );
+	fclose( out );
+
+	events.clear();
+}
+
+u32 mdcTrace::getThreadId() {
+#if defined( _WIN32 ) || defined( __MINGW32__ )
+	return ( u32 )GetCurrentThreadId();
+#elif defined( __linux__ )
+	return ( u32 )syscall( SYS_gettid );
+#else
+#error "Not a GNU/Linux or Windows platform."
+#endif
+}
+
+// Writes a JSON string literal.
+void mdcTrace::writeString( FILE * out, const core::stringc & str ) {
+	fputc( '"', out );
+
+	for ( u32 i = 0; i < str.size(); i++ ) {
+		unsigned char c = ( unsigned char )str[ i ];
+
+		if ( c == '"' || c == '\\' ) {
+			fputc( '\\', out );
+			fputc( c, out );
+		} else if ( c < 0x20 ) {
+			fprintf( out, "\\u%04x", c );
+		} else {
+			fputc( c, out );
+		}
+	}
+
+	fputc( '"', out );
+}
@@ -0,0 +1,111 @@
+/*------------------------------------------------------------------------------
+; File:          Trace.hpp
+; Description:   Declaration of the event trace class.
+; Author:        Miguel Angel Astor, sonofgrendel@gmail.com
+; Date created:  10/17/2026
+;
+; Copyright (C) 2026 Museo de Ciencias de Caracas
+;
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+; (at your option) any later version.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+;
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <http://www.gnu.org/licenses/>.
+;-----------------------------------------------------------------------------*/
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstdio>
+#include <pthread.h>
+#include <irrlicht.h>
+
+#include "definitions.hpp"
+#include "Timer.hpp"
+
+using namespace irr;
+
+// Environment variable that enables tracing, holds the output file.
+#define TRACE_ENV_VAR     "MDCVIS_TRACE"
+
+// Events past this are dropped so a long session can not exhaust memory.
+#define TRACE_MAX_EVENTS  ( 1 << 20 )
+
+// A finished event, times are in microseconds since the trace started.
+typedef struct TRACE_EVENT {
+	core::stringc               name;
+	core::stringc               detail;
+	u64                         start;
+	u64                         duration;
+	u32                         thread;
+} traceEvent_t;
+
+/*------------------------------------------------------------------------------
+; Records named begin/end events from any thread and writes them on finish()
+; as a Chrome trace JSON file, which chrome://tracing and Perfetto can open.
+; Nothing is recorded until start() is called, so a disabled trace costs a
+; flag check per scope.
+;-----------------------------------------------------------------------------*/
+class mdcTrace {
+	public:
+		static bool                     start( const char * );
+		static void                     finish();
+		static bool                     isEnabled();
+
+		static u64                      getTime();
+		static void                     addEvent( const char *, const char *, u64, u64 );
+
+	private:
+		static bool                     enabled;
+		static core::stringc            file;
+		static u64                      origin;
+		static bool                     full;
+		static pthread_mutex_t          lock;
+		static core::array< traceEvent_t > events;
+
+		mdcTrace() { };
+		mdcTrace( mdcTrace const & ) { };
+		mdcTrace & operator=( mdcTrace const & ) { return *this; }
+
+		static u32                      getThreadId();
+		static void                     writeString( FILE *, const core::stringc & );
+};
+
+/*------------------------------------------------------------------------------
+; Records one event from its construction to its destruction. The strings
+; must outlive the scope.
+;-----------------------------------------------------------------------------*/
+class mdcTraceScope {
+	public:
+		mdcTraceScope( const char * n, const char * d = NULL ) : name( n ), detail( d ) {
+			start = mdcTrace::isEnabled() ? mdcTrace::getTime() : 0;
+		}
+		~mdcTraceScope() {
+			if ( mdcTrace::isEnabled() ) {
+				mdcTrace::addEvent( name, detail, start, mdcTrace::getTime() - start );
+			}
+		}
+
+	private:
+		const char               *      name;
+		const char               *      detail;
+		u64                             start;
+
+		mdcTraceScope( mdcTraceScope const & ) { };
+		mdcTraceScope & operator=( mdcTraceScope const & ) { return *this; }
+};
+
+#define TRACE_CONCAT_( a, b )           a##b
+#define TRACE_CONCAT( a, b )            TRACE_CONCAT_( a, b )
+
+// Traces the rest of the enclosing block.
+#define TRACE_SCOPE( name )             mdcTraceScope TRACE_CONCAT( traceScope, __LINE__ )( name )
+#define TRACE_SCOPE_ARG( name, detail ) mdcTraceScope TRACE_CONCAT( traceScope, __LINE__ )( name, detail )
+
+#endif // TRACE_H
@@ -36,10 +36,34 @@ class mdcSettingsMdl;
 class mdcSettingsDlg;
 class mdcSettingsCtrl;
 class mdcScene;
+class mdcSceneLoader;
+class mdcSceneBake;
+class mdcMappedFile;
+class mdcOctreeSelector;
+class mdcCollisionBvh;
+class mdcExhibitPicker;
+class mdcRayKernels;
+class mdcRenderStats;
+class mdcTimer;
+class mdcTrace;
+class mdcCameraRecorder;
+class mdcProfiler;
+class mdcProfiledAnimator;
+class mdcThreadPool;
+class mdcMeshDecoder;
+class mdcMeshBatcher;
+class mdcMeshSimplifier;
+class mdcInstanceShader;
+class mdcInstancedMeshNode;
+class mdcPvs;
+class mdcPortalCuller;
+class mdcTexturePack;
 class mdcExhibitMdl;
+class mdcExhibitCatalog;
 class mdcExhibitDlg;
 
 typedef struct sqlite3 sqlite3;
+typedef struct sqlite3_stmt sqlite3_stmt;
 typedef struct VEC_3 vec3_t;
 
 #endif // DEFINITIONS_H
@@ -21,11 +21,61 @@
 ;-----------------------------------------------------------------------------*/
 
 #include <cstdlib>
+#include <cstring>
 
 #include "Application.hpp"
+#include "RayKernels.hpp"
+#include "Trace.hpp"
 
 int main( int argc, char** argv ) {
+	const char * traceFile = getenv( TRACE_ENV_VAR );
+
+	// Before any thread pool starts, the kernels only read the choice.
+	mdcRayKernels::setPath( mdcRayKernels::getBestPath() );
+
+	// --trace <file> may come before any other option.
+	if ( argc > 2 && strcmp( argv[ 1 ], "--trace" ) == 0 ) {
+		traceFile = argv[ 2 ];
+		argv[ 2 ] = argv[ 0 ];
+		argv     += 2;
+		argc     -= 2;
+	}
+
+	if ( traceFile != NULL && mdcTrace::start( traceFile ) ) {
+		atexit( mdcTrace::finish );
+	}
+
+	if ( argc > 1 && strcmp( argv[ 1 ], "--bake" ) == 0 ) {
+		return mdcScene::bake() ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if ( argc > 1 && strcmp( argv[ 1 ], "--bench-kernels" ) == 0 ) {
+		return mdcScene::benchmarkKernels() ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	// --benchmark <camera path> <output CSV> [null|burnings]
+	if ( argc > 3 && strcmp( argv[ 1 ], "--benchmark" ) == 0 ) {
+		video::E_DRIVER_TYPE driverType = video::EDT_NULL;
+		bool                 ok;
+
+		if ( argc > 4 && strcmp( argv[ 4 ], "burnings" ) == 0 ) {
+			driverType = video::EDT_BURNINGSVIDEO;
+		}
+
+		mdcApplication *app = new mdcApplication( driverType );
+		ok = app->runBenchmark( argv[ 2 ], argv[ 3 ] );
+		delete app;
+
+		return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
 	mdcApplication *app = new mdcApplication();
+
+	// --record <camera path>
+	if ( argc > 2 && strcmp( argv[ 1 ], "--record" ) == 0 ) {
+		app->startRecording( argv[ 2 ] );
+	}
+
 	app->run();
 	delete app;
 